@@ -0,0 +1,19 @@
+#ifndef __ALLOC_COUNT_H__
+#define __ALLOC_COUNT_H__
+
+/*
+ * Force-included into the library when it is built for the benchmarks
+ * (see BENCH_ALLOC in the Makefile), so that every heap allocation the
+ * engine makes goes through bench_util.c and can be counted.
+ */
+#include <stdlib.h>
+
+void *bench_malloc(size_t size);
+void *bench_calloc(size_t count, size_t size);
+void *bench_realloc(void *pointer, size_t size);
+
+#define malloc(size) bench_malloc(size)
+#define calloc(count, size) bench_calloc(count, size)
+#define realloc(pointer, size) bench_realloc(pointer, size)
+
+#endif // #ifndef __ALLOC_COUNT_H__
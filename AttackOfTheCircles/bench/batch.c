@@ -0,0 +1,99 @@
+/*
+ * Measures how many game levels per second a SceneBatch steps headlessly,
+ * e.g. for bots or training, as the number of threads grows, and checks
+ * that every thread count leaves the scenes exactly where one thread does.
+ * Each scene is a game level with its own seed and keys that change every
+ * step, like a player's.
+ * Build and run with "make bench".
+ */
+#include "bench_util.h"
+#include "batch.h"
+#include "gen_forces.h"
+#include "gen_levels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const double BATCH_BENCH_DT = 1.0 / 120;
+const double BATCH_BENCH_PLAYER_SIZE = 100;
+const size_t BATCH_THREAD_COUNTS[] = {1, 2, 4, 8, 16};
+// Each step holds the keys for this many ticks, like a bot deciding 15 times a second
+const size_t TICKS_PER_STEP = 8;
+const size_t BATCH_STEPS = 60;
+
+Scene *build_batch_level(size_t index){
+    Scene *scene = scene_init();
+    scene_seed(scene, index);
+    Body *player = gen_player_sq(BATCH_BENCH_PLAYER_SIZE, scene);
+    switch(index % 5){
+        case 0: gen_tutorial_level(BATCH_BENCH_PLAYER_SIZE, scene, player); break;
+        case 1: gen_first_level(BATCH_BENCH_PLAYER_SIZE, scene, player); break;
+        case 2: gen_second_level(BATCH_BENCH_PLAYER_SIZE, scene, player); break;
+        case 3: gen_third_level(BATCH_BENCH_PLAYER_SIZE, scene, player); break;
+        default: gen_boss_level(BATCH_BENCH_PLAYER_SIZE, scene, player); break;
+    }
+    gen_forces(scene);
+    return scene;
+}
+
+// Mostly runs right, sometimes left, and jumps now and then
+SceneInput batch_input(size_t scene, size_t step){
+    SceneInput input;
+    for(int key = 0; key < SCENE_KEYS; key++){
+        input.keys[key] = KEY_RELEASED;
+    }
+    input.keys[(scene + step) % 4 == 0 ? LEFT_ARROW : RIGHT_ARROW] = KEY_PRESSED;
+    if((scene + step) % 5 == 0){
+        input.keys[UP_ARROW] = KEY_PRESSED;
+    }
+    return input;
+}
+
+// Steps a batch of scenes and returns the scene ticks per second. Fills
+// state with the players' centroids at the end, one for each scene.
+double run_batch(size_t scenes, size_t threads, Vector *state){
+    SceneBatch *batch = scene_batch_init(threads);
+    for(size_t i = 0; i < scenes; i++){
+        scene_batch_add(batch, build_batch_level(i));
+    }
+    SceneInput *inputs = malloc(sizeof(SceneInput) * scenes);
+    double start = now_ns();
+    for(size_t step = 0; step < BATCH_STEPS; step++){
+        for(size_t i = 0; i < scenes; i++){
+            inputs[i] = batch_input(i, step);
+        }
+        scene_batch_tick(batch, inputs, BATCH_BENCH_DT, TICKS_PER_STEP);
+    }
+    double seconds = (now_ns() - start) / 1e9;
+    for(size_t i = 0; i < scenes; i++){
+        // The player is the first body of each level
+        state[i] = body_get_centroid(scene_get_body(scene_batch_get(batch, i), 0));
+    }
+    free(inputs);
+    scene_batch_free(batch);
+    return scenes * BATCH_STEPS * TICKS_PER_STEP / seconds;
+}
+
+int main(int argc, char *argv[]){
+    size_t scene_counts[] = {16, 64};
+    printf("%8s %8s %14s %8s %6s\n", "scenes", "threads", "ticks/s", "speedup", "exact");
+    for(size_t i = 0; i < sizeof(scene_counts) / sizeof(*scene_counts); i++){
+        size_t scenes = scene_counts[i];
+        Vector *serial = malloc(sizeof(Vector) * scenes);
+        Vector *state = malloc(sizeof(Vector) * scenes);
+        double serial_rate = 0;
+        for(size_t j = 0; j < sizeof(BATCH_THREAD_COUNTS) / sizeof(*BATCH_THREAD_COUNTS); j++){
+            size_t threads = BATCH_THREAD_COUNTS[j];
+            double rate = run_batch(scenes, threads, threads == 1 ? serial : state);
+            if(threads == 1){
+                serial_rate = rate;
+            }
+            bool exact = threads == 1 || memcmp(state, serial, sizeof(Vector) * scenes) == 0;
+            printf("%8zu %8zu %14.0f %8.2f %6s\n", scenes, threads, rate, rate / serial_rate,
+              exact ? "yes" : "no");
+        }
+        free(serial);
+        free(state);
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include "bench_util.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Atomic, since scenes with several threads allocate from them too
+atomic_size_t allocations = 0;
+
+void *bench_malloc(size_t size){
+    allocations++;
+    return malloc(size);
+}
+
+void *bench_calloc(size_t count, size_t size){
+    allocations++;
+    return calloc(count, size);
+}
+
+void *bench_realloc(void *pointer, size_t size){
+    allocations++;
+    return realloc(pointer, size);
+}
+
+size_t bench_allocations(void){
+    return allocations;
+}
+
+double now_ns(void){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1e9 + time.tv_nsec;
+}
@@ -0,0 +1,21 @@
+#ifndef __BENCH_UTIL_H__
+#define __BENCH_UTIL_H__
+
+#include <stddef.h>
+
+/**
+ * Reads a monotonic clock.
+ *
+ * @return the current time in nanoseconds, from an arbitrary starting point
+ */
+double now_ns(void);
+
+/**
+ * Gets the number of malloc(), calloc() and realloc() calls the library has
+ * made so far. Only counts calls from library code built with BENCH_ALLOC.
+ *
+ * @return the number of allocations since the program started
+ */
+size_t bench_allocations(void);
+
+#endif // #ifndef __BENCH_UTIL_H__
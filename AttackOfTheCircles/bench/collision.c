@@ -0,0 +1,158 @@
+/*
+ * Times find_collision() against the previous implementation, which built
+ * heap-allocated edge lists and recomputed both centroids for every edge.
+ * The SAT column times find_collision() on the same shapes without their
+ * ShapeKind, so circles and boxes go through the general polygon path.
+ * Run with "make bench".
+ */
+#include "bench_util.h"
+#include "collision.h"
+#include "polygon.h"
+#include "shape.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const int BENCH_ITERATIONS = 200000;
+
+typedef struct reference_projection{
+    bool intersected;
+    double intersection;
+    Vector axis;
+} ReferenceProjection;
+
+ReferenceProjection reference_intersection(const VectorList *shape1,
+  const VectorList *shape2, Vector axis){
+    double min1 = INFINITY, max1 = -INFINITY, min2 = INFINITY, max2 = -INFINITY;
+    for(size_t i = 0; i < shape1->size; i++){
+        double project = vec_dot(shape1->data[i], axis);
+        min1 = fmin(min1, project);
+        max1 = fmax(max1, project);
+    }
+    for(size_t i = 0; i < shape2->size; i++){
+        double project = vec_dot(shape2->data[i], axis);
+        min2 = fmin(min2, project);
+        max2 = fmax(max2, project);
+    }
+    ReferenceProjection projection = {false, 0, axis};
+    if(max2 > max1){
+        projection.intersected = min2 < max1;
+        projection.intersection = fabs(min2 - max1);
+    }
+    else{
+        projection.intersected = min1 < max2;
+        projection.intersection = fabs(min1 - max2);
+    }
+    return projection;
+}
+
+Vector reference_edge_axis(Vector edge, const VectorList *shape1, const VectorList *shape2){
+    Vector axis = {-edge.y, edge.x};
+    Vector one_to_two = vec_subtract(polygon_centroid(shape2), polygon_centroid(shape1));
+    if(vec_dot(one_to_two, axis) / (vec_magnitude(one_to_two) * vec_magnitude(axis)) < 0){
+        return vec_negate(axis);
+    }
+    return axis;
+}
+
+ReferenceProjection reference_smallest_axis(const VectorList *shape1,
+  const VectorList *shape2, VectorList *edges){
+    bool separating_axis = false;
+    double smallest = INFINITY;
+    Vector smallest_axis = VEC_ZERO;
+    for(size_t i = 0; !separating_axis && i < edges->size; i++){
+        Vector axis = reference_edge_axis(edges->data[i], shape1, shape2);
+        ReferenceProjection projection = reference_intersection(shape1, shape2, axis);
+        separating_axis = !projection.intersected;
+        if(smallest > projection.intersection){
+            smallest = projection.intersection;
+            smallest_axis = axis;
+        }
+    }
+    smallest_axis = vec_multiply(1 / vec_magnitude(smallest_axis), smallest_axis);
+    return (ReferenceProjection){separating_axis, smallest, smallest_axis};
+}
+
+VectorList *reference_edges(const VectorList *shape){
+    VectorList *edges = vec_list_init(shape->size);
+    for(size_t i = 0; i < shape->size; i++){
+        vec_list_add(edges,
+          vec_subtract(shape->data[(i + 1) % shape->size], shape->data[i]));
+    }
+    return edges;
+}
+
+// find_collision() before the allocation-free rewrite
+CollisionInfo reference_find_collision(const VectorList *shape1, const VectorList *shape2){
+    VectorList *edges1 = reference_edges(shape1);
+    VectorList *edges2 = reference_edges(shape2);
+    ReferenceProjection projection1 = reference_smallest_axis(shape1, shape2, edges1);
+    ReferenceProjection projection2 = reference_smallest_axis(shape1, shape2, edges2);
+    CollisionInfo info;
+    info.collided = !projection1.intersected && !projection2.intersected;
+    if(projection1.intersection < projection2.intersection){
+        info.axis = projection1.axis;
+        info.depth = projection1.intersection;
+    }
+    else{
+        info.axis = projection2.axis;
+        info.depth = projection2.intersection;
+    }
+    vec_list_free(edges1);
+    vec_list_free(edges2);
+    return info;
+}
+
+typedef CollisionInfo (*CollisionFinder)(const VectorList *, const VectorList *);
+
+// Returns the average time of one call, and counts the collisions so the calls are not optimized out
+double time_finder(CollisionFinder finder, const VectorList *shape1,
+  const VectorList *shape2, int *collisions){
+    *collisions = 0;
+    double start = now_ns();
+    for(int i = 0; i < BENCH_ITERATIONS; i++){
+        *collisions += finder(shape1, shape2).collided;
+    }
+    return (now_ns() - start) / BENCH_ITERATIONS;
+}
+
+void bench_pair(const char *name, VectorList *shape1, VectorList *shape2, Vector offset){
+    polygon_translate(shape2, offset);
+    // Copies without the shape kinds, to time the general SAT path
+    VectorList *polygon1 = vec_list_copy(shape1);
+    VectorList *polygon2 = vec_list_copy(shape2);
+    polygon1->kind = SHAPE_POLYGON;
+    polygon2->kind = SHAPE_POLYGON;
+    int reference_collisions, sat_collisions, collisions;
+    double reference_ns = time_finder(reference_find_collision, shape1, shape2,
+      &reference_collisions);
+    double sat_ns = time_finder(find_collision, polygon1, polygon2, &sat_collisions);
+    double ns = time_finder(find_collision, shape1, shape2, &collisions);
+    printf("%-34s %10.1f %10.1f %10.1f %8.2fx%s\n", name, reference_ns, sat_ns, ns,
+      reference_ns / ns,
+      reference_collisions == collisions && sat_collisions == collisions ? "" : "  (results differ)");
+    vec_list_free(polygon1);
+    vec_list_free(polygon2);
+    polygon_translate(shape2, vec_negate(offset));
+}
+
+int main(int argc, char *argv[]){
+    VectorList *rectangle = shape_rectangle(100, 40);
+    VectorList *circle = shape_circle(15, 40);
+    VectorList *triangle = vec_list_init(3);
+    vec_list_add(triangle, (Vector){0, 20});
+    vec_list_add(triangle, (Vector){-17, -10});
+    vec_list_add(triangle, (Vector){17, -10});
+
+    printf("%-34s %10s %10s %10s %9s\n", "case", "old ns", "SAT ns", "new ns", "speedup");
+    bench_pair("circle vs rectangle, touching", rectangle, circle, (Vector){30, 30});
+    bench_pair("circle vs rectangle, separate", rectangle, circle, (Vector){30, 60});
+    bench_pair("circle vs rectangle, corner gap", rectangle, circle, (Vector){62, 32});
+    bench_pair("triangle vs rectangle, touching", rectangle, triangle, (Vector){-40, 25});
+    bench_pair("triangle vs rectangle, separate", rectangle, triangle, (Vector){-40, 60});
+
+    vec_list_free(rectangle);
+    vec_list_free(circle);
+    vec_list_free(triangle);
+    return 0;
+}
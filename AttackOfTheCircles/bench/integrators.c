@@ -0,0 +1,184 @@
+/*
+ * Measures how far each integrator lets a scene's energy drift from its
+ * starting value, at several tick lengths, and how long a tick takes.
+ * The scenarios are a spring platform like add_moving_platform()'s,
+ * an eccentric two-body orbit, and planets orbiting a sun with scene gravity.
+ * Build and run with "make bench".
+ */
+#include "bench_util.h"
+#include "forces.h"
+#include "shape.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const RGBColor INTEGRATOR_BENCH_COLOR = {0.5, 0.5, 0.5};
+
+// The mass-to-stiffness ratio and amplitude of the game's moving platforms
+const double PLATFORM_MASS = 60;
+const double PLATFORM_K = 300;
+const double PLATFORM_AMPLITUDE = 150;
+const double PLATFORM_SECONDS = 60;
+
+const double ORBIT_G = 1000;
+const double ORBIT_MASS1 = 50;
+const double ORBIT_MASS2 = 1;
+const double ORBIT_PERIAPSIS = 100;
+const double ORBIT_ECCENTRICITY = 0.5;
+const double ORBIT_SECONDS = 300;
+
+const double PLANETS_G = 1000;
+const double PLANETS_SUN_MASS = 1000;
+const double PLANETS_MASS = 0.01;
+const int PLANETS = 16;
+const double PLANETS_INNER_RADIUS = 200;
+const double PLANETS_SPACING = 40;
+const double PLANETS_SECONDS = 300;
+
+typedef struct integrator_case{
+    const char *name;
+    Integrator integrator;
+} IntegratorCase;
+
+const IntegratorCase INTEGRATOR_CASES[] = {
+    {"midpoint", INTEGRATOR_MIDPOINT},
+    {"euler", INTEGRATOR_SEMI_IMPLICIT_EULER},
+    {"verlet", INTEGRATOR_VELOCITY_VERLET},
+    {"multistep", INTEGRATOR_MULTISTEP}
+};
+const double TICK_LENGTHS[] = {1.0 / 30, 1.0 / 60, 1.0 / 120, 1.0 / 240};
+
+typedef struct drift_scenario{
+    const char *name;
+    Scene *(*build)(void);
+    // The scene's total energy, kinetic plus potential
+    double (*energy)(Scene *scene);
+    double seconds;
+} DriftScenario;
+
+Body *add_point_mass(Scene *scene, double mass, Vector centroid, Vector velocity){
+    Body *body = body_init(shape_circle(0.5, 8), mass, INTEGRATOR_BENCH_COLOR);
+    body_set_centroid(body, centroid);
+    body_set_velocity(body, velocity);
+    scene_add_body(scene, body);
+    return body;
+}
+
+double scene_kinetic_energy(Scene *scene){
+    double energy = 0;
+    for(size_t i = 0; i < scene_bodies(scene); i++){
+        Body *body = scene_get_body(scene, i);
+        Vector v = body_get_velocity(body);
+        energy += body_get_mass(body) * vec_dot(v, v) / 2;
+    }
+    return energy;
+}
+
+double scene_gravity_energy(Scene *scene, double G){
+    double energy = scene_kinetic_energy(scene);
+    for(size_t i = 0; i < scene_bodies(scene); i++){
+        Body *body1 = scene_get_body(scene, i);
+        for(size_t j = i + 1; j < scene_bodies(scene); j++){
+            Body *body2 = scene_get_body(scene, j);
+            double distance = sqrt(vec_distance_squared(
+              body_get_centroid(body1), body_get_centroid(body2)));
+            energy -= G * body_get_mass(body1) * body_get_mass(body2) / distance;
+        }
+    }
+    return energy;
+}
+
+// The anchor isn't in the scene, like the game's platforms,
+// so it stays at the origin
+Scene *build_platform(void){
+    Scene *scene = scene_init();
+    add_point_mass(scene, PLATFORM_MASS, (Vector){PLATFORM_AMPLITUDE, 0}, VEC_ZERO);
+    Body *anchor = body_init(shape_rectangle(0.5, 0.5), PLATFORM_MASS, INTEGRATOR_BENCH_COLOR);
+    create_spring(scene, PLATFORM_K, scene_get_body(scene, 0), anchor);
+    return scene;
+}
+
+double platform_energy(Scene *scene){
+    Vector x = body_get_centroid(scene_get_body(scene, 0));
+    return scene_kinetic_energy(scene) + PLATFORM_K * vec_dot(x, x) / 2;
+}
+
+// Starts both bodies at periapsis, with zero total momentum
+Scene *build_orbit(void){
+    Scene *scene = scene_init();
+    double total_mass = ORBIT_MASS1 + ORBIT_MASS2;
+    double speed = sqrt(ORBIT_G * total_mass * (1 + ORBIT_ECCENTRICITY) / ORBIT_PERIAPSIS);
+    Body *body1 = add_point_mass(scene, ORBIT_MASS1,
+      (Vector){-ORBIT_PERIAPSIS * ORBIT_MASS2 / total_mass, 0},
+      (Vector){0, -speed * ORBIT_MASS2 / total_mass});
+    Body *body2 = add_point_mass(scene, ORBIT_MASS2,
+      (Vector){ORBIT_PERIAPSIS * ORBIT_MASS1 / total_mass, 0},
+      (Vector){0, speed * ORBIT_MASS1 / total_mass});
+    create_newtonian_gravity(scene, ORBIT_G, body1, body2);
+    return scene;
+}
+
+double orbit_energy(Scene *scene){
+    return scene_gravity_energy(scene, ORBIT_G);
+}
+
+// Planets on circular orbits around a sun, spread around it
+Scene *build_planets(void){
+    Scene *scene = scene_init();
+    add_point_mass(scene, PLANETS_SUN_MASS, VEC_ZERO, VEC_ZERO);
+    for(int i = 0; i < PLANETS; i++){
+        double radius = PLANETS_INNER_RADIUS + i * PLANETS_SPACING;
+        double speed = sqrt(PLANETS_G * PLANETS_SUN_MASS / radius);
+        double angle = i * 2.4;
+        add_point_mass(scene, PLANETS_MASS,
+          (Vector){radius * cos(angle), radius * sin(angle)},
+          (Vector){-speed * sin(angle), speed * cos(angle)});
+    }
+    create_scene_gravity(scene, PLANETS_G, 0);
+    return scene;
+}
+
+double planets_energy(Scene *scene){
+    return scene_gravity_energy(scene, PLANETS_G);
+}
+
+void run_drift(DriftScenario *scenario){
+    for(size_t i = 0; i < sizeof(INTEGRATOR_CASES) / sizeof(*INTEGRATOR_CASES); i++){
+        for(size_t j = 0; j < sizeof(TICK_LENGTHS) / sizeof(*TICK_LENGTHS); j++){
+            double dt = TICK_LENGTHS[j];
+            Scene *scene = scenario->build();
+            scene_set_integrator(scene, INTEGRATOR_CASES[i].integrator);
+            double initial_energy = scenario->energy(scene);
+            double max_drift = 0;
+            double total_ns = 0;
+            int ticks = (int) round(scenario->seconds / dt);
+            for(int tick = 0; tick < ticks; tick++){
+                double start = now_ns();
+                scene_tick(scene, dt);
+                total_ns += now_ns() - start;
+                double drift = fabs(scenario->energy(scene) / initial_energy - 1);
+                if(drift > max_drift){
+                    max_drift = drift;
+                }
+            }
+            double final_drift = scenario->energy(scene) / initial_energy - 1;
+            printf("%-10s %-10s %6.0f %14.3e %14.3e %10.0f\n", scenario->name,
+              INTEGRATOR_CASES[i].name, 1 / dt, max_drift, final_drift, total_ns / ticks);
+            scene_free(scene);
+        }
+    }
+}
+
+int main(int argc, char *argv[]){
+    DriftScenario scenarios[] = {
+        {"platform", build_platform, platform_energy, PLATFORM_SECONDS},
+        {"orbit", build_orbit, orbit_energy, ORBIT_SECONDS},
+        {"planets", build_planets, planets_energy, PLANETS_SECONDS}
+    };
+    printf("%-10s %-10s %6s %14s %14s %10s\n",
+      "scenario", "integrator", "hz", "max drift", "final drift", "ns/tick");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(*scenarios); i++){
+        run_drift(&scenarios[i]);
+    }
+    return 0;
+}
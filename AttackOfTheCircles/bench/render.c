@@ -0,0 +1,114 @@
+/*
+ * Measures how long sdl_render_scene() takes to draw each game level into an
+ * offscreen image, with each way of filling polygons and with and without
+ * the static layer, so rendering can be timed on machines without a display.
+ * The camera scrolls right through each level, like a player running.
+ * Prints a digest of each level's last frame, which only changes if what is
+ * drawn changes; given a folder, e.g. "bin/bench_render frames", it also
+ * writes the last frames there as PPM images to compare with saved ones.
+ * Build and run with "make bench-render".
+ */
+#include "bench_util.h"
+#include "gen_forces.h"
+#include "gen_levels.h"
+#include "sdl_wrapper.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const double RENDER_BENCH_DT = 1.0 / 60;
+const double RENDER_BENCH_PLAYER_SIZE = 100;
+const int RENDER_WIDTH = 1500;
+const int RENDER_HEIGHT = 500;
+const Vector RENDER_SCENE_MAX = {3000, 1000};
+const Vector RENDER_CAMERA_VELOCITY = {600, 0};
+const size_t RENDER_FRAMES = 120;
+const size_t RENDER_LEVELS = 5;
+
+typedef struct render_config{
+    const char *name;
+    RenderBackend backend;
+    bool static_layer;
+} RenderConfig;
+
+const RenderConfig RENDER_CONFIGS[] = {
+    {"gfx", RENDER_GFX, false},
+    {"geometry", RENDER_GEOMETRY, false},
+    {"tiles", RENDER_GEOMETRY, true},
+};
+
+Scene *build_render_level(size_t index){
+    Scene *scene = scene_init();
+    scene_seed(scene, index);
+    Body *player = gen_player_sq(RENDER_BENCH_PLAYER_SIZE, scene);
+    switch(index){
+        case 0: gen_tutorial_level(RENDER_BENCH_PLAYER_SIZE, scene, player); break;
+        case 1: gen_first_level(RENDER_BENCH_PLAYER_SIZE, scene, player); break;
+        case 2: gen_second_level(RENDER_BENCH_PLAYER_SIZE, scene, player); break;
+        case 3: gen_third_level(RENDER_BENCH_PLAYER_SIZE, scene, player); break;
+        default: gen_boss_level(RENDER_BENCH_PLAYER_SIZE, scene, player); break;
+    }
+    gen_forces(scene);
+    scene_set_camera_velocity(scene, RENDER_CAMERA_VELOCITY);
+    return scene;
+}
+
+// A 64-bit FNV-1a hash of a frame's pixels
+uint64_t frame_digest(const uint8_t *pixels, size_t length){
+    uint64_t hash = 0xCBF29CE484222325;
+    for(size_t i = 0; i < length; i++){
+        hash = (hash ^ pixels[i]) * 0x100000001B3;
+    }
+    return hash;
+}
+
+// Draws a level's frames with a config and returns the mean nanoseconds per
+// frame. Only the drawing is timed, not stepping the scene between frames.
+// Fills stats with the last frame's counts and pixels with its image.
+double run_render(size_t level, RenderConfig config, RenderStats *stats, uint8_t *pixels){
+    sdl_set_render_backend(config.backend);
+    sdl_set_static_layer(config.static_layer);
+    Scene *scene = build_render_level(level);
+    double total = 0;
+    for(size_t frame = 0; frame < RENDER_FRAMES; frame++){
+        scene_tick(scene, RENDER_BENCH_DT);
+        double start = now_ns();
+        sdl_render_scene(scene);
+        total += now_ns() - start;
+    }
+    *stats = sdl_get_render_stats();
+    sdl_read_frame(pixels);
+    scene_free(scene);
+    return total / RENDER_FRAMES;
+}
+
+int main(int argc, char *argv[]){
+    const char *frame_dir = argc > 1 ? argv[1] : NULL;
+    sdl_init_offscreen(VEC_ZERO, RENDER_SCENE_MAX, RENDER_WIDTH, RENDER_HEIGHT);
+    int width, height;
+    sdl_get_frame_size(&width, &height);
+    size_t frame_bytes = 3 * (size_t) width * height;
+    uint8_t *pixels = malloc(frame_bytes);
+    printf("%6s %9s %12s %6s %6s %7s %6s %17s\n", "level", "config", "ns/frame", "drawn",
+      "cached", "skipped", "tiles", "digest");
+    for(size_t level = 0; level < RENDER_LEVELS; level++){
+        for(size_t i = 0; i < sizeof(RENDER_CONFIGS) / sizeof(*RENDER_CONFIGS); i++){
+            RenderConfig config = RENDER_CONFIGS[i];
+            RenderStats stats;
+            double ns = run_render(level, config, &stats, pixels);
+            printf("%6zu %9s %12.0f %6zu %6zu %7zu %6zu  %016llx\n", level, config.name, ns,
+              stats.drawn, stats.cached, stats.skipped, stats.tiles_drawn,
+              (unsigned long long) frame_digest(pixels, frame_bytes));
+            if(frame_dir != NULL){
+                char path[256];
+                snprintf(path, sizeof(path), "%s/level%zu-%s.ppm", frame_dir, level, config.name);
+                if(!sdl_write_ppm(path)){
+                    fprintf(stderr, "Couldn't write %s\n", path);
+                    return 1;
+                }
+            }
+        }
+    }
+    free(pixels);
+    return 0;
+}
@@ -0,0 +1,271 @@
+/*
+ * Runs headless scenes for a fixed number of fixed-dt ticks and reports how
+ * long scene_tick() takes and how often it allocates.
+ * Each scenario is run at several sizes to show how the cost scales with the
+ * number of bodies and force creators ("handlers") in the scene.
+ * Then times respawning in each level, with and without the scene's arena.
+ * Build and run with "make bench".
+ */
+#include "bench_util.h"
+#include "forces.h"
+#include "gen_forces.h"
+#include "gen_levels.h"
+#include "helpers.h"
+#include "shape.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const double BENCH_DT = 1.0 / 60;
+const RGBColor BENCH_COLOR = {0.5, 0.5, 0.5};
+
+// The same player size as attack_of_the_circles
+const double LEVEL_PLAYER_SIZE = 100;
+const int LEVEL_SHOT_INTERVAL = 60;
+const int RESPAWN_ITERATIONS = 500;
+
+const double NBODY_G = 600;
+const double NBODY_THETA = 0.5;
+const Vector NBODY_MAX = {4000, 2000};
+
+// Distances from the pegs demo
+const double PEG_ROW_SPACING = 3.6;
+const double PEG_COL_SPACING = 3.5;
+const double PEG_RADIUS = 0.5;
+const double PEG_BALL_RADIUS = 1.0;
+const double PEG_BALL_MASS = 2.0;
+const double PEG_ELASTICITY = 0.3;
+const int PEG_DROP_INTERVAL = 30;
+const double PEG_EARTH_G = 6.67E-11;
+const double PEG_EARTH_MASS = 6E24;
+const double PEG_EARTH_RADIUS = 6.38E6;
+
+const int BRICK_COLUMNS = 10;
+const double BRICK_WIDTH = 40;
+const double BRICK_HEIGHT = 15;
+const int BREAKOUT_BALLS = 4;
+const double BREAKOUT_BALL_SPEED = 300;
+const double BREAKOUT_ELASTICITY = 1;
+
+typedef struct scenario{
+    const char *name;
+    // Builds the scene for one size of the scenario
+    Scene *(*build)(int size);
+    // Runs before each tick, e.g. to add bodies; may be NULL
+    void (*step)(Scene *scene, int tick);
+    int ticks;
+    // The sizes to run, ending with 0
+    int sizes[8];
+} Scenario;
+
+// Level 1 is the tutorial and level 5 is the boss level.
+// Generates the level in the scene's arena if use_arena is set, like the game.
+Scene *build_level_in(int level, bool use_arena){
+    Scene *scene = scene_init();
+    scene_use_arena(scene, use_arena);
+    Body *player = gen_player_sq(LEVEL_PLAYER_SIZE, scene);
+    switch(level){
+        case 1: gen_tutorial_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        case 2: gen_first_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        case 3: gen_second_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        case 4: gen_third_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        default: gen_boss_level(LEVEL_PLAYER_SIZE, scene, player); break;
+    }
+    gen_forces(scene);
+    scene_use_arena(scene, false);
+    // Hold the right arrow so the player runs through the level
+    int *keys = scene_key_data(scene);
+    keys[RIGHT_ARROW] = KEY_PRESSED;
+    keys[LEFT_ARROW] = KEY_RELEASED;
+    keys[UP_ARROW] = KEY_RELEASED;
+    return scene;
+}
+
+Scene *build_level(int level){
+    return build_level_in(level, true);
+}
+
+void step_level(Scene *scene, int tick){
+    if(tick % LEVEL_SHOT_INTERVAL == 0 && get_first_body(scene, PLAYER) != NULL){
+        gen_bullet(LEVEL_PLAYER_SIZE, scene, BULLET);
+    }
+}
+
+Scene *build_nbody(int count){
+    Scene *scene = scene_init();
+    for(int i = 0; i < count; i++){
+        double radius = 5 + rand() % 10;
+        Body *body = body_init(shape_circle(radius, 12), radius * radius, BENCH_COLOR);
+        body_set_centroid(body, (Vector){
+            NBODY_MAX.x * rand() / RAND_MAX, NBODY_MAX.y * rand() / RAND_MAX
+        });
+        scene_add_body(scene, body);
+    }
+    create_scene_gravity(scene, NBODY_G, NBODY_THETA);
+    return scene;
+}
+
+Body *add_static_body(Scene *scene, VectorList *shape, Vector centroid){
+    Body *body = body_init(shape, INFINITY, BENCH_COLOR);
+    body_set_centroid(body, centroid);
+    scene_add_body(scene, body);
+    return body;
+}
+
+// A triangle of pegs with the given number of rows above a floor.
+// The scene's bodies are the earth, then the floor, then the pegs.
+Scene *build_pegs(int rows){
+    Scene *scene = scene_init();
+    double width = (rows + 2) * PEG_COL_SPACING;
+    double height = (rows + 2) * PEG_ROW_SPACING;
+    Body *earth = body_init(shape_rectangle(1, 1), PEG_EARTH_MASS, BENCH_COLOR);
+    body_set_centroid(earth, (Vector){width / 2, -PEG_EARTH_RADIUS});
+    scene_add_body(scene, earth);
+    add_static_body(scene, shape_rectangle(width, 1), (Vector){width / 2, 0.5});
+    for(int row = 1; row <= rows; row++){
+        for(int col = 0; col <= row; col++){
+            Vector center = {
+                width / 2 + (col - row * 0.5) * PEG_COL_SPACING,
+                height - (row + 1) * PEG_ROW_SPACING
+            };
+            add_static_body(scene, shape_circle(PEG_RADIUS, 20), center);
+        }
+    }
+    return scene;
+}
+
+// Drops a ball that bounces off the pegs, the floor and every earlier ball
+void step_pegs(Scene *scene, int tick){
+    if(tick % PEG_DROP_INTERVAL != 0){
+        return;
+    }
+    Body *earth = scene_get_body(scene, 0);
+    size_t bodies = scene_bodies(scene);
+    double width = 2 * body_get_centroid(earth).x;
+    // Alternate the drop position so the pile spreads out
+    double offset = (tick / PEG_DROP_INTERVAL % 5 - 2) * 0.3;
+    Body *ball = body_init(shape_circle(PEG_BALL_RADIUS, 20), PEG_BALL_MASS, BENCH_COLOR);
+    body_set_centroid(ball, (Vector){width / 2 + offset,
+      body_get_centroid(scene_get_body(scene, 2)).y + 3});
+    scene_add_body(scene, ball);
+    create_newtonian_gravity(scene, PEG_EARTH_G, earth, ball);
+    for(size_t i = 1; i < bodies; i++){
+        create_physics_collision(scene, PEG_ELASTICITY, ball, scene_get_body(scene, i));
+    }
+}
+
+void break_brick(Body *ball, Body *brick, Vector axis, void *aux, CollisionEventType type){
+    if(type == COLLISION_START){
+        body_remove(brick);
+    }
+}
+
+// A box with the given number of rows of bricks at the top and a few balls
+Scene *build_breakout(int rows){
+    Scene *scene = scene_init();
+    double width = BRICK_COLUMNS * BRICK_WIDTH;
+    double height = (rows + 20) * BRICK_HEIGHT;
+    List *walls = list_init(4, NULL);
+    list_add(walls, add_static_body(scene, shape_rectangle(width, 10), (Vector){width / 2, -5}));
+    list_add(walls, add_static_body(scene, shape_rectangle(width, 10), (Vector){width / 2, height + 5}));
+    list_add(walls, add_static_body(scene, shape_rectangle(10, height), (Vector){-5, height / 2}));
+    list_add(walls, add_static_body(scene, shape_rectangle(10, height), (Vector){width + 5, height / 2}));
+
+    List *bricks = list_init(rows * BRICK_COLUMNS, NULL);
+    for(int row = 0; row < rows; row++){
+        for(int col = 0; col < BRICK_COLUMNS; col++){
+            Vector center = {(col + 0.5) * BRICK_WIDTH, height - (row + 0.5) * BRICK_HEIGHT};
+            list_add(bricks, add_static_body(scene,
+              shape_rectangle(BRICK_WIDTH - 2, BRICK_HEIGHT - 2), center));
+        }
+    }
+
+    for(int i = 0; i < BREAKOUT_BALLS; i++){
+        Body *ball = body_init(shape_circle(5, 20), 1, BENCH_COLOR);
+        body_set_centroid(ball, (Vector){(i + 0.5) * width / BREAKOUT_BALLS, 3 * BRICK_HEIGHT});
+        double angle = M_PI / 3 + i * M_PI / 9;
+        body_set_velocity(ball, vec_multiply(BREAKOUT_BALL_SPEED, (Vector){cos(angle), sin(angle)}));
+        scene_add_body(scene, ball);
+        for(size_t j = 0; j < list_size(walls); j++){
+            create_physics_collision(scene, BREAKOUT_ELASTICITY, ball, list_get(walls, j));
+        }
+        for(size_t j = 0; j < list_size(bricks); j++){
+            Body *brick = list_get(bricks, j);
+            create_physics_collision(scene, BREAKOUT_ELASTICITY, ball, brick);
+            create_collision(scene, ball, brick, break_brick, NULL, NULL);
+        }
+    }
+    list_free(walls);
+    list_free(bricks);
+    return scene;
+}
+
+void run_scenario(Scenario *scenario){
+    for(int s = 0; scenario->sizes[s] != 0; s++){
+        srand(1);
+        Scene *scene = scenario->build(scenario->sizes[s]);
+        double total_ns = 0;
+        size_t allocations = 0;
+        double bodies = 0, handlers = 0;
+        for(int tick = 0; tick < scenario->ticks; tick++){
+            if(scenario->step != NULL){
+                scenario->step(scene, tick);
+            }
+            bodies += scene_bodies(scene);
+            handlers += scene_force_handlers(scene);
+            size_t allocations_before = bench_allocations();
+            double start = now_ns();
+            scene_tick(scene, BENCH_DT);
+            total_ns += now_ns() - start;
+            allocations += bench_allocations() - allocations_before;
+        }
+        printf("%-10s %6d %9.1f %9.1f %12.0f %12.2f\n", scenario->name, scenario->sizes[s],
+          bodies / scenario->ticks, handlers / scenario->ticks,
+          total_ns / scenario->ticks, (double) allocations / scenario->ticks);
+        scene_free(scene);
+    }
+}
+
+// Times what the game does when the player dies: scene_free() and then
+// generating the level again. Returns the average nanoseconds per respawn.
+double time_respawn(int level, bool use_arena, double *allocations){
+    Scene *scene = build_level_in(level, use_arena);
+    size_t allocations_before = bench_allocations();
+    double start = now_ns();
+    for(int i = 0; i < RESPAWN_ITERATIONS; i++){
+        scene_free(scene);
+        scene = build_level_in(level, use_arena);
+    }
+    double ns = (now_ns() - start) / RESPAWN_ITERATIONS;
+    *allocations = (double) (bench_allocations() - allocations_before) / RESPAWN_ITERATIONS;
+    scene_free(scene);
+    return ns;
+}
+
+void bench_respawn(void){
+    printf("\n%-10s %6s %12s %12s %12s %12s\n", "respawn", "level",
+      "pools ns", "pool allocs", "arena ns", "arena allocs");
+    for(int level = 1; level <= 5; level++){
+        double pool_allocations, arena_allocations;
+        double pool_ns = time_respawn(level, false, &pool_allocations);
+        double arena_ns = time_respawn(level, true, &arena_allocations);
+        printf("%-10s %6d %12.0f %12.1f %12.0f %12.1f\n", "respawn", level,
+          pool_ns, pool_allocations, arena_ns, arena_allocations);
+    }
+}
+
+int main(int argc, char *argv[]){
+    Scenario scenarios[] = {
+        {"level", build_level, step_level, 3000, {1, 2, 3, 4, 5}},
+        {"nbody", build_nbody, NULL, 200, {250, 500, 1000, 2000, 4000}},
+        {"pegs", build_pegs, step_pegs, 1200, {6, 11, 16, 24}},
+        {"breakout", build_breakout, NULL, 2000, {4, 8, 16, 32}}
+    };
+    printf("%-10s %6s %9s %9s %12s %12s\n",
+      "scenario", "size", "bodies", "handlers", "ns/tick", "allocs/tick");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(*scenarios); i++){
+        run_scenario(&scenarios[i]);
+    }
+    bench_respawn();
+    return 0;
+}
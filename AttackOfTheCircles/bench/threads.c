@@ -0,0 +1,161 @@
+/*
+ * Measures how scene_tick() scales with the number of threads it may use
+ * (see scene_set_threads()), and checks that deterministic scenes end up
+ * exactly where the single-threaded run does.
+ * The scenarios are Barnes-Hut scene gravity like the nbodies demo, a mesh
+ * of springs with one parallel force creator per spring, and a game level,
+ * which is mostly collisions that stay on one thread.
+ * Build and run with "make bench".
+ */
+#include "bench_util.h"
+#include "forces.h"
+#include "gen_forces.h"
+#include "gen_levels.h"
+#include "helpers.h"
+#include "shape.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const double THREADS_BENCH_DT = 1.0 / 120;
+const RGBColor THREADS_BENCH_COLOR = {0.5, 0.5, 0.5};
+const size_t THREAD_COUNTS[] = {1, 2, 4, 8, 16};
+
+const double NBODY_G = 600;
+const double NBODY_THETA = 0.5;
+const Vector NBODY_MAX = {4000, 2000};
+
+const double MESH_K = 50;
+const double MESH_SPACING = 10;
+const double MESH_DRAG = 0.5;
+
+const double LEVEL_PLAYER_SIZE = 100;
+
+typedef struct thread_scenario{
+    const char *name;
+    Scene *(*build)(int size);
+    int size;
+    int ticks;
+} ThreadScenario;
+
+Scene *build_nbody(int count){
+    Scene *scene = scene_init();
+    for(int i = 0; i < count; i++){
+        double radius = 5 + rand() % 10;
+        Body *body = body_init(shape_circle(radius, 12), radius * radius, THREADS_BENCH_COLOR);
+        body_set_centroid(body, (Vector){
+            NBODY_MAX.x * rand() / RAND_MAX, NBODY_MAX.y * rand() / RAND_MAX
+        });
+        scene_add_body(scene, body);
+    }
+    scene_set_integrator(scene, INTEGRATOR_VELOCITY_VERLET);
+    create_scene_gravity(scene, NBODY_G, NBODY_THETA);
+    return scene;
+}
+
+// A side x side grid of masses, each tied to its right and upper
+// neighbours by springs, with drag, and a random kick to start it moving
+Scene *build_mesh(int side){
+    Scene *scene = scene_init();
+    for(int y = 0; y < side; y++){
+        for(int x = 0; x < side; x++){
+            Body *body = body_init(shape_circle(1, 6), 1, THREADS_BENCH_COLOR);
+            body_set_centroid(body, (Vector){x * MESH_SPACING, y * MESH_SPACING});
+            body_set_velocity(body, (Vector){rand() % 21 - 10, rand() % 21 - 10});
+            scene_add_body(scene, body);
+        }
+    }
+    for(int y = 0; y < side; y++){
+        for(int x = 0; x < side; x++){
+            Body *body = scene_get_body(scene, y * side + x);
+            if(x + 1 < side){
+                create_spring(scene, MESH_K, body, scene_get_body(scene, y * side + x + 1));
+            }
+            if(y + 1 < side){
+                create_spring(scene, MESH_K, body, scene_get_body(scene, (y + 1) * side + x));
+            }
+            create_drag(scene, MESH_DRAG, body);
+        }
+    }
+    return scene;
+}
+
+Scene *build_level(int level){
+    Scene *scene = scene_init();
+    Body *player = gen_player_sq(LEVEL_PLAYER_SIZE, scene);
+    switch(level){
+        case 1: gen_tutorial_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        case 2: gen_first_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        case 3: gen_second_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        case 4: gen_third_level(LEVEL_PLAYER_SIZE, scene, player); break;
+        default: gen_boss_level(LEVEL_PLAYER_SIZE, scene, player); break;
+    }
+    gen_forces(scene);
+    scene_key_data(scene)[RIGHT_ARROW] = KEY_PRESSED;
+    return scene;
+}
+
+// Runs a scenario and returns the ns per tick. Fills state with the bodies'
+// centroids and velocities at the end, which must have room for all of them.
+double run_threads(ThreadScenario *scenario, size_t threads, bool deterministic,
+  Vector *state, size_t *bodies){
+    srand(1);
+    Scene *scene = scenario->build(scenario->size);
+    scene_set_threads(scene, threads);
+    scene_set_deterministic(scene, deterministic);
+    double start = now_ns();
+    for(int tick = 0; tick < scenario->ticks; tick++){
+        scene_tick(scene, THREADS_BENCH_DT);
+    }
+    double ns = (now_ns() - start) / scenario->ticks;
+    *bodies = scene_bodies(scene);
+    for(size_t i = 0; i < *bodies; i++){
+        state[2 * i] = body_get_centroid(scene_get_body(scene, i));
+        state[2 * i + 1] = body_get_velocity(scene_get_body(scene, i));
+    }
+    scene_free(scene);
+    return ns;
+}
+
+void run_scenario(ThreadScenario *scenario, size_t max_bodies){
+    Vector *serial = malloc(sizeof(Vector) * 2 * max_bodies);
+    Vector *state = malloc(sizeof(Vector) * 2 * max_bodies);
+    size_t serial_bodies;
+    double serial_ns = run_threads(scenario, 1, true, serial, &serial_bodies);
+    for(size_t i = 0; i < sizeof(THREAD_COUNTS) / sizeof(*THREAD_COUNTS); i++){
+        for(int deterministic = 1; deterministic >= 0; deterministic--){
+            size_t threads = THREAD_COUNTS[i];
+            if(threads == 1 && !deterministic){
+                continue;
+            }
+            size_t bodies;
+            double ns = threads == 1 ? serial_ns
+              : run_threads(scenario, threads, deterministic, state, &bodies);
+            bool exact = threads == 1 || (bodies == serial_bodies
+              && memcmp(state, serial, sizeof(Vector) * 2 * bodies) == 0);
+            printf("%-8s %6d %8zu %14s %12.0f %8.2f %6s\n", scenario->name, scenario->size,
+              threads, deterministic ? "deterministic" : "summed", ns, serial_ns / ns,
+              exact ? "yes" : "no");
+        }
+    }
+    free(serial);
+    free(state);
+}
+
+int main(int argc, char *argv[]){
+    ThreadScenario scenarios[] = {
+        {"nbody", build_nbody, 4000, 100},
+        {"nbody", build_nbody, 16000, 20},
+        {"mesh", build_mesh, 100, 300},
+        {"mesh", build_mesh, 300, 30},
+        {"level", build_level, 4, 2000}
+    };
+    printf("%-8s %6s %8s %14s %12s %8s %6s\n",
+      "scenario", "size", "threads", "forces", "ns/tick", "speedup", "exact");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(*scenarios); i++){
+        // Enough room for the largest scene of each kind
+        run_scenario(&scenarios[i], 100000);
+    }
+    return 0;
+}
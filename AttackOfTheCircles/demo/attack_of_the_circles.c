@@ -15,7 +15,11 @@
 #include <assert.h>
 #include <math.h>
 
-int curr_level = -1;
+// What the game keeps between levels; each level gets a new scene
+typedef struct game{
+    Scene *scene;
+    int level;
+} Game;
 
 const int WINDOW_WIDTH = 3000;
 const int WINDOW_HEIGHT = 1000;
@@ -44,8 +48,7 @@ void player_shoot(Scene *scene){
     Body *player = get_first_body(scene, PLAYER);
     BodyInfo *info = body_get_info(player);
     if(info->bullet_count < info->MAX_BULLETS){
-        Body *bullet = gen_bullet(PLAYER_SIZE, scene, BULLET);
-        add_bullet_forces(scene, bullet);
+        gen_bullet(PLAYER_SIZE, scene, BULLET);
         info->bullet_count = info->bullet_count + 1;
     }
 }
@@ -63,7 +66,8 @@ void regen_bullets(Scene *scene){
 }
 
 void on_key(char key, KeyEventType type, double held_time, void* data){
-    Scene *scene = (Scene*) data;
+    Game *game = (Game*) data;
+    Scene *scene = game->scene;
     int *key_data = scene_key_data(scene);
     Body *player = get_first_body(scene, PLAYER);
     BodyInfo *info = body_get_info(player);
@@ -86,11 +90,13 @@ void on_key(char key, KeyEventType type, double held_time, void* data){
             break;
         case 'c':
             printf("(%f, %f)\n", centroid.x, centroid.y);
+            printf("drew %zu bodies, skipped %zu\n", sdl_get_render_stats().drawn,
+              sdl_get_render_stats().skipped);
             break;
         case '\r':
             if (scene_get_finished_title_screen(scene) == false){
               scene_set_finished_title_screen(scene, true);
-              curr_level = 0;
+              game->level = 0;
               scene_set_done(scene, true);
             }
             break;
@@ -104,8 +110,12 @@ void scene_init_camera(Scene *scene){
     scene_set_camera(scene, (Vector){body_get_centroid(player).x - WINDOW_WIDTH/2, 0});
 }
 
-Scene *gen_level(int level_num){
+Scene *gen_level(Game *game){
+    int level_num = game->level;
     Scene *scene = scene_init();
+    scene_seed(scene, time(NULL));
+    // Everything the level starts with is freed at once when the player dies
+    scene_use_arena(scene, true);
     Body *player = gen_player_sq(PLAYER_SIZE, scene);
 
     switch(level_num){
@@ -128,8 +138,9 @@ Scene *gen_level(int level_num){
             break;
     }
     gen_forces(scene);
+    scene_use_arena(scene, false);
     scene_set_camera_follower(scene, camera_position, get_first_body(scene, PLAYER), NULL);
-    sdl_on_key(on_key, scene);
+    scene_set_key_handler(scene, on_key, game);
     //spawn_enemy(scene, (Vector){PLAYER_SIZE*5, PLAYER_SIZE*5});
     //scene_init_camera(toret);
 
@@ -182,24 +193,25 @@ int main(int argc, const char* argv[]){
     Vector min_corn = {.x = 0, .y = 0};
     Vector max_corn = {.x = WINDOW_WIDTH, .y = WINDOW_HEIGHT};
     sdl_init(min_corn, max_corn);
-    srand(time(NULL));
 
-    Scene *scene = gen_level(curr_level);
+    Game game = {.scene = NULL, .level = -1};
+    game.scene = gen_level(&game);
 
-    while(!sdl_is_done()){
+    while(!sdl_is_done(game.scene)){
+        Scene *scene = game.scene;
         double dt = time_since_last_tick();
         Body *player = get_first_body(scene, PLAYER);
         Vector player_location = body_get_centroid(player);
         BodyInfo *info = body_get_info(player);
 
-        scene_tick(scene, dt);
+        scene_step(scene, dt);
         sdl_render_scene(scene);
-        if(curr_level != -1 && curr_level != 5){
+        if(game.level != -1 && game.level != 5){
           add_gui(scene, min_corn, max_corn, info->MAX_BULLETS);
         }
         regen_bullets(scene);
 
-        switch(curr_level){
+        switch(game.level){
             case -1:
                 gen_title_text();
                 break;
@@ -217,13 +229,13 @@ int main(int argc, const char* argv[]){
         sdl_show();
 
         if(scene_check_finished_level(scene)){
-          curr_level++;
+          game.level++;
           scene_set_done(scene, true);
         }
         if(scene_is_done(scene) ||  body_get_centroid(player).y < -100){
             scene_free(scene);
-            scene = gen_level(curr_level);
+            game.scene = gen_level(&game);
         }
     }
-    scene_free(scene);
+    scene_free(game.scene);
 }
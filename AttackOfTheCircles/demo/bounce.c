@@ -82,13 +82,13 @@ int main(int argc, const char* argv[]){
     sdl_init(min_corn, min_max);
     max_diff = vec_subtract(min_max, vec_multiply(.5, vec_add(min_corn, min_max)));
     VectorList* star = make_star();
-    while(!sdl_is_done()){
+    while(!sdl_is_done(NULL)){
         double dt = time_since_last_tick();
         move(star, dt);
         check_edge(star);
 
         sdl_clear();
-        sdl_draw_polygon(star, (RGBColor){r, g, b}, false);
+        sdl_draw_polygon(star, (RGBColor){r, g, b}, VEC_ZERO);
         sdl_show();
     }
     vec_list_free(star);
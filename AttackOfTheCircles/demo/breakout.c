@@ -62,9 +62,9 @@ void body_info_free_blocks(BodyInfoBlocks *body_info){
 }
 
 void gen_player(Scene *scene, Vector min_corn){
-    List *shape = shape_rectangle(PLAYER_BLOCK_WIDTH, PLAYER_BLOCK_HEIGHT);
+    VectorList *shape = shape_rectangle(PLAYER_BLOCK_WIDTH, PLAYER_BLOCK_HEIGHT);
     BodyInfoBlocks *body_info = body_info_init(PLAYER_BLOCK, 0, false);
-    Body *player = body_init_with_info(shape, INFINITY, gen_color(), body_info, (FreeFunc)body_info_free_blocks);
+    Body *player = body_init_with_info(shape, INFINITY, gen_color(scene_rng(scene)), body_info, (FreeFunc)body_info_free_blocks);
     body_set_centroid(player, (Vector){0, min_corn.y});
     scene_add_body(scene, player);
 }
@@ -90,7 +90,7 @@ double *rainbow_maker(int i, double *prev_color, double num_stuff){
 }
 
 void gen_powerup(Scene *scene, RGBColor color, Vector center){
-    List *shape = shape_estrella(POWERUP_SIZE);
+    VectorList *shape = shape_estrella(POWERUP_SIZE);
     BodyInfoBlocks *body_info = body_info_init(POWERUP, 0, false);
     Body *powerup = body_init_with_info(shape, INFINITY, color, body_info, (FreeFunc)body_info_free_blocks);
     body_set_centroid(powerup, center);
@@ -100,7 +100,7 @@ void gen_powerup(Scene *scene, RGBColor color, Vector center){
 void add_brick_row(Scene *scene, double height, double min_x, double max_x){
     double prev_color[5] = {1, 0, 1, -1, 2};
     for(int i = min_x + MARGIN; i < max_x; i += BRICK_WIDTH+SPACING){
-        List *brick = shape_rectangle(BRICK_WIDTH, BRICK_HEIGHT);
+        VectorList *brick = shape_rectangle(BRICK_WIDTH, BRICK_HEIGHT);
         BodyInfoBlocks *body_info = body_info_init(BRICK, 0, false);
         RGBColor rainbow = (RGBColor){prev_color[0], prev_color[1], prev_color[2]};
         Body *brick_body = body_init_with_info(brick, BRICK_MASS, rainbow, body_info, (FreeFunc)body_info_free_blocks);
@@ -121,10 +121,10 @@ void gen_bricks(Scene *scene, Vector min_corn, Vector max_corn){
 }
 
 void gen_walls(Scene *scene, Vector min_corn, Vector max_corn){
-    List *wall1 = shape_rectangle(100, max_corn.y - min_corn.y);
-    List *wall2 = shape_rectangle(100, max_corn.y - min_corn.y);
-    List *wall3 = shape_rectangle(max_corn.x - min_corn.x, 100);
-    List *wall4 = shape_rectangle(max_corn.x - min_corn.x, 100);
+    VectorList *wall1 = shape_rectangle(100, max_corn.y - min_corn.y);
+    VectorList *wall2 = shape_rectangle(100, max_corn.y - min_corn.y);
+    VectorList *wall3 = shape_rectangle(max_corn.x - min_corn.x, 100);
+    VectorList *wall4 = shape_rectangle(max_corn.x - min_corn.x, 100);
     BodyInfoBlocks *body_info1 = body_info_init(WALL, 0, false);
     BodyInfoBlocks *body_info2 = body_info_init(WALL, 0, false);
     BodyInfoBlocks *body_info3 = body_info_init(BOTTOM_WALL, 1, false);
@@ -144,7 +144,7 @@ void gen_walls(Scene *scene, Vector min_corn, Vector max_corn){
 }
 
 void gen_ball(Scene *scene){
-    List *shape = shape_circle(BALL_SIZE, CIRCLE_POINTS);
+    VectorList *shape = shape_circle(BALL_SIZE, CIRCLE_POINTS);
     BodyInfoBlocks *body_info = body_info_init(BALL, 1, false);
     Body *ball = body_init_with_info(shape, BALL_MASS, GRAY, body_info, (FreeFunc)body_info_free_blocks);
     body_set_velocity(ball, (Vector){((rand() % 2)*2 - 1) * BALL_SPEED/2, BALL_SPEED});
@@ -297,7 +297,7 @@ Scene *gen_game(Vector min_corn, Vector max_corn, KeyHandler on_key){
     Scene *scene = scene_init();
     gen_bodies(scene, min_corn, max_corn);
     gen_collisions(scene);
-    sdl_on_key(on_key, scene);
+    scene_set_key_handler(scene, on_key, scene);
     return scene;
 }
 
@@ -309,9 +309,9 @@ int main(int argc, const char* argv[]){
     sdl_init(min_corn, max_corn);
     Scene *my_scene = gen_game(min_corn, max_corn, on_key);
 
-    while(!sdl_is_done()){
+    while(!sdl_is_done(my_scene)){
         double dt = time_since_last_tick();
-        scene_tick(my_scene, dt);
+        scene_step(my_scene, dt);
         sdl_render_scene(my_scene);
 
         if(scene_is_done(my_scene)){
@@ -84,9 +84,9 @@ int main(int argc, const char* argv[]){
       create_drag(mass_scene, GAMMA * (i + 1) / 10, scene_get_body(mass_scene, i));
     }
 
-    while(!sdl_is_done()){
+    while(!sdl_is_done(mass_scene)){
         double dt = time_since_last_tick();
-        scene_tick(mass_scene, dt);
+        scene_step(mass_scene, dt);
         sdl_render_scene(mass_scene);
     }
     scene_free(mass_scene);
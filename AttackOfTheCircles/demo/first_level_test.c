@@ -41,8 +41,7 @@ void player_shoot(Scene *scene){
     Body *player = get_first_body(scene, PLAYER);
     BodyInfo *info = body_get_info(player);
     if(info->bullet_count < info->MAX_BULLETS){
-        Body *bullet = gen_bullet(PLAYER_SIZE, scene, BULLET);
-        add_bullet_forces(scene, bullet);
+        gen_bullet(PLAYER_SIZE, scene, BULLET);
         info->bullet_count = info->bullet_count + 1;
     }
 }
@@ -96,6 +95,7 @@ void scene_init_camera(Scene *scene){
 
 Scene *gen_level(int level_num){
     Scene *scene = scene_init();
+    scene_seed(scene, time(NULL));
 
     Body *player = gen_player_sq(PLAYER_SIZE, scene);
 
@@ -118,7 +118,7 @@ Scene *gen_level(int level_num){
     }
     gen_forces(scene);
     scene_set_camera_follower(scene, camera_position, get_first_body(scene, PLAYER), NULL);
-    sdl_on_key(on_key, scene);
+    scene_set_key_handler(scene, on_key, scene);
     //spawn_enemy(scene, (Vector){PLAYER_SIZE*5, PLAYER_SIZE*5});
     //scene_init_camera(toret);
 
@@ -166,12 +166,11 @@ int main(int argc, const char* argv[]){
     Vector min_corn = {.x = 0, .y = 0};
     Vector max_corn = {.x = WINDOW_WIDTH, .y = WINDOW_HEIGHT};
     sdl_init(min_corn, max_corn);
-    srand(time(NULL));
 
     int curr_level = 1;
     Scene *scene = gen_level(curr_level);
 
-    while(!sdl_is_done()){
+    while(!sdl_is_done(scene)){
         double dt = time_since_last_tick();
         Body *player = get_first_body(scene, PLAYER);
         Vector player_location = body_get_centroid(player);
@@ -19,6 +19,8 @@ const int rotation_rate = 6;
 
 List* gen_shapes(int num_shapes, Vector spawn_point){
     srand(time(NULL));
+    Rng rng;
+    rng_seed(&rng, time(NULL));
     List* to_ret = list_init(num_shapes + 1, (FreeFunc)body_free);
 
     int initial_spokes = 2;
@@ -28,7 +30,7 @@ List* gen_shapes(int num_shapes, Vector spawn_point){
         int initial_y = -200;
         Vector velocity = (Vector){initial_x, initial_y};
 
-        Body* to_add = body_init(shape_star(num_points, 1.0, LARGE_SCALE, SMALL_SCALE), 1.0, gen_color());
+        Body* to_add = body_init(shape_star(num_points, 1.0, LARGE_SCALE, SMALL_SCALE), 1.0, gen_color(&rng));
         body_set_velocity(to_add, velocity);
         body_set_centroid(to_add, spawn_point);
 
@@ -40,9 +42,7 @@ List* gen_shapes(int num_shapes, Vector spawn_point){
 
 void draw_body(List *bodies, int ind){
     Body* body = list_get(bodies, ind);
-    List* shape = body_get_shape(body);
-    sdl_draw_polygon(shape, body_get_color(body), false);
-    list_free(shape);
+    sdl_draw_polygon(body_get_shape_view(body), body_get_color(body), VEC_ZERO);
 }
 
 void body_rotate_velocity(Body* body, double speed, double total_time){
@@ -62,10 +62,10 @@ void body_motion(Body* body, Vector dir, double dt, double speed, double total_t
 
 bool body_check_touch(Body* body, double threshold, bool yDirection){
     bool collided = false;
-    List* shape = body_get_shape(body);
-    int num_vertices = list_size(shape);
+    VectorList* shape = body_get_shape(body);
+    int num_vertices = vec_list_size(shape);
     for(int i = 0; i < num_vertices; i++){
-      Vector v = *(Vector*)list_get(shape, i);
+      Vector v = vec_list_get(shape, i);
       if(!yDirection){
         if(v.x > threshold){
           collided = true;
@@ -76,15 +76,15 @@ bool body_check_touch(Body* body, double threshold, bool yDirection){
           }
       }
     }
-    list_free(shape);
+    vec_list_free(shape);
     return collided;
 }
 
 bool body_check_offscreen(Body* body, double threshold, bool yDirection){
-    List* shape = body_get_shape(body);
-    int num_vertices = list_size(shape);
+    VectorList* shape = body_get_shape(body);
+    int num_vertices = vec_list_size(shape);
     for(int i = 0; i < num_vertices; i++){
-        Vector v = *(Vector*)list_get(shape, i);
+        Vector v = vec_list_get(shape, i);
         if(!yDirection){
             if(!(v.x > threshold)){
                 return false;
@@ -96,7 +96,7 @@ bool body_check_offscreen(Body* body, double threshold, bool yDirection){
             }
         }
     }
-    list_free(shape);
+    vec_list_free(shape);
     return true;
 }
 
@@ -118,7 +118,7 @@ int main(int argc, const char* argv[]){
 
     int num_shapes = 6;
     List *list_of_shapes = gen_shapes(num_shapes, upper_left);
-    while(!sdl_is_done()){
+    while(!sdl_is_done(NULL)){
         sdl_clear();
         double dt = time_since_last_tick();
         total_time += dt;
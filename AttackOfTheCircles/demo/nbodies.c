@@ -17,7 +17,9 @@ const int WINDOW_HEIGHT = 500;
 const int MAX_PLANET_RADIUS = 60;
 const int MIN_PLANET_RADIUS = 30;
 const int NUM_BODIES = 100;
-const double G = 300;
+const double G = 600;
+// Barnes-Hut opening angle; see create_scene_gravity()
+const double THETA = 0.5;
 
 Vector gen_random_location(Vector min, Vector max){
     double rand_x = fmod((double)rand(), max.x - min.x) + min.x;
@@ -26,9 +28,9 @@ Vector gen_random_location(Vector min, Vector max){
 }
 
 
-Body *create_planet(double radius, int num_vertices, Vector center){
-    List *l = shape_estrella(radius);
-    Body *b = body_init(l, radius * radius, gen_color());
+Body *create_planet(double radius, int num_vertices, Vector center, Rng *rng){
+    VectorList *l = shape_estrella(radius);
+    Body *b = body_init(l, radius * radius, gen_color(rng));
     body_set_centroid(b, center);
     return b;
 }
@@ -36,12 +38,13 @@ Body *create_planet(double radius, int num_vertices, Vector center){
 void add_planet(Scene *scene, Vector min_corn, Vector max_corn){
     Vector loc = gen_random_location(min_corn, max_corn);
     double radius = rand() % MAX_PLANET_RADIUS + MIN_PLANET_RADIUS;
-    Body *planet = create_planet(radius, CIRCLE_POINTS, loc);
+    Body *planet = create_planet(radius, CIRCLE_POINTS, loc, scene_rng(scene));
     scene_add_body(scene, planet);
 }
 
 void gen_n_bodies(Scene *scene, int n, Vector min_corn, Vector max_corn){
     srand(time(NULL));
+    scene_seed(scene, time(NULL));
     for(int i = 0; i < n; i++){
         add_planet(scene, min_corn, max_corn);
     }
@@ -55,20 +58,16 @@ int main(int argc, const char* argv[]){
     sdl_init(min_corn, max_corn);
 
     Scene *my_scene = scene_init();
+    // Keeps the orbits' energy without shrinking the tick
+    scene_set_integrator(my_scene, INTEGRATOR_VELOCITY_VERLET);
     gen_n_bodies(my_scene, NUM_BODIES, min_corn, max_corn);
 
-    for(int i = 0; i < NUM_BODIES; i++){
-        Body *this_body = scene_get_body(my_scene, i);
-        for(int j = 0; j < NUM_BODIES; j++){
-            Body *that_body = scene_get_body(my_scene, j);
-            create_newtonian_gravity(my_scene, G, this_body, that_body);
-        }
-    }
+    create_scene_gravity(my_scene, G, THETA);
 
-    while(!sdl_is_done()){
+    while(!sdl_is_done(my_scene)){
         double dt = time_since_last_tick();
 
-        scene_tick(my_scene, dt);
+        scene_step(my_scene, dt);
         sdl_render_scene(my_scene);
     }
 
@@ -24,7 +24,7 @@ const double ACCELERATION = 3.0;
 Scene *my_scene;
 
 Body *create_pellet(double radius, int num_vertices, Vector center){
-    List *l = shape_circle(radius, num_vertices);
+    VectorList *l = shape_circle(radius, num_vertices);
     Body *b = body_init(l, 1.0, SHAPE_COLORS);
     body_set_centroid(b, center);
     return b;
@@ -32,10 +32,8 @@ Body *create_pellet(double radius, int num_vertices, Vector center){
 }
 
 Body *create_pacman(double radius, int num_vertices, Vector center){
-    List *l = shape_partial_circle(radius, num_vertices, (1 - PACMAN_MOUTH_ANGLE/(2 * M_PI)));
-    Vector *mouth = malloc(sizeof(Vector));
-    *mouth = (Vector){0, 0};
-    list_add(l, mouth);
+    VectorList *l = shape_partial_circle(radius, num_vertices, (1 - PACMAN_MOUTH_ANGLE/(2 * M_PI)));
+    vec_list_add(l, (Vector){0, 0});
     polygon_rotate(l, PACMAN_MOUTH_ANGLE/2, polygon_centroid(l));
     Body *b = body_init(l, 1.0, SHAPE_COLORS);
     body_set_centroid(b, center);
@@ -70,16 +68,15 @@ bool can_pacman_eat(Body *pacman, Body *pellet){
 
     if (centroid_distance <= PACMAN_RADIUS + PELLET_RADIUS){
 
-        List *points = body_get_shape(pacman);
+        const VectorList *points = body_get_shape_view(pacman);
 
-        for(int i = 0; i < list_size(points); i++){
-            Vector v = *(Vector *)(list_get(points, i));
+        for(int i = 0; i < vec_list_size(points); i++){
+            Vector v = vec_list_get(points, i);
             double distance = vec_distance(v, pellet_centroid);
             if(distance < COLLISION_THRESHOLD){
                 collided = true;
             }
         }
-        list_free(points);
     }
     return collided;
 }
@@ -155,14 +152,14 @@ int main(int argc, const char* argv[]){
 
     my_scene = scene_init();
     gen_scene_bodies(my_scene, min_corn, max_corn);
-    sdl_on_key(on_key, my_scene);
+    scene_set_key_handler(my_scene, on_key, my_scene);
 
-    while(!sdl_is_done()){
+    while(!sdl_is_done(my_scene)){
         double dt = time_since_last_tick();
         time_since_last_spawn += dt;
 
         Body *pacman = scene_get_body(my_scene, 0);
-        scene_tick(my_scene, dt);
+        scene_step(my_scene, dt);
         wrap_screen(pacman, min_corn, max_corn);
         sdl_render_scene(my_scene);
 
@@ -54,34 +54,24 @@ double rand_double(void) {
 }
 
 /** Constructs a rectangle with the given dimensions centered at (0, 0) */
-List *rect_init(double width, double height) {
+VectorList *rect_init(double width, double height) {
     Vector half_width  = {.x = width / 2, .y = 0.0},
            half_height = {.x = 0.0, .y = height / 2};
-    List *rect = list_init(4, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = vec_add(half_width, half_height);
-    list_add(rect, v);
-    v = malloc(sizeof(*v));
-    *v = vec_subtract(half_height, half_width);
-    list_add(rect, v);
-    v = malloc(sizeof(*v));
-    *v = vec_negate(*(Vector *) list_get(rect, 0));
-    list_add(rect, v);
-    v = malloc(sizeof(*v));
-    *v = vec_subtract(half_width, half_height);
-    list_add(rect, v);
+    VectorList *rect = vec_list_init(4);
+    vec_list_add(rect, vec_add(half_width, half_height));
+    vec_list_add(rect, vec_subtract(half_height, half_width));
+    vec_list_add(rect, vec_negate(vec_list_get(rect, 0)));
+    vec_list_add(rect, vec_subtract(half_width, half_height));
     return rect;
 }
 
 /** Constructs a circles with the given radius centered at (0, 0) */
-List *circle_init(double radius) {
-    List *circle = list_init(CIRCLE_POINTS, free);
+VectorList *circle_init(double radius) {
+    VectorList *circle = vec_list_init(CIRCLE_POINTS);
     double arc_angle = 2 * M_PI / CIRCLE_POINTS;
     Vector point = {.x = radius, .y = 0.0};
     for (int i = 0; i < CIRCLE_POINTS; i++) {
-        Vector *v = malloc(sizeof(*v));
-        *v = point;
-        list_add(circle, v);
+        vec_list_add(circle, point);
         point = vec_rotate(point, arc_angle);
     }
     return circle;
@@ -99,7 +89,7 @@ Vector get_peg_center(int row, int col) {
 /** Creates an Earth-like mass to accelerate the balls */
 Body *get_gravity_body() {
     // Will be offscreen, so shape is irrelevant
-    List *gravity_ball = rect_init(1, 1);
+    VectorList *gravity_ball = rect_init(1, 1);
     BodyType *type = malloc(sizeof(*type));
     *type = GRAVITY;
     Body *body = body_init_with_info(gravity_ball, M, WALL_COLOR, type, free);
@@ -113,7 +103,7 @@ Body *get_gravity_body() {
 
 /** Creates a ball with the given starting position and velocity */
 Body *get_ball(Vector center, Vector velocity) {
-    List *shape = circle_init(BALL_RADIUS);
+    VectorList *shape = circle_init(BALL_RADIUS);
     BodyType *info = malloc(sizeof(*info));
     *info = BALL;
     Body *ball = body_init_with_info(shape, BALL_MASS, BALL_COLOR, info, free);
@@ -185,7 +175,7 @@ List *add_obstacles(Scene *scene){
     // Add N_ROWS and N_COLS of pegs.
     for (int i = 1; i <= N_ROWS; i++) {
         for (int j = 0; j <= i; j++) {
-            List *polygon = circle_init(PEG_RADIUS);
+            VectorList *polygon = circle_init(PEG_RADIUS);
             BodyType *type = malloc(sizeof(*type));
             *type = WALL;
             Body *body =
@@ -197,7 +187,7 @@ List *add_obstacles(Scene *scene){
     }
 
     // Add walls
-    List *rect = rect_init(WALL_LENGTH, WALL_WIDTH);
+    VectorList *rect = rect_init(WALL_LENGTH, WALL_WIDTH);
     polygon_translate(rect, (Vector) {.x = WALL_LENGTH / 2, .y = 0.0});
     polygon_rotate(rect, WALL_ANGLE, VEC_ZERO);
     BodyType *type = malloc(sizeof(*type));
@@ -243,7 +233,7 @@ int main(int argc, char **argv){
 
     // Repeatedly render scene
     double time_since_drop = INFINITY;
-    while (!sdl_is_done()){
+    while (!sdl_is_done(scene)){
         double dt = time_since_last_tick();
 
         // Add a new ball every DROP_INTERVAL seconds
@@ -253,7 +243,7 @@ int main(int argc, char **argv){
             time_since_drop = 0.0;
         }
 
-        scene_tick(scene, dt);
+        scene_step(scene, dt);
         sdl_render_scene(scene);
     }
 
@@ -37,22 +37,18 @@ typedef enum {
 
 
 void gen_player(Scene *scene, Vector min_corn){
-    List *shape = shape_partial_circle(INVADER_RADIUS, CIRCLE_POINTS, UWU_BULGE/(2*M_PI));
-    Vector *bulge = malloc(sizeof(Vector));
-    *bulge = VEC_ZERO;
-    list_add(shape, bulge);
+    VectorList *shape = shape_partial_circle(INVADER_RADIUS, CIRCLE_POINTS, UWU_BULGE/(2*M_PI));
+    vec_list_add(shape, VEC_ZERO);
     polygon_rotate(shape, UWU_BULGE, VEC_ZERO);
     polygon_translate(shape, (Vector){0, min_corn.y + ROW_HEIGHT});
-    Body *player = body_init_with_info(shape, INVADER_MASS, gen_color(), (BODY_TYPE_INVADERS*)PLAYER_INVADERS, NULL);
+    Body *player = body_init_with_info(shape, INVADER_MASS, gen_color(scene_rng(scene)), (BODY_TYPE_INVADERS*)PLAYER_INVADERS, NULL);
     scene_add_body(scene, player);
 }
 
 void add_invader_row(Scene *scene, double height, double min_x, double max_x){
     for(int i = min_x + MARGIN; i < max_x; i += INVADER_RADIUS*2+SPACING){
-        List *invader = shape_partial_circle(INVADER_RADIUS, CIRCLE_POINTS, UWU_BULGE/(2*M_PI));
-        Vector *bulge = malloc(sizeof(Vector));
-        *bulge = VEC_ZERO;
-        list_add(invader, bulge);
+        VectorList *invader = shape_partial_circle(INVADER_RADIUS, CIRCLE_POINTS, UWU_BULGE/(2*M_PI));
+        vec_list_add(invader, VEC_ZERO);
         polygon_rotate(invader, -UWU_BULGE/2, VEC_ZERO);
         polygon_translate(invader, (Vector){i, height});
         Body *invader_body = body_init_with_info(invader, INVADER_MASS, GRAY, (BODY_TYPE_INVADERS*)INVADER, NULL);
@@ -90,7 +86,7 @@ void check_edge(Body *invader, Vector max_corn, Vector min_corn){
 }
 
 void spawn_bullet( Scene *scene, BODY_TYPE_INVADERS player, Vector spawn){
-    List *bull = shape_regular_star(4, BULLET_SIZE);
+    VectorList *bull = shape_regular_star(4, BULLET_SIZE);
     polygon_translate(bull, spawn);
     Body *bullet = body_init_with_info(bull, 10, GRAY, (BODY_TYPE_INVADERS *)player, NULL);
     if(player){
@@ -150,9 +146,9 @@ int main(int argc, const char* argv[]){
 
     gen_player(my_scene, min_corn);
     gen_invaders(my_scene, min_corn, max_corn);
-    sdl_on_key(on_key, my_scene);
+    scene_set_key_handler(my_scene, on_key, my_scene);
     srand(time(NULL));
-    while(!sdl_is_done()){
+    while(!sdl_is_done(my_scene)){
         double dt = time_since_last_tick();
 
         size_t num_bodies = scene_bodies(my_scene);
@@ -171,7 +167,7 @@ int main(int argc, const char* argv[]){
             exit(0);
         }
 
-        scene_tick(my_scene, dt);
+        scene_step(my_scene, dt);
         sdl_render_scene(my_scene);
     }
     scene_free(my_scene);
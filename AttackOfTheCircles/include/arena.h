@@ -0,0 +1,100 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A bump allocator for objects that all die at the same time, e.g. the
+ * bodies and forces of one level. Allocating only advances a pointer in
+ * the current chunk, and arena_free() releases every object at once.
+ * Objects can't be freed individually.
+ *
+ * An arena can be made current on a thread with arena_set_current().
+ * While it is, pool_alloc() and arena_malloc() allocate from it, so the
+ * usual constructors (body_init(), list_init(), create_spring(), ...) put
+ * their objects in the arena without being changed. The matching
+ * releasers (pool_release(), arena_release(), ...) do nothing for arena
+ * memory, so the usual freers stay safe to call on arena objects.
+ *
+ * An arena is not thread-safe; it must only be current on one thread at once.
+ */
+typedef struct arena Arena;
+
+/**
+ * Allocates an empty arena. No chunks are allocated until the first arena_alloc().
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return the new arena
+ */
+Arena *arena_init(void);
+
+/**
+ * Releases an arena and every object allocated from it.
+ * If the arena is current on this thread, no arena is current afterwards.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_free(Arena *arena);
+
+/**
+ * Allocates an object from an arena.
+ * The object's contents are undefined, like malloc().
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param arena the arena to allocate from
+ * @param size the size of the object, in bytes
+ * @return a pointer to size bytes, aligned for any type
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Gets the number of bytes allocated from an arena so far.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @return the total size of the objects allocated, including alignment padding
+ */
+size_t arena_bytes(Arena *arena);
+
+/**
+ * Checks whether an object was allocated from an arena that hasn't been freed.
+ * Works for any pointer, including NULL and pointers from malloc().
+ *
+ * @param object a pointer to check
+ * @return whether object points into a live arena
+ */
+bool arena_owns(const void *object);
+
+/**
+ * Sets the arena that pool_alloc() and arena_malloc() use on this thread.
+ *
+ * @param arena the arena to allocate from, or NULL to allocate normally
+ */
+void arena_set_current(Arena *arena);
+
+/**
+ * Gets the arena that pool_alloc() and arena_malloc() use on this thread.
+ *
+ * @return the current arena, or NULL if there is none
+ */
+Arena *arena_current(void);
+
+/**
+ * Allocates from the current arena, or with malloc() if there is none.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param size the size of the object, in bytes
+ * @return a pointer to size bytes, to release with arena_release()
+ */
+void *arena_malloc(size_t size);
+
+/**
+ * Releases an object from arena_malloc(): frees it if it came from malloc(),
+ * and does nothing if it is in an arena, or NULL.
+ * Matches FreeFunc, so it can be passed as a freer.
+ *
+ * @param object a pointer returned from arena_malloc(), or NULL
+ */
+void arena_release(void *object);
+
+#endif // #ifndef __ARENA_H__
@@ -0,0 +1,95 @@
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <stddef.h>
+#include "keys.h"
+#include "scene.h"
+
+/**
+ * The keys held down in one scene of a batch for a step, in the same layout
+ * as scene_key_data(): KeyEventTypes indexed by the arrow key values.
+ */
+typedef struct scene_input{
+    int keys[SCENE_KEYS];
+} SceneInput;
+
+/**
+ * A set of independent scenes stepped together, e.g. many games played
+ * headlessly by bots or for training, one scene per task on a worker pool.
+ * Scenes don't share any state, so each one ends up exactly where it would
+ * if it were ticked alone, whatever the number of threads.
+ *
+ * Each scene should tick on one thread (see scene_set_threads()), since the
+ * batch already keeps every thread busy with whole scenes.
+ */
+typedef struct scene_batch SceneBatch;
+
+/**
+ * Allocates an empty batch and starts the threads that step it.
+ * Asserts that the memory is allocated.
+ *
+ * @param threads the number of threads to step scenes on, counting the
+ *   thread that calls scene_batch_tick(); asserts that it is positive
+ * @return the new batch
+ */
+SceneBatch *scene_batch_init(size_t threads);
+
+/**
+ * Stops a batch's threads and releases it and all of its scenes.
+ *
+ * @param batch a pointer to a batch returned from scene_batch_init()
+ */
+void scene_batch_free(SceneBatch *batch);
+
+/**
+ * Adds a scene to a batch. The batch frees the scene when it is freed.
+ *
+ * @param batch a pointer to a batch returned from scene_batch_init()
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the scene's index in the batch, which stays the same until it is freed
+ */
+size_t scene_batch_add(SceneBatch *batch, Scene *scene);
+
+/**
+ * Gets the number of scenes in a batch.
+ *
+ * @param batch a pointer to a batch returned from scene_batch_init()
+ * @return the number of scenes added with scene_batch_add()
+ */
+size_t scene_batch_size(SceneBatch *batch);
+
+/**
+ * Gets a scene of a batch, e.g. to read its bodies between steps.
+ * Asserts that the index is valid.
+ *
+ * @param batch a pointer to a batch returned from scene_batch_init()
+ * @param index the index returned from scene_batch_add()
+ * @return the scene at that index
+ */
+Scene *scene_batch_get(SceneBatch *batch, size_t index);
+
+/**
+ * Frees a scene of a batch and puts another in its place, e.g. to restart
+ * a game that has finished. Asserts that the index is valid.
+ *
+ * @param batch a pointer to a batch returned from scene_batch_init()
+ * @param index the index returned from scene_batch_add()
+ * @param scene a pointer to a scene returned from scene_init()
+ */
+void scene_batch_replace(SceneBatch *batch, size_t index, Scene *scene);
+
+/**
+ * Ticks every scene of a batch a number of times, in parallel, and returns
+ * once all of them are done. Before each scene's first tick, its key data
+ * (see scene_key_data()) is set to its input; the keys stay held for all
+ * the ticks. Scenes' key handlers are not called.
+ *
+ * @param batch a pointer to a batch returned from scene_batch_init()
+ * @param inputs an input for each scene, by index, or NULL to keep the
+ *   scenes' key data as it is
+ * @param dt the time of each tick, passed to scene_tick()
+ * @param ticks the number of times to tick each scene
+ */
+void scene_batch_tick(SceneBatch *batch, const SceneInput *inputs, double dt, size_t ticks);
+
+#endif // #ifndef __BATCH_H__
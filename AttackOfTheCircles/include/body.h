@@ -4,21 +4,50 @@
 #include <stdbool.h>
 
 #include "color.h"
+#include "list.h"
 #include "polygon.h"
 
 /**
  * A rigid body constrained to the plane.
  * Implemented as a polygon with uniform density.
+ * The polygon is stored relative to the body's centroid and rotation,
+ * so moving a body only moves its centroid; the vertices are recomputed
+ * the next time the shape is requested.
  * Bodies can accumulate forces and impulses during each tick.
  * Angular physics (i.e. torques) are not currently implemented.
  */
 typedef struct body Body;
 
+/**
+ * A way of moving bodies through a tick from the forces and impulses on them.
+ * See body_integrate().
+ */
+typedef enum {
+    // Moves at the average of the velocities before and after the tick
+    INTEGRATOR_MIDPOINT,
+    // Updates the velocity, then moves at the new velocity. Symplectic.
+    INTEGRATOR_SEMI_IMPLICIT_EULER,
+    // Second-order and symplectic, so springs and orbits keep their energy
+    // at much larger dt than with the midpoint method
+    INTEGRATOR_VELOCITY_VERLET,
+    // Integrates the velocities of the last three ticks; allows varying dt
+    INTEGRATOR_MULTISTEP
+} Integrator;
+
+/**
+ * Contiguous storage for the state that ticking reads and writes every tick:
+ * each body's centroid, velocity, forces, impulses and mass, in one array
+ * per field (a structure of arrays). A Body is a handle to one entry.
+ * A new body has a store of its own; a scene moves the bodies added to it
+ * into the scene's store, at their slots, so it can tick them in one sweep.
+ */
+typedef struct body_store BodyStore;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
  */
-Body *body_init(List *shape, double mass, RGBColor color);
+Body *body_init(VectorList *shape, double mass, RGBColor color);
 
 /**
  * Allocates memory for a body with the given parameters.
@@ -34,7 +63,7 @@ Body *body_init(List *shape, double mass, RGBColor color);
  * @return a pointer to the newly allocated body
  */
 Body *body_init_with_info(
-    List *shape, double mass, RGBColor color, void *info, FreeFunc info_freer
+    VectorList *shape, double mass, RGBColor color, void *info, FreeFunc info_freer
 );
 
 /**
@@ -46,12 +75,67 @@ void body_free(Body *body);
 
 /**
  * Gets the current shape of a body.
- * Returns a newly allocated vector list, which must be list_free()d.
+ * Returns a newly allocated vector list, which must be vec_list_free()d.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the polygon describing the body's current position
+ */
+VectorList *body_get_shape(Body *body);
+
+/**
+ * Gets the current shape of a body without copying it.
+ * The returned list belongs to the body and must not be modified or freed.
+ * Its vertices are only valid until the body is next moved, rotated, ticked
+ * or freed, so callers that keep the shape should use body_get_shape().
  *
  * @param body a pointer to a body returned from body_init()
  * @return the polygon describing the body's current position
  */
-List *body_get_shape(Body *body);
+const VectorList *body_get_shape_view(Body *body);
+
+/**
+ * Remembers a body's current centroid and rotation, so that frames drawn
+ * before its next tick can blend from them with body_get_interpolated_shape().
+ * scene_step() calls this for every body before each tick.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_save_transform(Body *body);
+
+/**
+ * Gets a body's shape partway between its transform at the last
+ * body_save_transform() and its current one.
+ * If the body hasn't moved since then, was never saved, or alpha is at least 1,
+ * this is the same list as body_get_shape_view(). Otherwise the vertices are
+ * written into scratch, which grows to fit them, and scratch is returned.
+ * Either way, the result must not be modified or freed.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param alpha how far to blend, from 0 (the saved transform) to 1 (the current one)
+ * @param scratch a list to hold the blended vertices
+ * @return the polygon describing the body's blended position
+ */
+const VectorList *body_get_interpolated_shape(Body *body, double alpha, VectorList *scratch);
+
+/**
+ * Gets the kind of a body's shape, which is the kind of the list passed to
+ * body_init() (e.g. SHAPE_CIRCLE for a shape_circle()).
+ * A rotated SHAPE_AABB body is a SHAPE_POLYGON until its rotation is reset to 0.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the kind of the body's current shape
+ */
+ShapeKind body_get_shape_kind(Body *body);
+
+/**
+ * Checks whether a body's shape is convex.
+ * This is worked out once in body_init(), since moving and rotating
+ * a body never changes it, so it is cheap to call every frame.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body's shape is a convex polygon
+ */
+bool body_is_convex(Body *body);
 
 /**
  * Gets the current center of mass of a body.
@@ -158,9 +242,145 @@ void body_add_impulse(Body *body, Vector impulse);
  */
 void body_tick(Body *body, double dt);
 
+/**
+ * Updates the body after a given time interval has elapsed, like body_tick(),
+ * using the given integrator.
+ * Velocity Verlet and the multistep integrator keep some history, which is
+ * allocated on the body's first tick with them and freed with the body.
+ * The others need none. Integrators that keep history assume the forces come
+ * from the same system every tick, so a body should use one integrator.
+ *
+ * For constant forces and for impulses, velocity Verlet moves bodies exactly
+ * like body_tick(). Between ticks, its velocity is predicted from the last
+ * tick's forces, and the next tick corrects it.
+ *
+ * @param body the body to tick
+ * @param dt the number of seconds elapsed since the last tick
+ * @param integrator the integrator to use
+ */
+void body_integrate(Body *body, double dt, Integrator integrator);
+
+/**
+ * Allocates an empty body store.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return the new store, with room for no bodies
+ */
+BodyStore *body_store_init(void);
+
+/**
+ * Releases a body store. Any bodies in it must be freed first.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ */
+void body_store_free(BodyStore *store);
+
+/**
+ * Makes room for entries 0 to capacity - 1 in a store.
+ * New entries are at rest, with a mass of 1, so sweeps leave them alone.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param capacity the number of entries needed
+ */
+void body_store_reserve(BodyStore *store, size_t capacity);
+
+/**
+ * Moves a body's state to an entry of a store.
+ * The body's getters and setters use that entry from then on.
+ * Asserts that the body is still in the store it was created with, and that
+ * the entry is in range. The entry should not hold another live body.
+ * When the body is freed, its entry is left at rest.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param store the store to move the body into
+ * @param index the body's entry in the store
+ */
+void body_move_to_store(Body *body, BodyStore *store, size_t index);
+
+/**
+ * Ticks entries 0 to count - 1 of a store, like calling body_integrate() on
+ * each of their bodies, but in one pass over each array.
+ * Only works for integrators that keep no history (INTEGRATOR_MIDPOINT and
+ * INTEGRATOR_SEMI_IMPLICIT_EULER); asserts that the integrator is one of them.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param count the number of entries to tick
+ * @param dt the number of seconds elapsed since the last tick
+ * @param integrator the integrator to use
+ */
+void body_store_integrate(BodyStore *store, size_t count, double dt, Integrator integrator);
+
+/**
+ * Ticks entries start to end - 1 of a store, like body_store_integrate().
+ * Each entry only depends on itself, so calls for ranges that don't overlap
+ * can run on different threads at once.
+ *
+ * @param store a pointer to a store returned from body_store_init()
+ * @param start the first entry to tick
+ * @param end one past the last entry to tick
+ * @param dt the number of seconds elapsed since the last tick
+ * @param integrator the integrator to use
+ */
+void body_store_integrate_range(BodyStore *store, size_t start, size_t end,
+  double dt, Integrator integrator);
+
+/**
+ * A buffer for the forces and impulses added on one thread, so that force
+ * creators running on several threads at once don't race to add to the same
+ * body. While a log is recording on a thread, body_add_force() and
+ * body_add_impulse() on that thread add to the log instead of the body,
+ * and force_log_apply() adds them to the bodies afterwards.
+ */
+typedef struct force_log ForceLog;
+
+/**
+ * Allocates an empty force log.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return the new log
+ */
+ForceLog *force_log_init(void);
+
+/**
+ * Releases a force log, dropping anything it recorded.
+ *
+ * @param log a pointer to a log returned from force_log_init()
+ */
+void force_log_free(ForceLog *log);
+
+/**
+ * Makes body_add_force() and body_add_impulse() record into a log on the
+ * calling thread, until force_log_stop(). Asserts that no log is recording
+ * on the thread already. A log can record over several starts before it is
+ * applied, but only on one thread at a time.
+ *
+ * @param log a pointer to a log returned from force_log_init()
+ * @param sums_store if NULL, the log keeps every force and impulse, so
+ *   force_log_apply() adds them in the same order as adding them directly.
+ *   Otherwise, the forces and impulses on bodies in this store are summed
+ *   per body as they come, which takes less memory and time, but the sums
+ *   round differently. The store must not grow until the log is applied.
+ */
+void force_log_start(ForceLog *log, BodyStore *sums_store);
+
+/**
+ * Stops the log recording on the calling thread, if any.
+ */
+void force_log_stop(void);
+
+/**
+ * Adds the forces and impulses a log recorded to their bodies and empties
+ * the log. Asserts that no log is recording on the calling thread.
+ * The bodies must not have been freed since they were recorded.
+ *
+ * @param log a pointer to a log returned from force_log_init()
+ */
+void force_log_apply(ForceLog *log);
+
 /**
  * Marks a body for removal--future calls to body_is_removed() will return true.
- * Does not free the body.
+ * Does not free the body; a scene frees its removed bodies at the end of scene_tick().
  * If the body is already marked for removal, does nothing.
  *
  * @param body the body to mark for removal
@@ -177,6 +397,43 @@ void body_remove(Body *body);
  */
 bool body_is_removed(Body *body);
 
+/**
+ * Records where a scene keeps a body. Called by scene_add_body().
+ * If the body is already marked for removal, it is added to removed_queue right away.
+ *
+ * @param body the body in the scene
+ * @param slot the body's slot in the scene, which its BodyHandles refer to
+ * @param removed_queue the list body_remove() adds the body to,
+ *   so the scene finds removed bodies without checking every body
+ */
+void body_set_scene_slot(Body *body, size_t slot, List *removed_queue);
+
+/**
+ * Returns the slot passed to body_set_scene_slot().
+ *
+ * @param body the body to check
+ * @return the body's slot in its scene, or SIZE_MAX if it has not been added to one
+ */
+size_t body_get_scene_slot(Body *body);
+
+/**
+ * Returns the head of the scene's list of force handlers that use a body.
+ * The scene owns the list; the body only stores where it starts,
+ * so the scene can find a body's handlers without checking every handler.
+ *
+ * @param body the body to check
+ * @return the value last passed to body_set_handler_links(), initially NULL
+ */
+void *body_get_handler_links(Body *body);
+
+/**
+ * Sets the head of the scene's list of force handlers that use a body.
+ *
+ * @param body the body to update
+ * @param links the first link of the list, or NULL if it is empty
+ */
+void body_set_handler_links(Body *body, void *links);
+
 double body_radius(Body *body);
 
 void body_set_camera_attatchment(Body *body, bool val);
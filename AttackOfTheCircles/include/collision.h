@@ -2,8 +2,7 @@
 #define __COLLISION_H__
 
 #include <stdbool.h>
-#include "list.h"
-#include "vector.h"
+#include "vec_list.h"
 
 /**
  * Represents the status of a collision between two shapes.
@@ -19,6 +18,12 @@ typedef struct {
      * If collided is false, this value is undefined.
      */
     Vector axis;
+    /**
+     * If the shapes are colliding, how far they overlap along the axis,
+     * i.e. how far shape2 must move along it to stop touching shape1.
+     * If collided is false, this value is undefined.
+     */
+    double depth;
 } CollisionInfo;
 
 /**
@@ -26,12 +31,17 @@ typedef struct {
  * The shapes are given as lists of vertices in counterclockwise order.
  * There is an edge between each pair of consecutive vertices,
  * and one between the first vertex and the last vertex.
+ * Circles and axis-aligned boxes (see ShapeKind) are collided exactly;
+ * a circle is treated as the circle through its vertices.
+ * Other pairs use the separating axis theorem, stopping at the first edge
+ * normal that separates the shapes. Does not allocate.
  *
  * @param shape1 the first shape
  * @param shape2 the second shape
- * @return whether the shapes are colliding, and if so, the collision axis.
+ * @return whether the shapes are colliding, and if so, the collision axis
+ * and penetration depth.
  * The axis should be a unit vector pointing from shape1 towards shape2.
  */
-CollisionInfo find_collision(List *shape1, List *shape2);
+CollisionInfo find_collision(const VectorList *shape1, const VectorList *shape2);
 
 #endif // #ifndef __COLLISION_H__
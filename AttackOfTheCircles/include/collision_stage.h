@@ -0,0 +1,79 @@
+#ifndef __COLLISION_STAGE_H__
+#define __COLLISION_STAGE_H__
+
+#include "forces.h"
+
+/*
+ * A CollisionStage (declared in scene.h) is a scene-wide collision pass.
+ * Instead of registering one force creator per pair of bodies, handlers are
+ * registered once per pair of collision types. Every tick, a sweep-and-prune
+ * broad phase over the bodies' bounding circles (see body_radius()) finds the
+ * candidate pairs, and only those are run through find_collision().
+ */
+
+/**
+ * Maps a body to the collision type used to look up its handlers.
+ * Returns a negative number if the body should not collide with anything;
+ * bodies with types of num_types or more don't collide either.
+ */
+typedef int (*CollisionTyper)(Body *body);
+
+/**
+ * Allocates memory for an empty collision stage.
+ * Uses the current arena, if there is one (see arena_malloc()),
+ * so the stage must be freed before that arena is.
+ *
+ * @param num_types the number of collision types;
+ *   bodies collide if the typer returns values less than this
+ * @param typer a function giving the collision type of each body
+ * @return the new collision stage
+ */
+CollisionStage *collision_stage_init(size_t num_types, CollisionTyper typer);
+
+/**
+ * Releases the memory allocated for a collision stage
+ * and the auxiliary values of all its handlers.
+ *
+ * @param stage a pointer to a stage returned from collision_stage_init()
+ */
+void collision_stage_free(CollisionStage *stage);
+
+/**
+ * Registers a handler to be called whenever a body of type1
+ * and a body of type2 collide.
+ * The handler is always passed the body of type1 first, and the axis
+ * points from that body towards the body of type2.
+ * Like create_collision(), the handler is called with COLLISION_START
+ * on the first tick of contact, COLLISION_TOUCHING while the bodies
+ * stay in contact and COLLISION_END once they separate.
+ * Registering a second handler for the same pair of types replaces the first.
+ *
+ * @param stage a pointer to a stage returned from collision_stage_init()
+ * @param type1 the collision type of the first body passed to the handler
+ * @param type2 the collision type of the second body passed to the handler
+ * @param handler a function to call whenever the bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void collision_stage_add_handler(
+    CollisionStage *stage,
+    int type1,
+    int type2,
+    CollisionHandler handler,
+    void *aux,
+    FreeFunc freer
+);
+
+/**
+ * Finds all colliding pairs of bodies in a scene
+ * and calls the handlers registered for their types.
+ * Bodies that are marked for removal are ignored.
+ * This is called by scene_tick() after all the force creators have run,
+ * so it should not usually be called directly.
+ *
+ * @param stage a pointer to a stage returned from collision_stage_init()
+ * @param scene the scene whose bodies to collide
+ */
+void collision_stage_tick(CollisionStage *stage, Scene *scene);
+
+#endif // #ifndef __COLLISION_STAGE_H__
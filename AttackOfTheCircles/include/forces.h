@@ -4,6 +4,13 @@
 #include "powerups.h"
 #include "sdl_wrapper.h"
 
+/*
+ * The gravity, spring, drag and friction force creators only add forces to
+ * their bodies, so they are added with scene_add_parallel_force_creator().
+ * Collisions, player movement and enemy bullets change the game's state,
+ * so they always run on the thread that calls scene_tick().
+ */
+
 typedef enum {
     COLLISION_START,
     COLLISION_TOUCHING,
@@ -35,6 +42,27 @@ typedef void (*CollisionHandler)
  */
 void create_newtonian_gravity(Scene *scene, double G, Body *body1, Body *body2);
 
+/**
+ * Below this many bodies, create_scene_gravity() always computes every pair.
+ */
+#define SCENE_GRAVITY_MIN_TREE_BODIES 64
+
+/**
+ * Adds Newtonian gravity between every pair of bodies in a scene,
+ * including bodies added later, with a single force creator.
+ * This matches calling create_newtonian_gravity() once for each pair,
+ * but uses a Barnes-Hut quadtree to approximate distant groups of bodies.
+ * See quadtree_add_gravity() for how theta trades accuracy for speed;
+ * theta = 0.5 keeps forces within 1% (RMS) of the exact pairwise forces.
+ * When the tree is used, its walks are split between the scene's threads
+ * (see scene_set_threads()), with the same results as one thread.
+ *
+ * @param scene the scene containing the bodies
+ * @param G the gravitational proportionality constant
+ * @param theta the Barnes-Hut opening angle; 0 computes every pair exactly
+ */
+void create_scene_gravity(Scene *scene, double G, double theta);
+
 /**
  * Adds a Hooke's-Law spring force between two bodies in a scene.
  * See https://en.wikipedia.org/wiki/Hooke%27s_law.
@@ -120,6 +148,13 @@ void create_physics_collision(
  */
 void create_powerup_collision(Scene *scene, Body *player, Body *powerup);
 
+/*
+ * The collision handler used by create_powerup_collision().
+ * aux must be the scene containing the bodies.
+ */
+void apply_powerup(Body *player, Body *powerup, Vector axis, void *aux,
+  CollisionEventType type);
+
 //Vector add_one_bounce(Body *body1, Body *body2, Vector axis, void *aux);
 
 void add_bounce(Body *body1, Body *body2, Vector axis, void *aux, CollisionEventType type);
@@ -7,7 +7,6 @@
 
 void gen_forces(Scene *scene);
 void add_enemy_forces(Scene *scene, Body *enemy, Body *player);
-void add_bullet_forces(Scene *scene, Body *bullet);
 void add_boss_forces(Scene *scene, Body *boss);
 
 #endif
@@ -17,7 +17,8 @@ typedef enum{
   BULLET,
   BOSS,
   ENEMY_BULLET,
-  GUI_BULLET
+  GUI_BULLET,
+  NUM_BODY_TYPES
 } BODY_TYPE;
 
 typedef enum{
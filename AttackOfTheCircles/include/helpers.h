@@ -3,3 +3,6 @@
 
 List *get_bodies_type(Scene *scene, BODY_TYPE type);
 Body *get_first_body(Scene *scene, BODY_TYPE type);
+// Like get_bodies_type(), but only looks at bodies overlapping the box
+// from min to max (see scene_query_aabb())
+List *get_bodies_type_near(Scene *scene, BODY_TYPE type, Vector min, Vector max);
@@ -0,0 +1,41 @@
+#ifndef __KEYS_H__
+#define __KEYS_H__
+
+// Values passed to a key handler when the given arrow key is pressed
+#define LEFT_ARROW 1
+#define UP_ARROW 2
+#define RIGHT_ARROW 3
+#define DOWN_ARROW 4
+
+/**
+ * The number of entries in a scene's key data (see scene_key_data()),
+ * which is indexed by the arrow key values above; entry 0 is unused.
+ */
+#define SCENE_KEYS 5
+
+/**
+ * The possible types of key events.
+ * Enum types in C are much more primitive than in Java; this is equivalent to:
+ * typedef unsigned int KeyEventType;
+ * #define KEY_PRESSED 0
+ * #define KEY_RELEASED 1
+ */
+typedef enum {
+    KEY_PRESSED,
+    KEY_RELEASED
+} KeyEventType;
+
+/**
+ * A keypress handler.
+ * When a key is pressed or released, the handler is passed its char value.
+ * Most keys are passed as their char value, e.g. 'a', '1', or '\r'.
+ * Arrow keys have the special values listed above.
+ *
+ * @param key a character indicating which key was pressed
+ * @param type the type of key event (KEY_PRESSED or KEY_RELEASED)
+ * @param held_time if a press event, the time the key has been held in seconds
+ * @param data the auxiliary value the handler was registered with
+ */
+typedef void (*KeyHandler)(char key, KeyEventType type, double held_time, void* data);
+
+#endif // #ifndef __KEYS_H__
@@ -0,0 +1,80 @@
+#ifndef __LRU_CACHE_H__
+#define __LRU_CACHE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "list.h"
+
+/**
+ * A map from strings to values that holds at most a fixed number of values.
+ * Adding a value to a full cache evicts the least recently used one, e.g.
+ * the rendered text that hasn't been drawn for the longest, so a cache of
+ * things that are expensive to make keeps the ones that are used every frame.
+ * Lookups hash the key, so they take the same time however full the cache is.
+ */
+typedef struct lru_cache LruCache;
+
+/**
+ * Allocates an empty cache.
+ * Asserts that the memory is allocated.
+ *
+ * @param capacity the most values the cache holds; asserts that it is positive
+ * @param freer if non-NULL, a function to call on values when they are
+ *   evicted, replaced, or the cache is freed
+ * @return the new cache
+ */
+LruCache *lru_cache_init(size_t capacity, FreeFunc freer);
+
+/**
+ * Releases a cache and frees all of its values.
+ *
+ * @param cache a pointer to a cache returned from lru_cache_init()
+ */
+void lru_cache_free(LruCache *cache);
+
+/**
+ * Looks up a value, and marks it as the most recently used if it is found.
+ *
+ * @param cache a pointer to a cache returned from lru_cache_init()
+ * @param key the key the value was added with
+ * @return the value, or NULL if the cache doesn't hold the key
+ */
+void *lru_cache_get(LruCache *cache, const char *key);
+
+/**
+ * Adds a value to a cache as the most recently used one. Frees the value the
+ * key had, if any; otherwise evicts the least recently used value if the
+ * cache is full.
+ *
+ * @param cache a pointer to a cache returned from lru_cache_init()
+ * @param key the key to add the value with, which the cache copies
+ * @param value the value, which the cache frees when it is done with it
+ */
+void lru_cache_put(LruCache *cache, const char *key, void *value);
+
+/**
+ * Gets whether a cache holds a key, without changing which value is the
+ * least recently used.
+ *
+ * @param cache a pointer to a cache returned from lru_cache_init()
+ * @param key the key to look for
+ * @return whether the key was added and hasn't been evicted
+ */
+bool lru_cache_contains(LruCache *cache, const char *key);
+
+/**
+ * Gets the number of values in a cache.
+ *
+ * @param cache a pointer to a cache returned from lru_cache_init()
+ * @return the number of values, which is at most the cache's capacity
+ */
+size_t lru_cache_size(LruCache *cache);
+
+/**
+ * Frees all the values in a cache, leaving it empty.
+ *
+ * @param cache a pointer to a cache returned from lru_cache_init()
+ */
+void lru_cache_clear(LruCache *cache);
+
+#endif // #ifndef __LRU_CACHE_H__
@@ -1,6 +1,7 @@
 #ifndef __POLYGON_H__
 #define __POLYGON_H__
 
+#include <stdbool.h>
 #include "vec_list.h"
 
 /**
@@ -12,7 +13,7 @@
  * each pair of consecutive vertices, plus one between the first and last.
  * @return the area of the polygon
  */
-double polygon_area(List *polygon);
+double polygon_area(const VectorList *polygon);
 
 /**
  * Computes the center of mass of a polygon.
@@ -23,7 +24,7 @@ double polygon_area(List *polygon);
  * each pair of consecutive vertices, plus one between the first and last.
  * @return the centroid of the polygon
  */
-Vector polygon_centroid(List *polygon);
+Vector polygon_centroid(const VectorList *polygon);
 
 /**
  * Translates all vertices in a polygon by a given vector.
@@ -32,17 +33,29 @@ Vector polygon_centroid(List *polygon);
  * @param polygon the list of vertices that make up the polygon
  * @param translation the vector to add to each vertex's position
  */
-void polygon_translate(List *polygon, Vector translation);
+void polygon_translate(VectorList *polygon, Vector translation);
 
 /**
  * Rotates vertices in a polygon by a given angle about a given point.
  * Note: mutates the original polygon.
+ * A rotated SHAPE_AABB polygon becomes a SHAPE_POLYGON.
  *
  * @param polygon the list of vertices that make up the polygon
  * @param angle the angle to rotate the polygon, in radians.
  * A positive angle means counterclockwise.
  * @param point the point to rotate around
  */
-void polygon_rotate(List *polygon, double angle, Vector point);
+void polygon_rotate(VectorList *polygon, double angle, Vector point);
+
+/**
+ * Determines whether a polygon is convex, i.e. every turn along its edges
+ * goes the same way, so a fan of triangles from any vertex covers it exactly.
+ * Collinear vertices are allowed. Assumes the polygon doesn't cross itself.
+ *
+ * @param polygon the list of vertices that make up the polygon,
+ * listed in a counterclockwise or clockwise direction
+ * @return whether the polygon is convex
+ */
+bool polygon_is_convex(const VectorList *polygon);
 
 #endif // #ifndef __POLYGON_H__
@@ -0,0 +1,108 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+/**
+ * The number of shards each pool's free objects are split into.
+ * Each thread uses one shard, so up to this many threads can allocate
+ * and release objects of one pool at once without waiting for each other.
+ */
+#define POOL_SHARDS 32
+
+/**
+ * A share of a pool's free objects, used by the threads given its index.
+ * Shards are aligned to cache lines so threads don't slow each other down
+ * by writing to neighbouring shards.
+ */
+typedef struct pool_shard{
+    alignas(64) atomic_flag lock;
+    // The next object to hand out; each free object starts with a pointer to the next
+    void *free_list;
+    // The objects allocated minus the objects released through this shard,
+    // which is negative if its threads release objects others allocated
+    ptrdiff_t live;
+} PoolShard;
+
+/**
+ * A free list of fixed-size objects, carved out of larger chunks.
+ * Released objects are kept for the next pool_alloc() instead of being
+ * returned to malloc, so code that creates and destroys the same kind of
+ * object every frame (bodies, force handlers, ...) stops allocating once
+ * the pool has grown to the peak number of live objects.
+ *
+ * Pools are safe to use from several threads. Each thread takes and returns
+ * objects through its own shard of the free list, so threads only wait for
+ * each other if more than POOL_SHARDS of them share a pool, or when one runs
+ * out of free objects and takes another shard's before growing the pool.
+ *
+ * While an arena is current (see arena.h), pool_alloc() takes objects from
+ * the arena instead, and pool_release() leaves them for arena_free().
+ *
+ * A pool can be a global initialized with POOL_INIT(), which is never freed,
+ * or be created with pool_init() and released with pool_free().
+ * The fields are only public so that POOL_INIT() works.
+ */
+typedef struct pool{
+    size_t object_size;
+    // The chunks allocated so far; each one starts with a pointer to the next
+    void *chunks;
+    atomic_flag chunks_lock;
+    PoolShard shards[POOL_SHARDS];
+} Pool;
+
+/**
+ * Initializer for a global pool of objects of the given size, e.g.
+ * Pool BODY_POOL = POOL_INIT(sizeof(Body));
+ */
+#define POOL_INIT(size) {(size), NULL, ATOMIC_FLAG_INIT, {{ATOMIC_FLAG_INIT, NULL, 0}}}
+
+/**
+ * Allocates a pool of objects of the given size.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param object_size the size of each object, in bytes
+ * @return the new pool
+ */
+Pool *pool_init(size_t object_size);
+
+/**
+ * Frees a pool from pool_init() and every object it has handed out,
+ * whether or not they were released. No other thread may be using the pool.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ */
+void pool_free(Pool *pool);
+
+/**
+ * Gets an object from a pool, allocating a new chunk if none are free.
+ * If an arena is current on this thread, allocates from the arena instead.
+ * The object's contents are undefined, like malloc().
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param pool the pool to allocate from
+ * @return a pointer to object_size bytes, aligned for any type
+ */
+void *pool_alloc(Pool *pool);
+
+/**
+ * Returns an object to the pool it came from, like free().
+ * Does nothing if object is NULL or was allocated from an arena.
+ *
+ * @param pool the pool passed to pool_alloc()
+ * @param object an object returned from pool_alloc(pool)
+ */
+void pool_release(Pool *pool, void *object);
+
+/**
+ * Counts the objects handed out and not yet released.
+ * The count is only exact while no other thread is using the pool.
+ *
+ * @param pool the pool to check
+ * @return the number of live objects
+ */
+size_t pool_live(Pool *pool);
+
+#endif // #ifndef __POOL_H__
@@ -4,6 +4,13 @@
 #include "scene.h"
 #include "gen_levels.h"
 
-void add_random_velocity(Body *player);
+/**
+ * Gives the player an impulse of 2 to 5 times its velocity, picked at random
+ * from the scene's generator.
+ *
+ * @param scene the scene the player is in
+ * @param player the player's body
+ */
+void add_random_velocity(Scene *scene, Body *player);
 
 #endif // #ifndef __POWERUPS_H__
@@ -0,0 +1,85 @@
+#ifndef __QUADTREE_H__
+#define __QUADTREE_H__
+
+#include "body.h"
+
+/*
+ * A Quadtree groups bodies by position so that the gravity from a distant
+ * cluster can be approximated by a single point mass at the cluster's
+ * center of mass (the Barnes-Hut algorithm).
+ * The tree keeps its buffers between builds, so rebuilding it every tick
+ * does not allocate once it has grown to fit the scene.
+ */
+typedef struct quadtree Quadtree;
+
+/**
+ * Allocates memory for an empty quadtree.
+ *
+ * @return the new tree
+ */
+Quadtree *quadtree_init(void);
+
+/**
+ * Releases the memory allocated for a quadtree. Does not free the bodies.
+ *
+ * @param tree a pointer to a tree returned from quadtree_init()
+ */
+void quadtree_free(Quadtree *tree);
+
+/**
+ * Rebuilds a quadtree over the current positions of a list of bodies.
+ * Bodies that are marked for removal are left out.
+ *
+ * @param tree a pointer to a tree returned from quadtree_init()
+ * @param bodies a list of bodies
+ */
+void quadtree_build(Quadtree *tree, List *bodies);
+
+/**
+ * Applies Newtonian gravity between every pair of bodies in a quadtree
+ * with body_add_force(), using the same law as create_newtonian_gravity():
+ * pairs whose bounding circles (see body_radius()) overlap do not attract.
+ *
+ * A cell of the tree is treated as a point mass if its width divided by its
+ * distance from a body is less than theta and it cannot contain a body that
+ * overlaps that body. Otherwise it is opened and its children are visited.
+ * theta = 0 computes every pair exactly, in O(n^2) time.
+ * Larger values are faster (O(n log n)) but less accurate: with theta = 0.5
+ * the force on each body is within 1% (RMS over all bodies) of the exact force.
+ *
+ * @param tree a pointer to a tree returned from quadtree_init()
+ *   and built with quadtree_build()
+ * @param G the gravitational proportionality constant
+ * @param theta the opening angle
+ */
+void quadtree_add_gravity(Quadtree *tree, double G, double theta);
+
+/**
+ * Gets the number of bodies a quadtree was last built over,
+ * i.e. the bodies that were not marked for removal.
+ *
+ * @param tree a pointer to a tree returned from quadtree_init()
+ * @return the number of bodies in the tree
+ */
+size_t quadtree_bodies(Quadtree *tree);
+
+/**
+ * Applies the gravity on some of a quadtree's bodies, like
+ * quadtree_add_gravity() with theta > 0, but only to bodies start to end - 1
+ * in the order they were built from.
+ * Each body's force is summed in the same order as quadtree_add_gravity(),
+ * so the results are the same however the bodies are split into ranges.
+ * The tree is only read, so calls for ranges that don't overlap can run
+ * on different threads at once.
+ *
+ * @param tree a pointer to a tree returned from quadtree_init()
+ *   and built with quadtree_build()
+ * @param G the gravitational proportionality constant
+ * @param theta the opening angle; asserts that it is positive
+ * @param start the first body to apply gravity to
+ * @param end one past the last body; asserts that it is at most quadtree_bodies()
+ */
+void quadtree_add_gravity_range(Quadtree *tree, double G, double theta,
+  size_t start, size_t end);
+
+#endif // #ifndef __QUADTREE_H__
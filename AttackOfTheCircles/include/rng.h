@@ -0,0 +1,50 @@
+#ifndef __RNG_H__
+#define __RNG_H__
+
+#include <stdint.h>
+
+/**
+ * A pseudorandom number generator (SplitMix64) whose whole state is one
+ * integer, so each scene can own one instead of sharing rand()'s global
+ * state. Two generators seeded with the same value give the same numbers,
+ * whatever other generators are used in between or on other threads.
+ * The field is only public so that an Rng can be embedded in other structs.
+ */
+typedef struct rng{
+    uint64_t state;
+} Rng;
+
+/**
+ * Restarts a generator's sequence from a seed.
+ *
+ * @param rng the generator
+ * @param seed any value; the same seed always gives the same sequence
+ */
+void rng_seed(Rng *rng, uint64_t seed);
+
+/**
+ * Gets the next number in a generator's sequence.
+ *
+ * @param rng a generator seeded with rng_seed()
+ * @return a number uniformly distributed over all 64-bit values
+ */
+uint64_t rng_next(Rng *rng);
+
+/**
+ * Gets the next number in a generator's sequence as a double in [0, 1).
+ *
+ * @param rng a generator seeded with rng_seed()
+ * @return a number uniformly distributed over [0, 1), in steps of 2^-53
+ */
+double rng_double(Rng *rng);
+
+/**
+ * Gets the next number in a generator's sequence as an integer below a bound.
+ *
+ * @param rng a generator seeded with rng_seed()
+ * @param bound the number of possible values; asserts that it is positive
+ * @return a number in [0, bound)
+ */
+uint64_t rng_below(Rng *rng, uint64_t bound);
+
+#endif // #ifndef __RNG_H__
@@ -2,7 +2,10 @@
 #define __SCENE_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "body.h"
+#include "keys.h"
+#include "rng.h"
 
 /**
  * A collection of bodies and force creators.
@@ -13,6 +16,22 @@ typedef struct scene Scene;
 
 typedef struct force_handler ForceHandler;
 
+/**
+ * A reference to a body in a scene that stays safe to use after the body is freed.
+ * Each body gets a slot in its scene; the slot's generation changes when the body
+ * is reaped, so an old handle never refers to a later body in the same slot.
+ */
+typedef struct body_handle{
+    size_t slot;
+    size_t generation;
+} BodyHandle;
+
+/**
+ * A scene-wide collision pass that dispatches handlers by pairs of body types.
+ * See collision_stage.h.
+ */
+typedef struct collision_stage CollisionStage;
+
 /**
  * A function which adds some forces or impulses to bodies,
  * e.g. from collisions, gravity, or spring forces.
@@ -36,15 +55,81 @@ Scene *scene_init(void);
 /**
  * Releases memory allocated for a given scene
  * and all the bodies and force creators it contains.
+ * Everything allocated from the scene's arena is released at once.
  *
  * @param scene a pointer to a scene returned from scene_init()
  */
 void scene_free(Scene *scene);
 
+/**
+ * Turns the scene's arena on or off for this thread.
+ * While it is on, the bodies, shapes, infos, force creators and auxes created
+ * on this thread are bump-allocated from an arena that scene_free() releases
+ * in one shot, instead of being allocated and freed one by one (see arena.h).
+ * Objects created in the arena must not outlive the scene.
+ *
+ * Use it while generating a level. Leave it off while the scene is running,
+ * since objects removed from the scene only give their arena memory back
+ * when the whole scene is freed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param use whether to allocate from the scene's arena
+ */
+void scene_use_arena(Scene *scene, bool use);
+
 void scene_set_done(Scene* scene, bool done);
 
 bool scene_is_done(Scene *scene);
+/**
+ * Gets which arrow keys are held down in a scene, as an array of SCENE_KEYS
+ * KeyEventTypes indexed by the arrow key values (e.g. LEFT_ARROW).
+ * The player's movement reads it every tick; a key handler or a headless
+ * run writes it. All keys start released.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the scene's key data
+ */
 int* scene_key_data(Scene *scene);
+
+/**
+ * Sets the function that handles the key events sent to a scene, e.g. by
+ * sdl_is_done() while the scene is shown. Overwrites any existing handler.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param handler the function to call with each key event, or NULL for none
+ * @param aux an auxiliary value to pass to handler
+ */
+void scene_set_key_handler(Scene *scene, KeyHandler handler, void *aux);
+
+/**
+ * Sends a key event to a scene's key handler, if it has one.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param key a character indicating which key was pressed (see KeyHandler)
+ * @param type the type of key event (KEY_PRESSED or KEY_RELEASED)
+ * @param held_time if a press event, the time the key has been held in seconds
+ */
+void scene_handle_key(Scene *scene, char key, KeyEventType type, double held_time);
+
+/**
+ * Restarts the sequence of a scene's random numbers (see scene_rng()).
+ * New scenes all start from the same seed, so a headless run of a scene
+ * repeats exactly; seed it, e.g. from the time, for a different game each run.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param seed the seed to pass to rng_seed()
+ */
+void scene_seed(Scene *scene, uint64_t seed);
+
+/**
+ * Gets the generator that anything random in a scene should draw from,
+ * e.g. whether an enemy shoots this tick, instead of rand(), so scenes
+ * running on different threads don't share or disturb each other's numbers.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the scene's generator, which lives as long as the scene
+ */
+Rng *scene_rng(Scene *scene);
 //void scene_set_jump_count(Scene *scene, int jump_count);
 //void scene_add_one_jump(Scene *scene);
 //int scene_jump_count(Scene *scene);
@@ -56,6 +141,15 @@ int* scene_key_data(Scene *scene);
  */
 size_t scene_bodies(Scene *scene);
 
+/**
+ * Gets the number of force creators in a given scene.
+ * Each collision registered with create_collision() counts as one.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of force creators that scene_tick() will run
+ */
+size_t scene_force_handlers(Scene *scene);
+
 /**
  * Gets the body at a given index in a scene.
  * Asserts that the index is valid.
@@ -85,6 +179,25 @@ void scene_add_body(Scene *scene, Body *body);
  */
 void scene_remove_body(Scene *scene, size_t index);
 
+/**
+ * Gets a handle to a body in a scene.
+ * Asserts that the body was added to the scene and has not been reaped.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a body added with scene_add_body()
+ * @return a handle that scene_get_handle_body() turns back into the body
+ */
+BodyHandle scene_get_handle(Scene *scene, Body *body);
+
+/**
+ * Gets the body a handle refers to.
+ *
+ * @param scene the scene passed to scene_get_handle()
+ * @param handle a handle returned from scene_get_handle()
+ * @return the body, or NULL if it has been marked for removal
+ */
+Body *scene_get_handle_body(Scene *scene, BodyHandle handle);
+
 /**
  * @deprecated Use scene_add_bodies_force_creator() instead
  * so the scene knows which bodies the force creator depends on
@@ -112,12 +225,128 @@ void scene_add_bodies_force_creator(
     Scene *scene, ForceCreator forcer, void *aux, List *bodies, FreeFunc freer
 );
 
+/**
+ * Adds a force creator that may run at the same time as other parallel
+ * force creators, on the threads set by scene_set_threads(). Otherwise it
+ * works like scene_add_bodies_force_creator().
+ *
+ * The force creator must only read the bodies' state (centroids, velocities,
+ * masses, infos, ...) and write it through body_add_force() and
+ * body_add_impulse(). It must not remove bodies, add bodies or force
+ * creators, or write to anything shared with other force creators, e.g. a
+ * collision handler's game state.
+ * Forces added on other threads are buffered until the parallel creators
+ * that run together have all finished, so it must not read the forces either.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param forcer a force creator function
+ * @param aux an auxiliary value to pass to forcer when it is called
+ * @param bodies the list of bodies affected by the force creator; see
+ *   scene_add_bodies_force_creator()
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_parallel_force_creator(
+    Scene *scene, ForceCreator forcer, void *aux, List *bodies, FreeFunc freer
+);
+
+/**
+ * Counts the force creators that use a body, i.e. that were added with
+ * the body in their list of bodies and have not been removed.
+ * Takes time proportional to the body's force creators, not the scene's.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a body that may be in some force creators' lists
+ * @return the number of force creators that use the body
+ */
+size_t scene_body_force_handlers(Scene *scene, Body *body);
+
+/**
+ * Lists the force creators that use a body, newest first.
+ * See scene_body_force_handlers().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a body that may be in some force creators' lists
+ * @return a new list of the ForceHandlers; its freer is NULL
+ */
+List *scene_get_body_force_handlers(Scene *scene, Body *body);
+
+/**
+ * Removes every force creator that uses a body, without removing the body.
+ * The force creators stop running right away and are freed in the next scene_tick().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a body that may be in some force creators' lists
+ */
+void scene_remove_body_force_handlers(Scene *scene, Body *body);
+
+/**
+ * Gives a scene a collision stage to run every tick.
+ * The scene takes ownership of the stage and frees it in scene_free().
+ * Replaces (and frees) any stage the scene already had.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param stage a pointer to a stage returned from collision_stage_init()
+ */
+void scene_set_collision_stage(Scene *scene, CollisionStage *stage);
+
+/**
+ * Gets the collision stage of a scene.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the stage passed to scene_set_collision_stage(), or NULL if none
+ */
+CollisionStage *scene_get_collision_stage(Scene *scene);
+
+/**
+ * Finds the bodies whose bounding boxes (centroid plus or minus body_radius())
+ * overlap a rectangle, using the scene's spatial index.
+ * Bodies marked for removal are skipped.
+ * The index is refreshed by scene_add_body() and scene_tick(), so bodies
+ * moved with body_set_centroid() since the last tick may be missed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param min the bottom-left corner of the rectangle
+ * @param max the top-right corner of the rectangle
+ * @return a new list (which does not own its bodies) of the bodies found,
+ *   in the order they were added to the scene
+ */
+List *scene_query_aabb(Scene *scene, Vector min, Vector max);
+
+/**
+ * Finds the bodies whose bounding circles overlap a circle.
+ * See scene_query_aabb().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @return a new list of the bodies found, in the order they were added
+ */
+List *scene_query_radius(Scene *scene, Vector center, double radius);
+
+/**
+ * Finds the bodies whose bounding circles a ray passes through.
+ * See scene_query_aabb().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param origin the start of the ray
+ * @param direction the direction of the ray (need not be normalized)
+ * @param max_distance how far along the ray to look
+ * @return a new list of the bodies found, nearest first
+ */
+List *scene_query_ray(Scene *scene, Vector origin, Vector direction, double max_distance);
+
 /**
  * Executes a tick of a given scene over a small time interval.
- * This requires executing all the force creators
- * and then ticking each body (see body_tick()).
+ * This requires executing all the force creators, then the collision stage
+ * (if any), and then ticking each body with the scene's integrator
+ * (see body_integrate()).
  * If any bodies are marked for removal, they should be removed from the scene
  * and freed, along with any force creators acting on them.
+ * Force creators of bodies removed before the tick are not run, but bodies
+ * removed during the tick stay until it ends, so every other force creator
+ * runs, even if a force creator before it removed its bodies.
+ * Removal keeps the order of the remaining bodies and force creators,
+ * and costs one pass over each list per tick, however many are removed.
  *
  * @param scene a pointer to a scene returned from scene_init()
  * @param dt the time elapsed since the last tick, in seconds
@@ -127,6 +356,132 @@ typedef Vector (*CameraFollower)(void *aux);
 
 void scene_tick(Scene *scene, double dt);
 
+/**
+ * Sets the integrator that scene_tick() moves the scene's bodies with.
+ * New scenes use INTEGRATOR_MIDPOINT, like body_tick().
+ * Set it before the first tick; see body_integrate().
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param integrator the integrator to use
+ */
+void scene_set_integrator(Scene *scene, Integrator integrator);
+
+/**
+ * Gets the integrator that scene_tick() moves the scene's bodies with.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the integrator passed to scene_set_integrator()
+ */
+Integrator scene_get_integrator(Scene *scene);
+
+/**
+ * Sets how many threads scene_tick() may use, counting the calling thread.
+ * With more than one, scene_tick() runs enough parallel force creators in a
+ * row (see scene_add_parallel_force_creator()) on several threads at once,
+ * splits ticking the bodies between the threads when there are enough
+ * bodies, and lets force creators split their own work with
+ * scene_parallel_for(). Everything else still runs on the calling thread,
+ * in the same order as with one thread.
+ * New scenes use one thread.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param threads the number of threads; asserts that it is positive
+ */
+void scene_set_threads(Scene *scene, size_t threads);
+
+/**
+ * Gets the number of threads scene_tick() may use.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number passed to scene_set_threads()
+ */
+size_t scene_get_threads(Scene *scene);
+
+/**
+ * Sets whether ticks on several threads must move the bodies exactly like
+ * ticks on one thread. New scenes are deterministic.
+ * A deterministic scene keeps every force and impulse its parallel force
+ * creators add, and adds them to the bodies in the order one thread would.
+ * Otherwise, each thread sums the forces on each body as they come, and the
+ * sums are added afterwards, which is faster for scenes with many force
+ * creators but rounds differently, so the bodies drift apart from a
+ * single-threaded run over time.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param deterministic whether to match a single-threaded run exactly
+ */
+void scene_set_deterministic(Scene *scene, bool deterministic);
+
+/**
+ * A function that does part of some work split by scene_parallel_for(),
+ * namely the items from start to end - 1.
+ * Takes in the auxiliary value passed to scene_parallel_for().
+ */
+typedef void (*RangeTask)(void *aux, size_t start, size_t end);
+
+/**
+ * Splits items 0 to count - 1 into ranges and runs task on each, using the
+ * scene's threads (see scene_set_threads()). With one thread, runs
+ * task(aux, 0, count). Returns once every range is done.
+ * Meant for force creators that do a lot of independent work each tick,
+ * e.g. create_scene_gravity(). Tasks for different ranges may run at once,
+ * so each range's work must only write to state that no other range uses;
+ * body_add_force() is safe when no two ranges add to the same body.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param count the number of items
+ * @param task the function to run on each range of items
+ * @param aux an auxiliary value to pass to task
+ */
+void scene_parallel_for(Scene *scene, size_t count, RangeTask task, void *aux);
+
+/**
+ * Sets the length of the ticks that scene_step() runs, and how many it may run
+ * per call. New scenes tick every 1/120 s, up to 8 times per call.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param dt the length of each tick, in seconds
+ * @param max_substeps the most ticks one scene_step() may run
+ */
+void scene_set_fixed_step(Scene *scene, double dt, size_t max_substeps);
+
+/**
+ * Advances a scene by some wall-clock time in ticks of a fixed length,
+ * so the physics doesn't depend on the frame rate.
+ * The elapsed time is added to an accumulator, and a tick is run for each
+ * whole fixed dt in it; the remainder carries over to the next call.
+ * Before each tick, every body's transform is saved (see body_save_transform()),
+ * so frames can blend from the previous tick to the current one
+ * (see scene_get_interpolation_alpha()).
+ * If more than max_substeps ticks are due, e.g. after a long stall, the rest
+ * are dropped and the scene falls behind the clock instead of trying to catch up.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param elapsed the wall-clock time since the last call, in seconds
+ * @return the number of ticks run
+ */
+size_t scene_step(Scene *scene, double elapsed);
+
+/**
+ * Gets how far a frame drawn now should blend each body from its saved
+ * transform to its current one: the time left over in scene_step()'s
+ * accumulator, as a fraction of the fixed dt.
+ * It is 1 after a direct scene_tick(), so frames show the current state.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return a number from 0 to 1
+ */
+double scene_get_interpolation_alpha(Scene *scene);
+
+/**
+ * Gets the camera position blended like the bodies,
+ * from its position before the last tick to its current one.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the camera position to draw the current frame with
+ */
+Vector scene_get_interpolated_camera(Scene *scene);
+
 void scene_set_camera(Scene *scene, Vector camera);
 
 void scene_move_camera(Scene *scene, Vector shift);
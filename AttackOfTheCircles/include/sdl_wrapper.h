@@ -2,51 +2,84 @@
 #define __SDL_WRAPPER_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <SDL2/SDL_pixels.h>
 #include "color.h"
 #include "list.h"
+#include "keys.h"
 #include "scene.h"
 #include "vector.h"
 
-// Values passed to a key handler when the given arrow key is pressed
-#define LEFT_ARROW 1
-#define UP_ARROW 2
-#define RIGHT_ARROW 3
-#define DOWN_ARROW 4
-
-/**
- * The possible types of key events.
- * Enum types in C are much more primitive than in Java; this is equivalent to:
- * typedef unsigned int KeyEventType;
- * #define KEY_PRESSED 0
- * #define KEY_RELEASED 1
+/*
+ * The wrapper only keeps global state for the program's one window (or
+ * offscreen image, see sdl_init_offscreen()): the SDL window and renderer,
+ * the view size, key timing and the frame clock.
+ * Everything that belongs to a scene (its camera, its key handler) is read
+ * from the scene passed in, so scenes that are never shown, e.g. headless
+ * runs on other threads, don't touch the wrapper at all.
  */
-typedef enum {
-    KEY_PRESSED,
-    KEY_RELEASED
-} KeyEventType;
 
 /**
- * A keypress handler.
- * When a key is pressed or released, the handler is passed its char value.
- * Most keys are passed as their char value, e.g. 'a', '1', or '\r'.
- * Arrow keys have the special values listed above.
+ * Initializes the SDL window and renderer.
+ * Must be called once before any of the other SDL functions.
  *
- * @param key a character indicating which key was pressed
- * @param type the type of key event (KEY_PRESSED or KEY_RELEASED)
- * @param held_time if a press event, the time the key has been held in seconds
+ * @param min the x and y coordinates of the bottom left of the scene
+ * @param max the x and y coordinates of the top right of the scene
  */
-typedef void (*KeyHandler)(char key, KeyEventType type, double held_time, void* data);
+void sdl_init(Vector min, Vector max);
 
 /**
- * Initializes the SDL window and renderer.
- * Must be called once before any of the other SDL functions.
+ * Initializes a renderer that draws to an image in memory instead of a
+ * window, e.g. to benchmark rendering or compare frames of a level with
+ * saved ones on a machine without a display.
+ * Must be called once, instead of sdl_init(), before any of the other SDL
+ * functions. Everything draws as it would to a window of the same size;
+ * read the frames with sdl_read_frame() or sdl_write_ppm().
+ * sdl_is_done() never reports the image as closed, and sends no key events.
  *
  * @param min the x and y coordinates of the bottom left of the scene
  * @param max the x and y coordinates of the top right of the scene
+ * @param width the width of the image, in pixels
+ * @param height the height of the image, in pixels
  */
-void sdl_init(Vector min, Vector max);
+void sdl_init_offscreen(Vector min, Vector max, int width, int height);
+
+/**
+ * A font at one point size, opened once by sdl_get_font().
+ */
+typedef struct font Font;
+
+/**
+ * Gets the font for a file and point size, opening it the first time.
+ * The font stays open until the window is closed, so callers can keep the
+ * handle instead of looking it up every frame.
+ *
+ * @param file the path of a TrueType font file
+ * @param ptsize the point size to render the font at
+ * @return the font; text drawn with it is skipped if the file couldn't be opened
+ */
+Font *sdl_get_font(const char *file, int ptsize);
 
+/**
+ * Draws text stretched to fill a rectangle of the window.
+ * The rendered text is cached by font, color and text, and the least
+ * recently drawn texts are dropped once the cache is full, so text that
+ * is drawn every frame is only rendered once.
+ *
+ * @param font a font returned from sdl_get_font()
+ * @param text the UTF-8 text to draw
+ * @param color the color of the text
+ * @param top_left_corner the window position of the rectangle's top left, in pixels
+ * @param width the width of the rectangle, in pixels
+ * @param height the height of the rectangle, in pixels
+ */
+void sdl_draw_text(Font *font, const char *text, SDL_Color color,
+  Vector top_left_corner, double width, double height);
+
+/**
+ * Draws text in the font from a file, like
+ * sdl_draw_text(sdl_get_font(file, ptsize), ...).
+ */
 void write_font(const char* file, int ptsize, const char* text, SDL_Color color,
   Vector top_left_corner, double width, double height);
 
@@ -62,25 +95,75 @@ Vector get_max(void);
 
 /**
  * Processes all SDL events and returns whether the window has been closed.
- * This function must be called in order to handle keypresses.
-
+ * This function must be called in order to handle keypresses, which are
+ * passed to the scene's key handler (see scene_set_key_handler()).
+ *
+ * Example:
+ * ```
+ * void on_key(char key, KeyEventType type, double held_time, void *data) {
+ *     if (type == KEY_PRESSED && key == UP_ARROW) {
+ *         puts("UP pressed");
+ *     }
+ * }
+ * int main(int argc, char **argv) {
+ *     Scene *scene = scene_init();
+ *     scene_set_key_handler(scene, on_key, NULL);
+ *     while (!sdl_is_done(scene));
+ * }
+ * ```
  *
+ * @param scene the scene being shown, or NULL to drop key events
  * @return true if the window was closed, false otherwise
  */
-bool sdl_is_done(void);
+bool sdl_is_done(Scene *scene);
 
 /**
  * Clears the screen. Should be called before drawing polygons in each frame.
  */
 void sdl_clear(void);
 
+/**
+ * The ways sdl_draw_polygon() can fill polygons.
+ */
+typedef enum {
+    /**
+     * Queues convex polygons as fans of triangles and draws everything
+     * queued with one SDL_RenderGeometry() call when the frame is shown,
+     * text is drawn, or a concave polygon has to be filled with SDL2_gfx.
+     * The default. Falls back to RENDER_GFX if the renderer can't draw geometry.
+     */
+    RENDER_GEOMETRY,
+    /**
+     * Fills each polygon on the CPU with SDL2_gfx's filledPolygonRGBA().
+     */
+    RENDER_GFX
+} RenderBackend;
+
+/**
+ * Sets how polygons are filled from now on, drawing anything already queued.
+ *
+ * @param backend the way to fill polygons
+ */
+void sdl_set_render_backend(RenderBackend backend);
+
+/**
+ * Gets how polygons are filled.
+ *
+ * @return the backend set by sdl_set_render_backend(), or RENDER_GFX if
+ *   RENDER_GEOMETRY isn't supported by the renderer
+ */
+RenderBackend sdl_get_render_backend(void);
+
 /**
  * Draws a polygon from the given list of vertices and a color.
+ * With RENDER_GEOMETRY, the polygon may only appear once sdl_show() is called.
  *
  * @param points the list of vertices of the polygon
  * @param color the color used to fill in the polygon
+ * @param camera the offset of the view from the scene's coordinates,
+ *   e.g. a scene's camera (see scene_get_camera()), or VEC_ZERO
  */
-void sdl_draw_polygon(List *points, RGBColor color, bool draw_camera);
+void sdl_draw_polygon(const VectorList *points, RGBColor color, Vector camera);
 
 /**
  * Displays the rendered frame on the SDL window.
@@ -89,7 +172,53 @@ void sdl_draw_polygon(List *points, RGBColor color, bool draw_camera);
 void sdl_show(void);
 
 /**
- * Draws all bodies in a scene.
+ * Gets the size of the frames being drawn: the window's or the offscreen image's.
+ *
+ * @param width set to the frames' width, in pixels
+ * @param height set to the frames' height, in pixels
+ */
+void sdl_get_frame_size(int *width, int *height);
+
+/**
+ * Copies the frame drawn so far, e.g. after sdl_render_scene(), as rows of
+ * 8-bit red, green and blue values from the top left, with no padding.
+ *
+ * @param pixels room for 3 * width * height bytes (see sdl_get_frame_size())
+ */
+void sdl_read_frame(uint8_t *pixels);
+
+/**
+ * Writes the frame drawn so far to a binary PPM image file,
+ * which most image viewers and converters read.
+ *
+ * @param path the file to write, which is replaced if it exists
+ * @return whether the whole file was written
+ */
+bool sdl_write_ppm(const char *path);
+
+/**
+ * What a frame drew: how many of a scene's bodies were drawn as polygons,
+ * shown through the static layer's cached tiles, or skipped because their
+ * bounding boxes (see body_radius()) were outside the window, and how many
+ * tiles had to be drawn.
+ */
+typedef struct render_stats {
+    size_t drawn;
+    size_t cached;
+    size_t skipped;
+    size_t tiles_drawn;
+} RenderStats;
+
+/**
+ * Draws all bodies in a scene that overlap the window.
+ * The bodies are found with scene_query_aabb() around the view, so bodies
+ * far offscreen cost nothing, however long the level is.
+ * Static bodies (camera-attached, infinite mass and not moving, e.g. floors)
+ * are drawn underneath the others, from a layer of cached tiles that are
+ * only redrawn when they come into view or their static bodies change
+ * (see sdl_set_static_layer()).
+ * Bodies and the camera are blended between the scene's last two ticks
+ * by scene_get_interpolation_alpha(), so frames between ticks stay smooth.
  * This internally calls sdl_clear(), sdl_draw_polygon(), and sdl_show(),
  * so those functions should not be called directly.
  *
@@ -98,38 +227,29 @@ void sdl_show(void);
 void sdl_render_scene(Scene *scene);
 
 /**
- * Registers a function to be called every time a key is pressed.
- * Overwrites any existing handler.
- *
- * Example:
- * ```
- * void on_key(char key, KeyEventType type, double held_time) {
- *     if (type == KEY_PRESSED) {
- *         switch (key) {
- *             case 'a':
- *                 puts("A pressed");
- *                 break;
- *             case UP_ARROW:
- *                 puts("UP pressed");
- *                 break;
- *         }
- *     }
- * }
- * int main(int argc, char **argv) {
- *     sdl_on_key(on_key);
- *     while (!sdl_is_done());
- * }
- * ```
+ * Sets whether sdl_render_scene() draws static bodies through cached tiles.
+ * It does by default, unless the renderer can't draw to textures.
+ * Drawing every body every frame is slower, but keeps the order they were
+ * added in, which matters if static and moving bodies overlap.
  *
- * @param handler the function to call with each key press
+ * @param enabled whether to use the static layer
  */
-void sdl_on_key(KeyHandler handler, void *data);
+void sdl_set_static_layer(bool enabled);
 
-void sdl_set_camera(Vector camera_pos);
+/**
+ * Gets how many bodies the last call to sdl_render_scene() drew and skipped,
+ * e.g. to check that a level's offscreen bodies are culled.
+ *
+ * @return the counts, which are 0 before the first frame
+ */
+RenderStats sdl_get_render_stats(void);
 
 /**
  * Gets the amount of time that has passed since the last time
  * this function was called, in seconds.
+ * Uses a monotonic wall clock, and returns 0 the first time it is called.
+ * The clock times the window's frames, so it is shared by the whole program;
+ * headless runs should step their scenes by fixed amounts instead.
  *
  * @return the number of seconds that have elapsed
  */
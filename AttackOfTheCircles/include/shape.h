@@ -2,23 +2,28 @@
 #define __SHAPE_H__
 
 #include <stdbool.h>
-#include "list.h"
-
 #include "vector.h"
 #include "vec_list.h"
 #include "polygon.h"
 #include "color.h"
+#include "rng.h"
 
 
-List *shape_star(int num_spokes, double radius, double ld, double sd);
-List *shape_estrella(double radius);
-List *shape_partial_circle(double radius, int num_vertices, double proportion);
-List *shape_circle(double radius, int num_vertices);
-List *shape_regular_star(int num_spokes, double scale);
-List *shape_rectangle(double width, double height);
-List *shape_triangle(double radius);
+VectorList *shape_star(int num_spokes, double radius, double ld, double sd);
+VectorList *shape_estrella(double radius);
+VectorList *shape_partial_circle(double radius, int num_vertices, double proportion);
+VectorList *shape_circle(double radius, int num_vertices);
+VectorList *shape_regular_star(int num_spokes, double scale);
+VectorList *shape_rectangle(double width, double height);
+VectorList *shape_triangle(double radius);
 
-RGBColor gen_color();
+/**
+ * Picks a random color.
+ *
+ * @param rng the generator to draw from, e.g. scene_rng()
+ * @return a color with each component uniform in [0, 1)
+ */
+RGBColor gen_color(Rng *rng);
 
 
 #endif
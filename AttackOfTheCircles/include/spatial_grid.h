@@ -0,0 +1,100 @@
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#include "body.h"
+
+/*
+ * A SpatialGrid is a uniform hash grid over bodies' bounding boxes
+ * (their centroid plus or minus body_radius()).
+ * Each body is filed under every cell its box overlaps, and the cells are
+ * hashed into a fixed number of buckets, so the grid covers unbounded levels.
+ * Bodies spanning too many cells (e.g. long floors) are kept in a separate
+ * list that every query checks.
+ * Each scene owns one; use scene_query_aabb() and friends rather than
+ * calling this directly.
+ */
+typedef struct spatial_grid SpatialGrid;
+
+/**
+ * A body's entry in a spatial grid.
+ */
+typedef struct grid_proxy GridProxy;
+
+/**
+ * Allocates memory for an empty spatial grid.
+ *
+ * @param cell_size the width and height of each cell
+ * @return the new grid
+ */
+SpatialGrid *spatial_grid_init(double cell_size);
+
+/**
+ * Releases the memory allocated for a spatial grid and all its proxies.
+ * Does not free the bodies.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ */
+void spatial_grid_free(SpatialGrid *grid);
+
+/**
+ * Adds a body to a spatial grid at its current position.
+ * Queries return bodies in the order they were inserted.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param body the body to insert
+ * @return the body's proxy, needed to update or remove it
+ */
+GridProxy *spatial_grid_insert(SpatialGrid *grid, Body *body);
+
+/**
+ * Refiles a body after it has moved.
+ * Only touches the buckets if the body's box now covers different cells.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param proxy a proxy returned from spatial_grid_insert()
+ */
+void spatial_grid_update(SpatialGrid *grid, GridProxy *proxy);
+
+/**
+ * Removes a body from a spatial grid and frees its proxy.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param proxy a proxy returned from spatial_grid_insert()
+ */
+void spatial_grid_remove(SpatialGrid *grid, GridProxy *proxy);
+
+/**
+ * Finds the bodies whose bounding boxes overlap a rectangle.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param min the bottom-left corner of the rectangle
+ * @param max the top-right corner of the rectangle
+ * @param results a list (with a NULL freer) to append the bodies to
+ */
+void spatial_grid_query_aabb(SpatialGrid *grid, Vector min, Vector max, List *results);
+
+/**
+ * Finds the bodies whose bounding circles overlap a circle.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param results a list (with a NULL freer) to append the bodies to
+ */
+void spatial_grid_query_radius(SpatialGrid *grid, Vector center, double radius,
+  List *results);
+
+/**
+ * Finds the bodies whose bounding circles a ray passes through,
+ * ordered from nearest to furthest along the ray.
+ *
+ * @param grid a pointer to a grid returned from spatial_grid_init()
+ * @param origin the start of the ray
+ * @param direction the direction of the ray (need not be normalized)
+ * @param max_distance how far along the ray to look
+ * @param results a list (with a NULL freer) to append the bodies to
+ */
+void spatial_grid_query_ray(SpatialGrid *grid, Vector origin, Vector direction,
+  double max_distance, List *results);
+
+#endif // #ifndef __SPATIAL_GRID_H__
@@ -0,0 +1,119 @@
+#ifndef __VEC_BATCH_H__
+#define __VEC_BATCH_H__
+
+#include <stddef.h>
+#include "vector.h"
+
+/**
+ * Kernels that apply the vec_*() operations to whole arrays of vectors,
+ * e.g. a polygon's vertices or the velocities in a BodyStore.
+ *
+ * Each kernel has a portable version, named with a "_scalar" suffix, and an
+ * unsuffixed version that uses SIMD instructions when the compiler targets
+ * them. The instruction set is picked at compile time: AVX (two vectors per
+ * instruction) if it is enabled, e.g. by "make MODE=release" on a CPU with
+ * AVX2, then SSE2 (one vector per instruction, which every x86-64 CPU has),
+ * and otherwise the scalar versions.
+ *
+ * The SIMD versions do the same floating-point operations in the same order
+ * as the scalar ones, so they give identical results, except for
+ * vec_batch_shoelace(), whose AVX version sums the edges in a different order.
+ */
+
+/**
+ * Gets the instruction set the unsuffixed kernels were compiled for.
+ *
+ * @return "avx", "sse2" or "scalar"
+ */
+const char *vec_batch_instruction_set(void);
+
+/**
+ * Adds a vector to each of n vectors: out[i] = in[i] + translation.
+ * out may be the same array as in.
+ *
+ * @param out the array to write the n results to
+ * @param in the array of n vectors to translate
+ * @param n the number of vectors
+ * @param translation the vector to add
+ */
+void vec_batch_translate(Vector *out, const Vector *in, size_t n, Vector translation);
+void vec_batch_translate_scalar(Vector *out, const Vector *in, size_t n, Vector translation);
+
+/**
+ * Rotates each of n vectors about a pivot, then moves it:
+ * out[i] = vec_rotate(in[i] - pivot, angle) + offset.
+ * Pass offset = pivot to rotate in place about the pivot.
+ * out may be the same array as in.
+ *
+ * @param out the array to write the n results to
+ * @param in the array of n vectors to rotate
+ * @param n the number of vectors
+ * @param cos_angle the cosine of the angle to rotate by (counterclockwise)
+ * @param sin_angle the sine of the angle
+ * @param pivot the point to rotate about
+ * @param offset where the pivot ends up
+ */
+void vec_batch_rotate(Vector *out, const Vector *in, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset);
+void vec_batch_rotate_scalar(Vector *out, const Vector *in, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset);
+
+/**
+ * Finds the smallest and largest dot products of n vectors with an axis,
+ * i.e. the interval a shape's vertices cover when projected onto the axis.
+ *
+ * @param in the array of n vectors
+ * @param n the number of vectors; if it is 0, *min is INFINITY and *max is -INFINITY
+ * @param axis the axis to project onto (need not be normalized)
+ * @param min where to store the smallest vec_dot(in[i], axis)
+ * @param max where to store the largest vec_dot(in[i], axis)
+ */
+void vec_batch_project(const Vector *in, size_t n, Vector axis, double *min, double *max);
+void vec_batch_project_scalar(const Vector *in, size_t n, Vector axis, double *min, double *max);
+
+/**
+ * Sums the shoelace formula over the edges of a polygon, from each vertex to
+ * the next and from the last back to the first.
+ * See https://en.wikipedia.org/wiki/Shoelace_formula.
+ *
+ * @param in the polygon's n vertices
+ * @param n the number of vertices
+ * @param moment if non-NULL, where to store the sum over the edges of
+ *   vec_cross(v1, v2) * (v1 + v2), which is 6 * area * centroid
+ * @return the sum over the edges of vec_cross(v1, v2), which is twice the
+ *   signed area
+ */
+double vec_batch_shoelace(const Vector *in, size_t n, Vector *moment);
+double vec_batch_shoelace_scalar(const Vector *in, size_t n, Vector *moment);
+
+/**
+ * Ticks n bodies' kinematic state with the midpoint method (see body_tick()):
+ * applies the impulses and the forces over dt to the velocities, moves the
+ * centroids at the average of the old and new velocities, and clears the
+ * forces and impulses.
+ *
+ * @param centroid the n centroids
+ * @param velocity the n velocities
+ * @param forces the n net forces
+ * @param impulses the n net impulses
+ * @param mass the n masses
+ * @param n the number of bodies
+ * @param dt the length of the tick, in seconds
+ */
+void vec_batch_integrate_midpoint(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt);
+void vec_batch_integrate_midpoint_scalar(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt);
+
+/**
+ * Ticks n bodies' kinematic state with semi-implicit Euler: applies the
+ * impulses and forces to the velocities, then moves the centroids at the new
+ * velocities. Clears the forces and impulses.
+ * Takes the same arguments as vec_batch_integrate_midpoint().
+ */
+void vec_batch_integrate_euler(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt);
+void vec_batch_integrate_euler_scalar(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt);
+
+#endif // #ifndef __VEC_BATCH_H__
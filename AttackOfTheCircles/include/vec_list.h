@@ -3,22 +3,37 @@
 
 #include <stddef.h>
 #include "vector.h"
-#include "list.h"
 
 /**
  * A growable array of vectors.
- * This line does two things:
- * - Declares a "struct vec_list" type
- * - Makes "VectorList" an alias for "struct vec_list"
+ * The vectors are stored inline in one contiguous array, so walking a
+ * polygon's vertices does not chase a pointer per vertex and adding a vertex
+ * only allocates when the array has to grow.
  *
- * You will need to implement this struct type in list.c.
+ * The fields are public so that tight loops (e.g. projecting a shape onto an
+ * axis) can read data[0] to data[size - 1] directly; everything else should
+ * go through the vec_list_*() functions below.
  */
+typedef struct vec_list{
+    Vector *data;
+    size_t size;
+    size_t capacity;
+    /** What the vertices are known to describe when used as a polygon */
+    enum shape_kind{
+        /** A convex polygon with no further structure */
+        SHAPE_POLYGON,
+        /** A regular polygon from shape_circle(), collided as a true circle */
+        SHAPE_CIRCLE,
+        /** A rectangle from shape_rectangle() whose edges are axis-aligned */
+        SHAPE_AABB
+    } kind;
+} VectorList;
 
- typedef List VectorList;
+typedef enum shape_kind ShapeKind;
 
 /**
  * Allocates memory for a new list with space for the given number of elements.
- * The list is initially empty.
+ * The list is initially empty, with kind SHAPE_POLYGON.
  * Should cause an assertion failure if the required memory cannot be allocated.
  *
  * @param initial_size the number of vectors to allocate space for
@@ -40,7 +55,7 @@ void vec_list_free(VectorList *list);
  * @param list a pointer to a list returned from vec_list_init()
  * @return the number of vectors in the list
  */
-size_t vec_list_size(VectorList *list);
+size_t vec_list_size(const VectorList *list);
 
 /**
  * Gets the element at a given index in a list.
@@ -50,12 +65,13 @@ size_t vec_list_size(VectorList *list);
  * @param index an index in the list (the first element is at 0)
  * @return the vector at the given index
  */
-Vector vec_list_get(VectorList *list, size_t index);
+Vector vec_list_get(const VectorList *list, size_t index);
 
 /**
  * Sets the element at a given index in a list.
  * Cannot be used to extend the list.
  * Should cause an assertion failure if the index is out of bounds.
+ * Resets the list's kind to SHAPE_POLYGON.
  *
  * @param list a pointer to a list returned from vec_list_init()
  * @param index an index in the list (the first element is at 0)
@@ -64,8 +80,9 @@ Vector vec_list_get(VectorList *list, size_t index);
 void vec_list_set(VectorList *list, size_t index, Vector value);
 
 /**
- * Appends an element to the end of a list.
- * Should cause an assertion failure if the list has no remaining space.
+ * Appends an element to the end of a list,
+ * growing the list if it has no remaining space.
+ * Resets the list's kind to SHAPE_POLYGON.
  *
  * @param list a pointer to a list returned from vec_list_init()
  * @param value the vector to add to the end of the list
@@ -75,10 +92,19 @@ void vec_list_add(VectorList *list, Vector value);
 /**
  * Removes the element at the end of a list and returns it.
  * Should cause an assertion failure if the list has no elements.
+ * Resets the list's kind to SHAPE_POLYGON.
  *
  * @param list a pointer to a list returned from vec_list_init()
  * @return the vector at the end of the list
  */
 Vector vec_list_remove(VectorList *list);
 
+/**
+ * Allocates a new list with the same elements and kind as a given list.
+ *
+ * @param list a pointer to a list returned from vec_list_init()
+ * @return a pointer to the newly allocated copy
+ */
+VectorList *vec_list_copy(const VectorList *list);
+
 #endif // #ifndef __VEC_LIST_H__
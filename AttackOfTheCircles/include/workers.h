@@ -0,0 +1,65 @@
+#ifndef __WORKERS_H__
+#define __WORKERS_H__
+
+#include <stddef.h>
+
+/**
+ * A fixed set of threads that run numbered tasks in parallel, e.g. the
+ * chunks of a scene's force creators or bodies in scene_tick().
+ * The threads are started once by worker_pool_init() and sleep between
+ * calls to worker_pool_run(), so a run costs a wake-up, not a thread creation.
+ *
+ * The thread that calls worker_pool_run() works on the tasks too, so a pool
+ * of n threads only starts n - 1 of them. A pool must only be run from one
+ * thread at a time, and tasks must not run the same pool.
+ */
+typedef struct worker_pool WorkerPool;
+
+/**
+ * A function that runs one task of a worker_pool_run() call.
+ * Takes in the auxiliary value passed to worker_pool_run(),
+ * the task's number, and the number of the thread running it, from 0
+ * (the calling thread) to worker_pool_threads() - 1. No two tasks run on
+ * the same thread at once, so the thread number can pick per-thread state.
+ */
+typedef void (*WorkerTask)(void *aux, size_t task, size_t worker);
+
+/**
+ * Allocates a worker pool and starts its threads.
+ * Asserts that the memory is allocated and the threads start.
+ *
+ * @param threads the number of threads to run tasks on, counting the
+ *   thread that calls worker_pool_run(); asserts that it is positive
+ * @return the new pool
+ */
+WorkerPool *worker_pool_init(size_t threads);
+
+/**
+ * Stops a worker pool's threads, waiting for them to finish, and releases it.
+ *
+ * @param pool a pointer to a pool returned from worker_pool_init()
+ */
+void worker_pool_free(WorkerPool *pool);
+
+/**
+ * Gets the number of threads a worker pool runs tasks on.
+ *
+ * @param pool a pointer to a pool returned from worker_pool_init()
+ * @return the number passed to worker_pool_init()
+ */
+size_t worker_pool_threads(WorkerPool *pool);
+
+/**
+ * Runs task(aux, i, worker) for each i from 0 to tasks - 1 and waits for
+ * all of them to finish. Threads take the next task as they become free,
+ * so tasks may run in any order. Everything the tasks wrote is visible to
+ * the caller once this returns.
+ *
+ * @param pool a pointer to a pool returned from worker_pool_init()
+ * @param task the function to run for each task
+ * @param aux an auxiliary value to pass to each task
+ * @param tasks the number of tasks
+ */
+void worker_pool_run(WorkerPool *pool, WorkerTask task, void *aux, size_t tasks);
+
+#endif // #ifndef __WORKERS_H__
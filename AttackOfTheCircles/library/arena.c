@@ -0,0 +1,231 @@
+#include "arena.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Chunks are aligned to their size, so the chunk holding an object is found
+// by rounding the object's address down
+const size_t ARENA_CHUNK_BYTES = 1 << 16;
+const size_t INITIAL_CHUNK_TABLE_CAPACITY = 64;
+// Marks entries of the chunk table; real chunk addresses are never this small
+const uintptr_t EMPTY_ENTRY = 0;
+const uintptr_t REMOVED_ENTRY = 1;
+
+typedef struct arena_chunk{
+    struct arena_chunk *next;
+} ArenaChunk;
+
+struct arena{
+    // Every chunk, newest first
+    ArenaChunk *chunks;
+    // The free space left in the newest regular chunk
+    char *next;
+    char *end;
+    size_t bytes;
+};
+
+_Thread_local Arena *CURRENT_ARENA = NULL;
+
+// A hash set of the addresses of every live arena's chunks, for arena_owns().
+// Lookups don't lock: entries are read and written atomically, and a bigger
+// table is only published once it is filled in. Chunks are added and removed
+// rarely, so one lock orders the writers.
+typedef struct chunk_table{
+    size_t capacity;
+    // The number of entries that aren't empty, including removed ones
+    size_t used;
+    // The table this one replaced, kept since lookups may still be reading it.
+    // Each table is at most half the size of the next, so together they are
+    // never bigger than the current one.
+    struct chunk_table *retired;
+    _Atomic uintptr_t entries[];
+} ChunkTable;
+
+_Atomic(ChunkTable *) CHUNK_TABLE = NULL;
+// The number of live chunks; arena_owns() skips the table while it is 0
+atomic_size_t ARENA_CHUNKS = 0;
+atomic_flag CHUNK_TABLE_LOCK = ATOMIC_FLAG_INIT;
+
+void chunk_table_lock(void){
+    while(atomic_flag_test_and_set_explicit(&CHUNK_TABLE_LOCK, memory_order_acquire)){
+    }
+}
+
+void chunk_table_unlock(void){
+    atomic_flag_clear_explicit(&CHUNK_TABLE_LOCK, memory_order_release);
+}
+
+size_t arena_header_size(void){
+    size_t align = alignof(max_align_t);
+    return (sizeof(ArenaChunk) + align - 1) / align * align;
+}
+
+// The index where a chunk's address is, or would be added, in a table.
+// Entries only change from empty to a chunk, or between a chunk and removed,
+// so a lookup that races a writer still finds every chunk that was there.
+size_t chunk_table_find(ChunkTable *table, uintptr_t chunk, bool adding){
+    size_t mask = table->capacity - 1;
+    size_t i = (size_t)((chunk / ARENA_CHUNK_BYTES) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+    while(true){
+        uintptr_t entry = atomic_load_explicit(&table->entries[i], memory_order_relaxed);
+        if(entry == chunk || entry == EMPTY_ENTRY || (adding && entry == REMOVED_ENTRY)){
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+ChunkTable *chunk_table_init(size_t capacity){
+    ChunkTable *table = calloc(1, sizeof(ChunkTable) + capacity * sizeof(uintptr_t));
+    assert(table);
+    table->capacity = capacity;
+    return table;
+}
+
+// Publishes a copy of the table with the given capacity. Only called with the lock held
+void chunk_table_resize(size_t capacity){
+    ChunkTable *old_table = atomic_load_explicit(&CHUNK_TABLE, memory_order_relaxed);
+    ChunkTable *table = chunk_table_init(capacity);
+    table->retired = old_table;
+    for(size_t i = 0; old_table != NULL && i < old_table->capacity; i++){
+        uintptr_t entry = atomic_load_explicit(&old_table->entries[i], memory_order_relaxed);
+        if(entry != EMPTY_ENTRY && entry != REMOVED_ENTRY){
+            atomic_store_explicit(&table->entries[chunk_table_find(table, entry, true)], entry,
+              memory_order_relaxed);
+            table->used++;
+        }
+    }
+    atomic_store_explicit(&CHUNK_TABLE, table, memory_order_release);
+}
+
+void chunk_table_add(uintptr_t chunk){
+    chunk_table_lock();
+    ChunkTable *table = atomic_load_explicit(&CHUNK_TABLE, memory_order_relaxed);
+    // Keep the table at most half full, counting removed entries
+    if(table == NULL || 2 * (table->used + 1) > table->capacity){
+        size_t live = atomic_load(&ARENA_CHUNKS);
+        size_t capacity = table == NULL ? INITIAL_CHUNK_TABLE_CAPACITY : table->capacity;
+        while(4 * (live + 1) > capacity){
+            capacity *= 2;
+        }
+        chunk_table_resize(capacity);
+        table = atomic_load_explicit(&CHUNK_TABLE, memory_order_relaxed);
+    }
+    size_t i = chunk_table_find(table, chunk, true);
+    if(atomic_load_explicit(&table->entries[i], memory_order_relaxed) == EMPTY_ENTRY){
+        table->used++;
+    }
+    atomic_store_explicit(&table->entries[i], chunk, memory_order_relaxed);
+    atomic_fetch_add(&ARENA_CHUNKS, 1);
+    chunk_table_unlock();
+}
+
+void chunk_table_remove(uintptr_t chunk){
+    chunk_table_lock();
+    ChunkTable *table = atomic_load_explicit(&CHUNK_TABLE, memory_order_relaxed);
+    size_t i = chunk_table_find(table, chunk, false);
+    assert(atomic_load_explicit(&table->entries[i], memory_order_relaxed) == chunk);
+    atomic_store_explicit(&table->entries[i], REMOVED_ENTRY, memory_order_relaxed);
+    atomic_fetch_sub(&ARENA_CHUNKS, 1);
+    chunk_table_unlock();
+}
+
+// Allocates a chunk with room for at least size bytes after its header
+ArenaChunk *arena_add_chunk(Arena *arena, size_t size){
+    size_t bytes = (arena_header_size() + size + ARENA_CHUNK_BYTES - 1)
+      / ARENA_CHUNK_BYTES * ARENA_CHUNK_BYTES;
+    ArenaChunk *chunk = aligned_alloc(ARENA_CHUNK_BYTES, bytes);
+    assert(chunk);
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    chunk_table_add((uintptr_t)chunk);
+    return chunk;
+}
+
+Arena *arena_init(void){
+    Arena *arena = malloc(sizeof(Arena));
+    assert(arena);
+    arena->chunks = NULL;
+    arena->next = NULL;
+    arena->end = NULL;
+    arena->bytes = 0;
+    return arena;
+}
+
+void arena_free(Arena *arena){
+    if(CURRENT_ARENA == arena){
+        CURRENT_ARENA = NULL;
+    }
+    ArenaChunk *chunk = arena->chunks;
+    while(chunk != NULL){
+        ArenaChunk *next = chunk->next;
+        chunk_table_remove((uintptr_t)chunk);
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
+
+void *arena_alloc(Arena *arena, size_t size){
+    size_t align = alignof(max_align_t);
+    size = size == 0 ? align : (size + align - 1) / align * align;
+    arena->bytes += size;
+    // Objects too big for a regular chunk get a chunk of their own,
+    // which leaves the newest regular chunk's free space for later objects
+    if(size > ARENA_CHUNK_BYTES - arena_header_size()){
+        return (char *)arena_add_chunk(arena, size) + arena_header_size();
+    }
+    if(arena->next == NULL || (size_t)(arena->end - arena->next) < size){
+        char *chunk = (char *)arena_add_chunk(arena, size);
+        arena->next = chunk + arena_header_size();
+        arena->end = chunk + ARENA_CHUNK_BYTES;
+    }
+    void *object = arena->next;
+    arena->next += size;
+    return object;
+}
+
+size_t arena_bytes(Arena *arena){
+    return arena->bytes;
+}
+
+bool arena_owns(const void *object){
+    if(object == NULL || atomic_load_explicit(&ARENA_CHUNKS, memory_order_relaxed) == 0){
+        return false;
+    }
+    // Every object starts in the first ARENA_CHUNK_BYTES of its chunk
+    // An object's chunk was added before the object was handed out, so the
+    // table published by then, or a newer one, holds it
+    uintptr_t chunk = (uintptr_t)object / ARENA_CHUNK_BYTES * ARENA_CHUNK_BYTES;
+    ChunkTable *table = atomic_load_explicit(&CHUNK_TABLE, memory_order_acquire);
+    if(table == NULL){
+        return false;
+    }
+    return atomic_load_explicit(&table->entries[chunk_table_find(table, chunk, false)],
+      memory_order_relaxed) == chunk;
+}
+
+void arena_set_current(Arena *arena){
+    CURRENT_ARENA = arena;
+}
+
+Arena *arena_current(void){
+    return CURRENT_ARENA;
+}
+
+void *arena_malloc(size_t size){
+    if(CURRENT_ARENA != NULL){
+        return arena_alloc(CURRENT_ARENA, size);
+    }
+    void *object = malloc(size);
+    assert(object);
+    return object;
+}
+
+void arena_release(void *object){
+    if(!arena_owns(object)){
+        free(object);
+    }
+}
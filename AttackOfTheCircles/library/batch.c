@@ -0,0 +1,71 @@
+#include "batch.h"
+#include "list.h"
+#include "workers.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+const size_t INITIAL_BATCH_CAPACITY = 16;
+
+struct scene_batch{
+    List *scenes;
+    WorkerPool *workers;
+};
+
+// What each task of a scene_batch_tick() call needs
+typedef struct batch_step{
+    SceneBatch *batch;
+    const SceneInput *inputs;
+    double dt;
+    size_t ticks;
+} BatchStep;
+
+SceneBatch *scene_batch_init(size_t threads){
+    SceneBatch *batch = malloc(sizeof(SceneBatch));
+    assert(batch);
+    batch->scenes = list_init(INITIAL_BATCH_CAPACITY, (FreeFunc)scene_free);
+    batch->workers = worker_pool_init(threads);
+    return batch;
+}
+
+void scene_batch_free(SceneBatch *batch){
+    worker_pool_free(batch->workers);
+    list_free(batch->scenes);
+    free(batch);
+}
+
+size_t scene_batch_add(SceneBatch *batch, Scene *scene){
+    list_add(batch->scenes, scene);
+    return list_size(batch->scenes) - 1;
+}
+
+size_t scene_batch_size(SceneBatch *batch){
+    return list_size(batch->scenes);
+}
+
+Scene *scene_batch_get(SceneBatch *batch, size_t index){
+    assert(index < list_size(batch->scenes));
+    return list_get(batch->scenes, index);
+}
+
+void scene_batch_replace(SceneBatch *batch, size_t index, Scene *scene){
+    assert(index < list_size(batch->scenes));
+    // Frees the old scene
+    list_set(batch->scenes, index, scene);
+}
+
+void scene_batch_step(BatchStep *step, size_t task, size_t worker){
+    Scene *scene = list_get(step->batch->scenes, task);
+    if(step->inputs != NULL){
+        memcpy(scene_key_data(scene), step->inputs[task].keys, sizeof(step->inputs[task].keys));
+    }
+    for(size_t i = 0; i < step->ticks; i++){
+        scene_tick(scene, step->dt);
+    }
+}
+
+void scene_batch_tick(SceneBatch *batch, const SceneInput *inputs, double dt, size_t ticks){
+    BatchStep step = {batch, inputs, dt, ticks};
+    worker_pool_run(batch->workers, (WorkerTask)scene_batch_step, &step,
+      list_size(batch->scenes));
+}
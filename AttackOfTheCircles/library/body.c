@@ -1,17 +1,21 @@
 #include "body.h"
 #include "sdl_wrapper.h"
 #include "polygon.h"
+#include "pool.h"
+#include "vec_batch.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <time.h>
 #include <assert.h>
 
+// The history the multistep integrator keeps between ticks
 typedef struct accel_info{
     int interval;
     Vector disp_prev;
     Vector v_prev;
-    Vector v_curr;
     Vector v_next;
     double h_prev;
     double h_curr;
@@ -20,29 +24,105 @@ typedef struct accel_info{
     double n;
 } AccelInfo;
 
+// What velocity Verlet needs to correct the velocity it predicted last tick
+typedef struct verlet_info{
+    Vector accel_prev;
+    // 0 until the first tick, so there is nothing to correct
+    double dt_prev;
+} VerletInfo;
+
+struct body_store{
+    Vector *centroid;
+    Vector *velocity;
+    Vector *forces;
+    Vector *impulses;
+    double *mass;
+    size_t capacity;
+};
+
+// A force or impulse that a ForceLog holds until it is applied
+typedef struct force_log_entry{
+    Body *body;
+    Vector value;
+    bool impulse;
+} ForceLogEntry;
+
+struct force_log{
+    // The forces and impulses on bodies outside sums_store, in order
+    ForceLogEntry *entries;
+    size_t size;
+    size_t capacity;
+    // The store whose bodies' forces and impulses are summed in the arrays
+    // below, by store index, or NULL to keep everything in entries
+    BodyStore *sums_store;
+    Vector *forces;
+    Vector *impulses;
+    size_t sums_capacity;
+    // One past the highest index summed into since the log was last applied
+    size_t sums_end;
+};
+
+const size_t INITIAL_FORCE_LOG_CAPACITY = 64;
+
+// The log that body_add_force() and body_add_impulse() record into on this
+// thread, or NULL to add to the bodies directly
+_Thread_local ForceLog *CURRENT_FORCE_LOG = NULL;
+
 struct body{
-    List* body_points;
-    double mass;
-    Vector velocity;
+    // Where the body's centroid, velocity, forces, impulses and mass live,
+    // at store_index in each array. A new body's store is own_store, which
+    // holds just the body; body_move_to_store() moves it into a scene's.
+    BodyStore *store;
+    size_t store_index;
+    // Vertices relative to the centroid, before rotation. Never changes.
+    VectorList *local_shape;
+    // local_shape moved to shape_centroid and shape_rotation. It is rebuilt
+    // lazily when the body's transform no longer matches them.
+    VectorList *world_shape;
+    Vector shape_centroid;
+    double shape_rotation;
     double rotation_angle;
     RGBColor color;
-    Vector centroid;
-    Vector forces;
-    Vector impulses;
     double largest_radius;
+    // Whether local_shape is convex, which rotating and moving it keep
+    bool convex;
     void *info;
     FreeFunc info_freer;
     bool is_removed;
     bool camera_attachment;
-    AccelInfo *accel_info;
+    // The integrator's state (an AccelInfo or VerletInfo), allocated on the
+    // first tick with an integrator that needs one; NULL otherwise
+    void *integrator_state;
+    Integrator state_integrator;
+    // The body's slot in its scene, or SIZE_MAX if it is not in one
+    size_t scene_slot;
+    // Where body_remove() reports the body to its scene
+    List *removed_queue;
+    // The first link in the scene's list of force handlers that use this body
+    void *handler_links;
+    // The transform from body_save_transform(), which frames blend from
+    Vector saved_centroid;
+    double saved_rotation;
+    bool has_saved_transform;
+    // The single-entry store a body starts in
+    BodyStore own_store;
+    Vector own_centroid;
+    Vector own_velocity;
+    Vector own_forces;
+    Vector own_impulses;
+    double own_mass;
 };
 
+Pool BODY_POOL = POOL_INIT(sizeof(Body));
+Pool ACCEL_INFO_POOL = POOL_INIT(sizeof(AccelInfo));
+Pool VERLET_INFO_POOL = POOL_INIT(sizeof(VerletInfo));
+
 
 
-double shape_largest_radius(List *vertices, Vector center){
+double shape_largest_radius(VectorList *vertices, Vector center){
     double max_sqr_distance = 0;
-    for(size_t i = 0; i < list_size(vertices); i++){
-        double distance_sqr = vec_distance_squared(*(Vector*)list_get(vertices, i), center);
+    for(size_t i = 0; i < vertices->size; i++){
+        double distance_sqr = vec_distance_squared(vertices->data[i], center);
         if(distance_sqr > max_sqr_distance){
             max_sqr_distance = distance_sqr;
         }
@@ -51,11 +131,10 @@ double shape_largest_radius(List *vertices, Vector center){
 }
 
 AccelInfo * accel_info_init(){
-    AccelInfo *aInfo = malloc(sizeof(AccelInfo));
+    AccelInfo *aInfo = pool_alloc(&ACCEL_INFO_POOL);
     aInfo->interval = 1;
     aInfo->disp_prev = VEC_ZERO;
     aInfo->v_prev = VEC_ZERO;
-    aInfo->v_curr = VEC_ZERO;
     aInfo->v_next = VEC_ZERO;
     aInfo->h_prev = 1000.0;
     aInfo->h_curr = 1000.0;
@@ -65,26 +144,41 @@ AccelInfo * accel_info_init(){
     return aInfo;
 }
 
-Body *body_init(List *shape, double mass, RGBColor color){
+Body *body_init(VectorList *shape, double mass, RGBColor color){
     assert(mass > 0);
-    Body *body = malloc(sizeof(Body));
-    body->body_points = shape;
-    body->centroid = polygon_centroid(body->body_points);
-    body->mass = mass;
+    Body *body = pool_alloc(&BODY_POOL);
+    body->own_store = (BodyStore){&body->own_centroid, &body->own_velocity,
+      &body->own_forces, &body->own_impulses, &body->own_mass, 1};
+    body->store = &body->own_store;
+    body->store_index = 0;
+    body->own_centroid = polygon_centroid(shape);
+    body->world_shape = shape;
+    body->shape_centroid = body->own_centroid;
+    body->shape_rotation = 0.0;
+    body->local_shape = vec_list_copy(shape);
+    polygon_translate(body->local_shape, vec_negate(body->own_centroid));
+    body->own_mass = mass;
     body->color = color;
-    body->velocity = VEC_ZERO;
-    body->forces = VEC_ZERO;
-    body->impulses = VEC_ZERO;
+    body->own_velocity = VEC_ZERO;
+    body->own_forces = VEC_ZERO;
+    body->own_impulses = VEC_ZERO;
     body->rotation_angle = 0.0;
-    body->largest_radius = shape_largest_radius(body->body_points, body->centroid);
+    body->largest_radius = shape_largest_radius(body->local_shape, VEC_ZERO);
+    // Circles and boxes are always convex, so only other polygons are checked
+    body->convex = shape->kind != SHAPE_POLYGON || polygon_is_convex(body->local_shape);
     body->is_removed = false;
+    body->info = NULL;
     body->info_freer = NULL;
     body->camera_attachment = true;
-    body->accel_info = accel_info_init();
+    body->integrator_state = NULL;
+    body->scene_slot = SIZE_MAX;
+    body->removed_queue = NULL;
+    body->handler_links = NULL;
+    body->has_saved_transform = false;
     return body;
 }
 
-Body *body_init_with_info(List *shape, double mass, RGBColor color, void *info,
+Body *body_init_with_info(VectorList *shape, double mass, RGBColor color, void *info,
   FreeFunc info_freer){
     Body *body = body_init(shape, mass, color);
     body->info = info;
@@ -92,38 +186,174 @@ Body *body_init_with_info(List *shape, double mass, RGBColor color, void *info,
     return body;
 }
 
+void body_release_integrator_state(Body *body){
+    if(body->integrator_state == NULL){
+        return;
+    }
+    if(body->state_integrator == INTEGRATOR_MULTISTEP){
+        pool_release(&ACCEL_INFO_POOL, body->integrator_state);
+    }
+    else{
+        pool_release(&VERLET_INFO_POOL, body->integrator_state);
+    }
+    body->integrator_state = NULL;
+}
+
 void body_free(Body *body){
-    list_free(body->body_points);
+    // Leave the body's entry in a scene's store at rest,
+    // so sweeps over the store don't move it until the slot is reused
+    if(body->store != &body->own_store){
+        body->store->velocity[body->store_index] = VEC_ZERO;
+        body->store->forces[body->store_index] = VEC_ZERO;
+        body->store->impulses[body->store_index] = VEC_ZERO;
+    }
+    vec_list_free(body->local_shape);
+    vec_list_free(body->world_shape);
     if (body->info_freer != NULL){
       body->info_freer(body->info);
     }
-    free(body->accel_info);
-    free(body);
+    body_release_integrator_state(body);
+    pool_release(&BODY_POOL, body);
 }
 
-List *body_get_shape(Body *body){
-    size_t body_points_size = list_size(body->body_points);
-    List *new_list = list_init(body_points_size, free);
+BodyStore *body_store_init(void){
+    BodyStore *store = malloc(sizeof(BodyStore));
+    assert(store);
+    *store = (BodyStore){NULL, NULL, NULL, NULL, NULL, 0};
+    return store;
+}
+
+void body_store_free(BodyStore *store){
+    // The arrays share one block, which starts at centroid
+    free(store->centroid);
+    free(store);
+}
+
+// Grows an array of per-body sums, clearing the new entries
+void *body_store_grow(void *array, size_t old_bytes, size_t new_bytes){
+    char *grown = realloc(array, new_bytes);
+    assert(grown);
+    memset(grown + old_bytes, 0, new_bytes - old_bytes);
+    return grown;
+}
+
+void body_store_reserve(BodyStore *store, size_t capacity){
+    if(capacity <= store->capacity){
+        return;
+    }
+    size_t old = store->capacity;
+    // One block holds all the arrays, so growing the store is one allocation
+    Vector *block = calloc(capacity, 4 * sizeof(Vector) + sizeof(double));
+    assert(block);
+    BodyStore grown = {
+        block, block + capacity, block + 2 * capacity, block + 3 * capacity,
+        (double *) (block + 4 * capacity), capacity
+    };
+    if(old > 0){
+        memcpy(grown.centroid, store->centroid, old * sizeof(Vector));
+        memcpy(grown.velocity, store->velocity, old * sizeof(Vector));
+        memcpy(grown.forces, store->forces, old * sizeof(Vector));
+        memcpy(grown.impulses, store->impulses, old * sizeof(Vector));
+        memcpy(grown.mass, store->mass, old * sizeof(double));
+    }
+    // Unused entries get a finite mass, so sweeps over them stay at rest
+    for(size_t i = old; i < capacity; i++){
+        grown.mass[i] = 1;
+    }
+    free(store->centroid);
+    *store = grown;
+}
+
+void body_move_to_store(Body *body, BodyStore *store, size_t index){
+    assert(index < store->capacity);
+    assert(body->store == &body->own_store);
+    store->centroid[index] = body->own_centroid;
+    store->velocity[index] = body->own_velocity;
+    store->forces[index] = body->own_forces;
+    store->impulses[index] = body->own_impulses;
+    store->mass[index] = body->own_mass;
+    body->store = store;
+    body->store_index = index;
+}
+
+bool body_is_convex(Body *body){
+    return body->convex;
+}
 
-    for (size_t i = 0; i < body_points_size; i++){
-        Vector *element = list_get(body->body_points, i);
-        Vector *new_element = malloc(sizeof(Vector));
-        *new_element = *element;
-        list_add(new_list, new_element);
+ShapeKind body_get_shape_kind(Body *body){
+    if(body->local_shape->kind == SHAPE_AABB && body->rotation_angle != 0){
+        return SHAPE_POLYGON;
     }
-    return new_list;
+    return body->local_shape->kind;
+}
+
+// Writes the body's vertices, moved to centroid and rotated by angle, into world
+void body_place_shape(Body *body, Vector centroid, double angle, Vector *world){
+    vec_batch_rotate(world, body->local_shape->data, body->local_shape->size,
+      cos(angle), sin(angle), VEC_ZERO, centroid);
+}
+
+// Recomputes the world-space vertices if the body has moved since they were last used
+VectorList *body_world_shape(Body *body){
+    Vector centroid = body_get_centroid(body);
+    if(centroid.x != body->shape_centroid.x || centroid.y != body->shape_centroid.y
+      || body->rotation_angle != body->shape_rotation){
+        body_place_shape(body, centroid, body->rotation_angle, body->world_shape->data);
+        body->world_shape->kind = body_get_shape_kind(body);
+        body->shape_centroid = centroid;
+        body->shape_rotation = body->rotation_angle;
+    }
+    return body->world_shape;
+}
+
+VectorList *body_get_shape(Body *body){
+    return vec_list_copy(body_world_shape(body));
+}
+
+const VectorList *body_get_shape_view(Body *body){
+    return body_world_shape(body);
+}
+
+void body_save_transform(Body *body){
+    body->saved_centroid = body_get_centroid(body);
+    body->saved_rotation = body->rotation_angle;
+    body->has_saved_transform = true;
+}
+
+const VectorList *body_get_interpolated_shape(Body *body, double alpha, VectorList *scratch){
+    Vector current = body_get_centroid(body);
+    bool moved = body->saved_centroid.x != current.x
+      || body->saved_centroid.y != current.y
+      || body->saved_rotation != body->rotation_angle;
+    if(!body->has_saved_transform || !moved || alpha >= 1){
+        return body_world_shape(body);
+    }
+    Vector centroid = vec_add(body->saved_centroid,
+      vec_multiply(alpha, vec_subtract(current, body->saved_centroid)));
+    // Turn the short way round, in case the angle wrapped
+    double turn = remainder(body->rotation_angle - body->saved_rotation, 2 * M_PI);
+    double angle = body->saved_rotation + alpha * turn;
+    size_t size = body->local_shape->size;
+    while(scratch->size < size){
+        vec_list_add(scratch, VEC_ZERO);
+    }
+    scratch->size = size;
+    body_place_shape(body, centroid, angle, scratch->data);
+    scratch->kind = body->local_shape->kind == SHAPE_AABB && angle != 0
+      ? SHAPE_POLYGON : body->local_shape->kind;
+    return scratch;
 }
 
 Vector body_get_centroid(Body *body){
-    return body->centroid;
+    return body->store->centroid[body->store_index];
 }
 
 Vector body_get_velocity(Body *body){
-    return body->velocity;
+    return body->store->velocity[body->store_index];
 }
 
 double body_get_mass(Body *body){
-    return body->mass;
+    return body->store->mass[body->store_index];
 }
 
 RGBColor body_get_color(Body *body){
@@ -143,29 +373,109 @@ bool body_get_camera_attachment(Body *body){
 }
 
 void body_set_centroid(Body *body, Vector x){
-    Vector translation = vec_subtract(x, body->centroid);
-    body->centroid = x;
-    polygon_translate(body->body_points, translation);
+    body->store->centroid[body->store_index] = x;
 }
 
 void body_set_velocity(Body *body, Vector v){
-    body->velocity = v;
+    body->store->velocity[body->store_index] = v;
 }
 
 void body_set_rotation(Body *body, double angle){
-    polygon_rotate(body->body_points, angle - body->rotation_angle, body->centroid);
     body->rotation_angle = angle;
 }
 
+ForceLog *force_log_init(void){
+    ForceLog *log = malloc(sizeof(ForceLog));
+    assert(log);
+    *log = (ForceLog){NULL, 0, 0, NULL, NULL, NULL, 0, 0};
+    return log;
+}
+
+void force_log_free(ForceLog *log){
+    free(log->entries);
+    free(log->forces);
+    free(log->impulses);
+    free(log);
+}
+
+void force_log_start(ForceLog *log, BodyStore *sums_store){
+    assert(CURRENT_FORCE_LOG == NULL);
+    assert(log->sums_end == 0 || sums_store == log->sums_store);
+    log->sums_store = sums_store;
+    if(sums_store != NULL && log->sums_capacity < sums_store->capacity){
+        size_t old = log->sums_capacity;
+        size_t capacity = sums_store->capacity;
+        log->forces = body_store_grow(log->forces,
+          old * sizeof(Vector), capacity * sizeof(Vector));
+        log->impulses = body_store_grow(log->impulses,
+          old * sizeof(Vector), capacity * sizeof(Vector));
+        log->sums_capacity = capacity;
+    }
+    CURRENT_FORCE_LOG = log;
+}
+
+void force_log_stop(void){
+    CURRENT_FORCE_LOG = NULL;
+}
+
+void force_log_record(ForceLog *log, Body *body, Vector value, bool impulse){
+    if(body->store == log->sums_store){
+        Vector *sums = impulse ? log->impulses : log->forces;
+        size_t i = body->store_index;
+        sums[i] = vec_add(sums[i], value);
+        if(i >= log->sums_end){
+            log->sums_end = i + 1;
+        }
+        return;
+    }
+    if(log->size == log->capacity){
+        log->capacity = log->capacity == 0 ? INITIAL_FORCE_LOG_CAPACITY : 2 * log->capacity;
+        log->entries = realloc(log->entries, sizeof(ForceLogEntry) * log->capacity);
+        assert(log->entries);
+    }
+    log->entries[log->size++] = (ForceLogEntry){body, value, impulse};
+}
+
 void body_add_force(Body *body, Vector force){
-    body->forces = vec_add(body->forces, force);
+    if(CURRENT_FORCE_LOG != NULL){
+        force_log_record(CURRENT_FORCE_LOG, body, force, false);
+        return;
+    }
+    Vector *forces = &body->store->forces[body->store_index];
+    *forces = vec_add(*forces, force);
 }
 
 void body_add_impulse(Body *body, Vector impulse){
-    body->impulses = vec_add(body->impulses, impulse);
+    if(CURRENT_FORCE_LOG != NULL){
+        force_log_record(CURRENT_FORCE_LOG, body, impulse, true);
+        return;
+    }
+    Vector *impulses = &body->store->impulses[body->store_index];
+    *impulses = vec_add(*impulses, impulse);
+}
+
+void force_log_apply(ForceLog *log){
+    assert(CURRENT_FORCE_LOG == NULL);
+    for(size_t i = 0; i < log->size; i++){
+        ForceLogEntry *entry = &log->entries[i];
+        if(entry->impulse){
+            body_add_impulse(entry->body, entry->value);
+        }
+        else{
+            body_add_force(entry->body, entry->value);
+        }
+    }
+    log->size = 0;
+    BodyStore *store = log->sums_store;
+    for(size_t i = 0; i < log->sums_end; i++){
+        store->forces[i] = vec_add(store->forces[i], log->forces[i]);
+        store->impulses[i] = vec_add(store->impulses[i], log->impulses[i]);
+        log->forces[i] = VEC_ZERO;
+        log->impulses[i] = VEC_ZERO;
+    }
+    log->sums_end = 0;
 }
 
-/*
 void compute_even_coefficients(AccelInfo *info){
     double h0 = info->h_prev;
     double h1 = info->h_curr;
@@ -182,72 +492,180 @@ void compute_odd_coefficients(AccelInfo *info){
     info->n = (-h1*h1*h1)/(6*h0*(h0+h1));
 }
 
+// Gets the body's state for an integrator, allocating it on first use.
+// Switching integrators starts the new one's state from scratch.
+void *body_integrator_state(Body *body, Integrator integrator){
+    if(body->integrator_state != NULL && body->state_integrator == integrator){
+        return body->integrator_state;
+    }
+    body_release_integrator_state(body);
+    if(integrator == INTEGRATOR_MULTISTEP){
+        body->integrator_state = accel_info_init();
+    }
+    else{
+        VerletInfo *info = pool_alloc(&VERLET_INFO_POOL);
+        info->accel_prev = VEC_ZERO;
+        info->dt_prev = 0;
+        body->integrator_state = info;
+    }
+    body->state_integrator = integrator;
+    return body->integrator_state;
+}
+
+void body_move(Body *body, Vector displacement, Vector final_velocity){
+    BodyStore *store = body->store;
+    size_t i = body->store_index;
+    store->centroid[i] = vec_add(store->centroid[i], displacement);
+    store->velocity[i] = final_velocity;
+    store->forces[i] = VEC_ZERO;
+    store->impulses[i] = VEC_ZERO;
+}
 
-void body_tick(Body *body, double dt){
-    AccelInfo *info = body->accel_info;
-    Vector dv_inst = vec_multiply(1/body_get_mass(body), body->impulses);
-    Vector dv_accel = vec_multiply(dt/body_get_mass(body), body->forces);
-    Vector inst_velocity = vec_add(body->velocity, dv_inst);
+void body_store_midpoint(BodyStore *store, size_t start, size_t end, double dt){
+    vec_batch_integrate_midpoint(store->centroid + start, store->velocity + start,
+      store->forces + start, store->impulses + start, store->mass + start, end - start, dt);
+}
+
+void body_store_semi_implicit_euler(BodyStore *store, size_t start, size_t end, double dt){
+    vec_batch_integrate_euler(store->centroid + start, store->velocity + start,
+      store->forces + start, store->impulses + start, store->mass + start, end - start, dt);
+}
+
+// The forces are only known at the start of each tick, so the velocity left
+// at the end of a tick is a prediction from that tick's acceleration alone.
+// The next tick corrects it to the average of the two accelerations.
+// Impulses move the body like in body_tick_midpoint(), so it only differs
+// from the midpoint method when the forces change from tick to tick.
+void body_tick_velocity_verlet(Body *body, double dt){
+    VerletInfo *info = body_integrator_state(body, INTEGRATOR_VELOCITY_VERLET);
+    size_t i = body->store_index;
+    Vector accel = vec_multiply(1/body_get_mass(body), body->store->forces[i]);
+    Vector velocity = vec_add(body_get_velocity(body),
+      vec_multiply(0.5*info->dt_prev, vec_subtract(accel, info->accel_prev)));
+    Vector dv_inst = vec_multiply(1/body_get_mass(body), body->store->impulses[i]);
+
+    Vector displacement = vec_add(
+      vec_multiply(dt, vec_add(velocity, vec_multiply(0.5, dv_inst))),
+      vec_multiply(0.5*dt*dt, accel));
+    Vector final_velocity = vec_add(vec_add(velocity, dv_inst), vec_multiply(dt, accel));
+    info->accel_prev = accel;
+    info->dt_prev = dt;
+    body_move(body, displacement, final_velocity);
+}
+
+// Integrates the velocities of the last three ticks, allowing for ticks of
+// different lengths. Odd ticks use a three-point Adams-Moulton step; even
+// ticks cover the last two ticks with Simpson's rule and subtract the previous
+// tick's displacement.
+void body_tick_multistep(Body *body, double dt){
+    AccelInfo *info = body_integrator_state(body, INTEGRATOR_MULTISTEP);
+    Vector velocity = body_get_velocity(body);
+    Vector dv_inst = vec_multiply(1/body_get_mass(body), body->store->impulses[body->store_index]);
+    Vector dv_accel = vec_multiply(dt/body_get_mass(body), body->store->forces[body->store_index]);
+    Vector inst_velocity = vec_add(velocity, dv_inst);
     Vector final_velocity = vec_add(inst_velocity, dv_accel);
     info->v_next = final_velocity;
     info->h_curr = dt;
 
     Vector displacement;
     if(info->interval == 1){
-        displacement = vec_multiply(0.5*dt, vec_add(body->velocity, final_velocity));
-        info->v_curr = body->velocity;
-    } else if(info->interval % 2 == 0){
-        compute_even_coefficients(info);
-        Vector term1 = vec_multiply(info->a, info->v_next);
-        Vector term2 = vec_multiply(info->b, info->v_curr);
-        Vector term3 = vec_multiply(info->n, info->v_prev);
-        displacement = vec_subtract(vec_add(vec_add(term1, term2), term3), info->disp_prev);
-    } else{
-        compute_odd_coefficients(info);
+        displacement = vec_multiply(0.5*dt, vec_add(velocity, final_velocity));
+    }
+    else{
+        if(info->interval % 2 == 0){
+            compute_even_coefficients(info);
+        }
+        else{
+            compute_odd_coefficients(info);
+        }
         Vector term1 = vec_multiply(info->a, info->v_next);
-        Vector term2 = vec_multiply(info->b, info->v_curr);
+        Vector term2 = vec_multiply(info->b, velocity);
         Vector term3 = vec_multiply(info->n, info->v_prev);
         displacement = vec_add(vec_add(term1, term2), term3);
+        if(info->interval % 2 == 0){
+            displacement = vec_subtract(displacement, info->disp_prev);
+        }
     }
 
     info->disp_prev = displacement;
     info->interval += 1;
-    info->v_prev = info->v_curr;
-    info->v_curr = final_velocity;
+    info->v_prev = velocity;
     info->h_prev = info->h_curr;
-    body_set_velocity(body, final_velocity);
-
-    polygon_translate(body->body_points, displacement);
-    body->centroid = vec_add(body->centroid, displacement);
+    body_move(body, displacement, final_velocity);
+}
 
-    body_set_velocity(body, final_velocity);
-    body->forces = VEC_ZERO;
-    body->impulses = VEC_ZERO;
-}*/
+void body_store_integrate_range(BodyStore *store, size_t start, size_t end,
+  double dt, Integrator integrator){
+    assert(start <= end && end <= store->capacity);
+    if(integrator == INTEGRATOR_SEMI_IMPLICIT_EULER){
+        body_store_semi_implicit_euler(store, start, end, dt);
+    }
+    else{
+        assert(integrator == INTEGRATOR_MIDPOINT);
+        body_store_midpoint(store, start, end, dt);
+    }
+}
 
-void body_tick(Body *body, double dt){
-    Vector dv_inst = vec_multiply(1/body_get_mass(body), body->impulses);
-    Vector dv_accel = vec_multiply(dt/body_get_mass(body), body->forces);
-    Vector inst_velocity = vec_add(body->velocity, dv_inst);
-    Vector final_velocity = vec_add(inst_velocity, dv_accel);
+void body_store_integrate(BodyStore *store, size_t count, double dt, Integrator integrator){
+    body_store_integrate_range(store, 0, count, dt, integrator);
+}
 
-    Vector displacement = vec_multiply(0.5*dt, vec_add(body->velocity, final_velocity));
-    polygon_translate(body->body_points, displacement);
-    body->centroid = vec_add(body->centroid, displacement);
+void body_integrate(Body *body, double dt, Integrator integrator){
+    switch(integrator){
+        case INTEGRATOR_SEMI_IMPLICIT_EULER:
+            body_store_semi_implicit_euler(body->store, body->store_index,
+              body->store_index + 1, dt);
+            break;
+        case INTEGRATOR_VELOCITY_VERLET:
+            body_tick_velocity_verlet(body, dt);
+            break;
+        case INTEGRATOR_MULTISTEP:
+            body_tick_multistep(body, dt);
+            break;
+        default:
+            body_store_midpoint(body->store, body->store_index, body->store_index + 1, dt);
+            break;
+    }
+}
 
-    body_set_velocity(body, final_velocity);
-    body->forces = VEC_ZERO;
-    body->impulses = VEC_ZERO;
+void body_tick(Body *body, double dt){
+    body_store_midpoint(body->store, body->store_index, body->store_index + 1, dt);
 }
 
 void body_remove(Body *body){
+    if(body->is_removed){
+        return;
+    }
     body->is_removed = true;
+    if(body->removed_queue != NULL){
+        list_add(body->removed_queue, body);
+    }
 }
 
 bool body_is_removed(Body *body){
     return body->is_removed;
 }
 
+void body_set_scene_slot(Body *body, size_t slot, List *removed_queue){
+    body->scene_slot = slot;
+    body->removed_queue = removed_queue;
+    if(body->is_removed && removed_queue != NULL){
+        list_add(removed_queue, body);
+    }
+}
+
+size_t body_get_scene_slot(Body *body){
+    return body->scene_slot;
+}
+
+void *body_get_handler_links(Body *body){
+    return body->handler_links;
+}
+
+void body_set_handler_links(Body *body, void *links){
+    body->handler_links = links;
+}
+
 double body_radius(Body *b){
     return b->largest_radius;
 }
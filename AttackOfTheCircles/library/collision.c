@@ -1,140 +1,194 @@
 #include "collision.h"
 #include "polygon.h"
+#include "vec_batch.h"
 #include "math.h"
 
-typedef struct projection_info{
-	bool intersected;
-	double intersection;
-	Vector projection_axis;
-} ProjectionInfo;
-
 typedef struct min_and_max{
 	double min;
 	double max;
 } MinMax;
 
-ProjectionInfo projection_info_init(bool intersected, double intersection, Vector projection_axis){
-	ProjectionInfo projection_info;
-	projection_info.intersected = intersected;
-	projection_info.intersection = intersection;
-	projection_info.projection_axis = projection_axis;
-	return projection_info;
-}
-
-MinMax shape_project(List *shape, Vector axis){
-	double min = INFINITY;
-	double max = -INFINITY;
+MinMax shape_project(const VectorList *shape, Vector axis){
 	MinMax min_and_max;
-	for(size_t i = 0; i < list_size(shape); i++){
-		Vector v = *(Vector*)list_get(shape, i);
-		double project = vec_dot(v, axis);
-			if(project < min){
-				min = project;
-			}
-			if(project > max){
-				max = project;
-			}
-	}
-	min_and_max.min = min;
-	min_and_max.max = max;
+	vec_batch_project(shape->data, shape->size, axis, &min_and_max.min, &min_and_max.max);
 	return min_and_max;
 }
 
-List *shape_edges(List *shape){
-	size_t size = list_size(shape);
-	List *edges = list_init(size, free);
+/*
+ * Projects both shapes onto the normal of each edge of edge_shape.
+ * The normals are unit vectors pointing the same way as between,
+ * so overlaps on different axes can be compared.
+ * Returns false as soon as an axis separates the shapes.
+ * Otherwise, lowers *depth and sets *axis if an edge overlaps less.
+ */
+bool shape_edges_overlap(const VectorList *edge_shape, const VectorList *shape1,
+	const VectorList *shape2, Vector between, double *depth, Vector *axis){
+	size_t size = edge_shape->size;
+	Vector *vertices = edge_shape->data;
 	for(size_t i = 0; i < size; i++){
-		Vector from = *(Vector*)list_get(shape, i);
-		Vector to = *(Vector*)list_get(shape, (i + 1) % size);
-		Vector *edge = malloc(sizeof(Vector));
-		*edge = vec_subtract(to, from);
-		list_add(edges, edge);
+		Vector from = vertices[i];
+		Vector to = vertices[i + 1 == size ? 0 : i + 1];
+		Vector normal = {from.y - to.y, to.x - from.x};
+		double length = sqrt(normal.x * normal.x + normal.y * normal.y);
+		if(length == 0){
+			continue;
+		}
+		normal.x /= length;
+		normal.y /= length;
+		if(normal.x * between.x + normal.y * between.y < 0){
+			normal.x = -normal.x;
+			normal.y = -normal.y;
+		}
+
+		MinMax m1 = shape_project(shape1, normal);
+		MinMax m2 = shape_project(shape2, normal);
+		bool intersected;
+		double intersection;
+		if(m2.max > m1.max){
+			intersected = m2.min < m1.max;
+			intersection = fabs(m2.min - m1.max);
+		}
+		else{
+			intersected = m1.min < m2.max;
+			intersection = fabs(m1.min - m2.max);
+		}
+		if(!intersected){
+			return false;
+		}
+		if(intersection < *depth){
+			*depth = intersection;
+			*axis = normal;
+		}
 	}
-	return edges;
+	return true;
 }
 
-ProjectionInfo get_projection_intersection(List *shape1, List *shape2, Vector axis){
-	ProjectionInfo projection_info = projection_info_init(false, 0.0, axis);
-	MinMax m1 = shape_project(shape1, axis);
-	MinMax m2 = shape_project(shape2, axis);
-	double min1 = m1.min;
-	double max1 = m1.max;
-	double min2 = m2.min;
-	double max2 = m2.max;
+CollisionInfo polygon_collision(const VectorList *shape1, const VectorList *shape2){
+	Vector between = vec_subtract(polygon_centroid(shape2), polygon_centroid(shape1));
+	CollisionInfo collision_info = {false, VEC_ZERO, INFINITY};
+	collision_info.collided =
+		shape_edges_overlap(shape1, shape1, shape2, between,
+			&collision_info.depth, &collision_info.axis)
+		&& shape_edges_overlap(shape2, shape1, shape2, between,
+			&collision_info.depth, &collision_info.axis);
+	return collision_info;
+}
 
-	if(max2 > max1){
-		projection_info.intersected = min2 < max1;
-		projection_info.intersection = fabs(min2 - max1);
+// A SHAPE_CIRCLE's vertices all lie on the circle, so their mean is its center
+void circle_bounds(const VectorList *shape, Vector *center, double *radius){
+	Vector sum = VEC_ZERO;
+	for(size_t i = 0; i < shape->size; i++){
+		sum.x += shape->data[i].x;
+		sum.y += shape->data[i].y;
 	}
+	*center = (Vector){sum.x / shape->size, sum.y / shape->size};
+	*radius = vec_distance(*center, shape->data[0]);
+}
 
-	else{
-		projection_info.intersected = min1 < max2;
-		projection_info.intersection = fabs(min1 - max2);
+void box_bounds(const VectorList *shape, Vector *min, Vector *max){
+	*min = (Vector){INFINITY, INFINITY};
+	*max = (Vector){-INFINITY, -INFINITY};
+	for(size_t i = 0; i < shape->size; i++){
+		min->x = fmin(min->x, shape->data[i].x);
+		min->y = fmin(min->y, shape->data[i].y);
+		max->x = fmax(max->x, shape->data[i].x);
+		max->y = fmax(max->y, shape->data[i].y);
 	}
-	return projection_info;
 }
 
-Vector get_projection_edge(Vector edge, List *shape1, List *shape2){
-	Vector projection_edge = {-edge.y, edge.x};
-	Vector centroid_1 = polygon_centroid(shape1);
-	Vector centroid_2 = polygon_centroid(shape2);
-	Vector one_to_two = vec_subtract(centroid_2, centroid_1);
-	double dotted_two_vectors = vec_dot(one_to_two, projection_edge);
-	double mag_dist = vec_magnitude(one_to_two);
-	double mag_2 = vec_magnitude(projection_edge);
-	double divided = (1/(mag_dist * mag_2) * dotted_two_vectors);
-	if (divided < 0){
-		return vec_negate(projection_edge);
+CollisionInfo circle_collision(const VectorList *shape1, const VectorList *shape2){
+	Vector center1, center2;
+	double radius1, radius2;
+	circle_bounds(shape1, &center1, &radius1);
+	circle_bounds(shape2, &center2, &radius2);
+	CollisionInfo collision_info = {false, VEC_ZERO, 0};
+	Vector between = vec_subtract(center2, center1);
+	double distance = vec_magnitude(between);
+	if(distance >= radius1 + radius2){
+		return collision_info;
 	}
-	return projection_edge;
+	collision_info.collided = true;
+	collision_info.axis = distance > 0 ? vec_multiply(1 / distance, between) : (Vector){0, 1};
+	collision_info.depth = radius1 + radius2 - distance;
+	return collision_info;
 }
 
-ProjectionInfo get_smallest_projection_shape_axis (List *shape1, List* shape2, List* edges){
-	bool separating_axis = false;
-	int i = 0;
-	double smallest_projection = INFINITY;
-	Vector smallest_projection_axis = {0.0, 0.0};
+CollisionInfo box_collision(const VectorList *shape1, const VectorList *shape2){
+	Vector min1, max1, min2, max2;
+	box_bounds(shape1, &min1, &max1);
+	box_bounds(shape2, &min2, &max2);
+	CollisionInfo collision_info = {false, VEC_ZERO, 0};
+	if(min2.x >= max1.x || min1.x >= max2.x || min2.y >= max1.y || min1.y >= max2.y){
+		return collision_info;
+	}
+	// How far shape2 has to move along each axis, away from shape1, to stop overlapping
+	bool right = min2.x + max2.x >= min1.x + max1.x;
+	bool up = min2.y + max2.y >= min1.y + max1.y;
+	double depth_x = right ? max1.x - min2.x : max2.x - min1.x;
+	double depth_y = up ? max1.y - min2.y : max2.y - min1.y;
+	collision_info.collided = true;
+	if(depth_x < depth_y){
+		collision_info.axis = (Vector){right ? 1 : -1, 0};
+		collision_info.depth = depth_x;
+	}
+	else{
+		collision_info.axis = (Vector){0, up ? 1 : -1};
+		collision_info.depth = depth_y;
+	}
+	return collision_info;
+}
 
-	while(!separating_axis && i < list_size(edges)){
-		Vector edge = *(Vector*)list_get(edges, i);
-		Vector projection_edge = get_projection_edge(edge, shape1, shape2);
-		ProjectionInfo projection_info = get_projection_intersection(shape1, shape2, projection_edge);
-		separating_axis = !projection_info.intersected;
-		if (smallest_projection > projection_info.intersection){
-			smallest_projection = projection_info.intersection;
-			smallest_projection_axis = projection_edge;
+// Collides a box with a circle, with the axis pointing from the box to the circle
+CollisionInfo box_circle_collision(const VectorList *box, const VectorList *circle){
+	Vector min, max, center;
+	double radius;
+	box_bounds(box, &min, &max);
+	circle_bounds(circle, &center, &radius);
+	CollisionInfo collision_info = {false, VEC_ZERO, 0};
+	Vector closest = {fmin(fmax(center.x, min.x), max.x), fmin(fmax(center.y, min.y), max.y)};
+	Vector outside = vec_subtract(center, closest);
+	double distance = vec_magnitude(outside);
+	if(distance > 0){
+		if(distance >= radius){
+			return collision_info;
 		}
-		i++;
+		collision_info.collided = true;
+		collision_info.axis = vec_multiply(1 / distance, outside);
+		collision_info.depth = radius - distance;
+		return collision_info;
 	}
 
-	smallest_projection_axis = vec_multiply(1 / vec_magnitude(smallest_projection_axis),
-		smallest_projection_axis);
-
-	ProjectionInfo info = projection_info_init(separating_axis, smallest_projection, smallest_projection_axis);
-	return info;
+	// The center is inside the box, so push the circle out through the nearest side
+	double sides[4] = {center.x - min.x, max.x - center.x, center.y - min.y, max.y - center.y};
+	Vector normals[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+	int nearest = 0;
+	for(int i = 1; i < 4; i++){
+		if(sides[i] < sides[nearest]){
+			nearest = i;
+		}
+	}
+	collision_info.collided = true;
+	collision_info.axis = normals[nearest];
+	collision_info.depth = sides[nearest] + radius;
+	return collision_info;
 }
 
-CollisionInfo find_collision(List *shape1, List *shape2){
-	List *edges1 = shape_edges(shape1);
-	List *edges2 = shape_edges(shape2);
-
-	ProjectionInfo projection_info_1 = get_smallest_projection_shape_axis(shape1, shape2, edges1);
-	ProjectionInfo projection_info_2 = get_smallest_projection_shape_axis(shape1, shape2, edges2);
-
-	CollisionInfo collision_info;
-
-	bool separating_axis_1 = projection_info_1.intersected;
-	bool separating_axis_2 = projection_info_2.intersected;
-	collision_info.collided = !separating_axis_1 && !separating_axis_2;
-
-	if (projection_info_1.intersection < projection_info_2.intersection){
-		collision_info.axis = projection_info_1.projection_axis;
+CollisionInfo find_collision(const VectorList *shape1, const VectorList *shape2){
+	ShapeKind kind1 = shape1->kind;
+	ShapeKind kind2 = shape2->kind;
+	if(kind1 == SHAPE_CIRCLE && kind2 == SHAPE_CIRCLE){
+		return circle_collision(shape1, shape2);
 	}
-	else{
-		collision_info.axis = projection_info_2.projection_axis;
+	if(kind1 == SHAPE_AABB && kind2 == SHAPE_AABB){
+		return box_collision(shape1, shape2);
 	}
-
-	list_free(edges1);
-	list_free(edges2);
-	return collision_info;
+	if(kind1 == SHAPE_AABB && kind2 == SHAPE_CIRCLE){
+		return box_circle_collision(shape1, shape2);
+	}
+	if(kind1 == SHAPE_CIRCLE && kind2 == SHAPE_AABB){
+		CollisionInfo collision_info = box_circle_collision(shape2, shape1);
+		collision_info.axis = vec_negate(collision_info.axis);
+		return collision_info;
+	}
+	return polygon_collision(shape1, shape2);
 }
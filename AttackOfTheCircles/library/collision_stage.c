@@ -0,0 +1,336 @@
+#include "collision_stage.h"
+#include "arena.h"
+#include "collision.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+const size_t INITIAL_CONTACT_CAPACITY = 64;
+const size_t INITIAL_PROXY_CAPACITY = 64;
+
+typedef struct collision_rule{
+    CollisionHandler handler;
+    void *aux;
+    FreeFunc freer;
+    // true if the rule was registered with the types in the opposite order
+    bool swapped;
+} CollisionRule;
+
+// A body's axis-aligned bounds for the broad phase
+typedef struct stage_proxy{
+    Body *body;
+    int type;
+    double min_x;
+    double max_x;
+    double min_y;
+    double max_y;
+} StageProxy;
+
+typedef struct contact{
+    Body *body1;
+    Body *body2;
+    Vector axis;
+    // The rule the pair collided under, so END goes to the same handler
+    // even if a body's type has changed since
+    CollisionRule *rule;
+} Contact;
+
+// An open-addressing hash set of the pairs that are currently touching
+typedef struct contact_set{
+    Contact *entries;
+    size_t capacity;
+    size_t size;
+} ContactSet;
+
+struct collision_stage{
+    size_t num_types;
+    CollisionTyper typer;
+    CollisionRule *rules;
+    bool *collides;
+    StageProxy *proxies;
+    size_t proxies_capacity;
+    // Point into sets, and swap after each tick
+    ContactSet *last_contacts;
+    ContactSet *contacts;
+    ContactSet sets[2];
+};
+
+void contact_set_init(ContactSet *set, size_t capacity){
+    set->entries = calloc(capacity, sizeof(Contact));
+    assert(set->entries);
+    set->capacity = capacity;
+    set->size = 0;
+}
+
+void contact_set_free(ContactSet *set){
+    free(set->entries);
+}
+
+void contact_set_clear(ContactSet *set){
+    memset(set->entries, 0, set->capacity * sizeof(Contact));
+    set->size = 0;
+}
+
+size_t contact_hash(Body *body1, Body *body2){
+    uintptr_t h = (uintptr_t)body1 * 31 + (uintptr_t)body2;
+    h ^= h >> 17;
+    h *= 0x9E3779B1u;
+    return (size_t)(h ^ (h >> 15));
+}
+
+Contact *contact_set_find(ContactSet *set, Body *body1, Body *body2){
+    size_t mask = set->capacity - 1;
+    size_t i = contact_hash(body1, body2) & mask;
+    while(set->entries[i].body1 != NULL){
+        Contact *entry = &set->entries[i];
+        if(entry->body1 == body1 && entry->body2 == body2){
+            return entry;
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+void contact_set_insert(ContactSet *set, Contact contact);
+
+void contact_set_grow(ContactSet *set){
+    Contact *old_entries = set->entries;
+    size_t old_capacity = set->capacity;
+    set->capacity = old_capacity * 2;
+    set->entries = calloc(set->capacity, sizeof(Contact));
+    assert(set->entries);
+    set->size = 0;
+    for(size_t i = 0; i < old_capacity; i++){
+        if(old_entries[i].body1 != NULL){
+            contact_set_insert(set, old_entries[i]);
+        }
+    }
+    free(old_entries);
+}
+
+void contact_set_insert(ContactSet *set, Contact contact){
+    if(2 * (set->size + 1) > set->capacity){
+        contact_set_grow(set);
+    }
+    size_t mask = set->capacity - 1;
+    size_t i = contact_hash(contact.body1, contact.body2) & mask;
+    while(set->entries[i].body1 != NULL){
+        if(set->entries[i].body1 == contact.body1 && set->entries[i].body2 == contact.body2){
+            set->entries[i] = contact;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    set->entries[i] = contact;
+    set->size++;
+}
+
+// Empties a slot, shifting later entries of its probe run back into the gap
+// so every entry stays reachable from its home slot
+void contact_set_remove_at(ContactSet *set, size_t hole){
+    size_t mask = set->capacity - 1;
+    for(size_t i = (hole + 1) & mask; set->entries[i].body1 != NULL; i = (i + 1) & mask){
+        Contact entry = set->entries[i];
+        size_t home = contact_hash(entry.body1, entry.body2) & mask;
+        // The entry can fill the gap unless its home slot lies after the gap
+        if(((i - home) & mask) >= ((i - hole) & mask)){
+            set->entries[hole] = entry;
+            hole = i;
+        }
+    }
+    set->entries[hole] = (Contact){NULL, NULL, VEC_ZERO, NULL};
+    set->size--;
+}
+
+bool contact_is_removed(Contact *entry){
+    return entry->body1 != NULL
+      && (body_is_removed(entry->body1) || body_is_removed(entry->body2));
+}
+
+// Drops contacts with removed bodies, since those are freed at the end of the tick.
+// Works in place, so despawning bodies doesn't allocate.
+void contact_set_purge_removed(ContactSet *set){
+    // Start after an empty slot, so no probe run wraps around behind the scan
+    // (the set is at most half full, so there is one)
+    size_t mask = set->capacity - 1;
+    size_t start = 0;
+    while(set->entries[start].body1 != NULL){
+        start++;
+    }
+    for(size_t n = 1; n <= set->capacity; n++){
+        size_t i = (start + n) & mask;
+        // Removing shifts another entry into the slot, which may be removed too
+        while(contact_is_removed(&set->entries[i])){
+            contact_set_remove_at(set, i);
+        }
+    }
+}
+
+CollisionStage *collision_stage_init(size_t num_types, CollisionTyper typer){
+    assert(typer != NULL);
+    // The stage, its rules and collides never grow, so they share one block,
+    // which is in the scene's arena while a level is being generated
+    size_t rules_bytes = num_types * num_types * sizeof(CollisionRule);
+    CollisionStage *stage = arena_malloc(sizeof(CollisionStage) + rules_bytes
+      + num_types * sizeof(bool));
+    stage->num_types = num_types;
+    stage->typer = typer;
+    stage->rules = (CollisionRule *) (stage + 1);
+    stage->collides = (bool *) ((char *) stage->rules + rules_bytes);
+    memset(stage->rules, 0, rules_bytes + num_types * sizeof(bool));
+    stage->proxies_capacity = INITIAL_PROXY_CAPACITY;
+    stage->proxies = malloc(sizeof(StageProxy) * stage->proxies_capacity);
+    assert(stage->proxies);
+    stage->last_contacts = &stage->sets[0];
+    stage->contacts = &stage->sets[1];
+    contact_set_init(stage->last_contacts, INITIAL_CONTACT_CAPACITY);
+    contact_set_init(stage->contacts, INITIAL_CONTACT_CAPACITY);
+    return stage;
+}
+
+void collision_rule_clear(CollisionStage *stage, int type1, int type2){
+    CollisionRule *rule = &stage->rules[type1 * stage->num_types + type2];
+    CollisionRule *mirror = &stage->rules[type2 * stage->num_types + type1];
+    FreeFunc freer = rule->freer != NULL ? rule->freer : mirror->freer;
+    if(rule->handler != NULL && freer != NULL){
+        freer(rule->aux);
+    }
+    *rule = (CollisionRule){NULL, NULL, NULL, false};
+    *mirror = (CollisionRule){NULL, NULL, NULL, false};
+}
+
+void collision_stage_free(CollisionStage *stage){
+    for(size_t i = 0; i < stage->num_types; i++){
+        for(size_t j = i; j < stage->num_types; j++){
+            collision_rule_clear(stage, i, j);
+        }
+    }
+    free(stage->proxies);
+    contact_set_free(stage->last_contacts);
+    contact_set_free(stage->contacts);
+    arena_release(stage);
+}
+
+void collision_stage_add_handler(CollisionStage *stage, int type1, int type2,
+  CollisionHandler handler, void *aux, FreeFunc freer){
+    assert(handler != NULL);
+    assert(0 <= type1 && type1 < stage->num_types);
+    assert(0 <= type2 && type2 < stage->num_types);
+    collision_rule_clear(stage, type1, type2);
+    stage->rules[type1 * stage->num_types + type2] =
+      (CollisionRule){handler, aux, freer, false};
+    if(type1 != type2){
+        stage->rules[type2 * stage->num_types + type1] =
+          (CollisionRule){handler, aux, NULL, true};
+    }
+    stage->collides[type1] = true;
+    stage->collides[type2] = true;
+}
+
+int compare_proxies(const void *a, const void *b){
+    double min1 = ((const StageProxy *)a)->min_x;
+    double min2 = ((const StageProxy *)b)->min_x;
+    return (min1 > min2) - (min1 < min2);
+}
+
+void collect_proxies(CollisionStage *stage, Scene *scene, size_t *count){
+    size_t body_count = scene_bodies(scene);
+    if(body_count > stage->proxies_capacity){
+        stage->proxies_capacity = body_count * 2;
+        free(stage->proxies);
+        stage->proxies = malloc(sizeof(StageProxy) * stage->proxies_capacity);
+        assert(stage->proxies);
+    }
+    size_t n = 0;
+    for(size_t i = 0; i < body_count; i++){
+        Body *body = scene_get_body(scene, i);
+        if(body_is_removed(body)){
+            continue;
+        }
+        int type = stage->typer(body);
+        if(type < 0 || (size_t)type >= stage->num_types || !stage->collides[type]){
+            continue;
+        }
+        Vector center = body_get_centroid(body);
+        double radius = body_radius(body);
+        stage->proxies[n++] = (StageProxy){
+            body, type,
+            center.x - radius, center.x + radius,
+            center.y - radius, center.y + radius
+        };
+    }
+    qsort(stage->proxies, n, sizeof(StageProxy), compare_proxies);
+    *count = n;
+}
+
+void collide_pair(CollisionStage *stage, StageProxy *proxy1, StageProxy *proxy2){
+    CollisionRule *rule = &stage->rules[proxy1->type * stage->num_types + proxy2->type];
+    if(rule->handler == NULL){
+        return;
+    }
+    Body *body1 = rule->swapped ? proxy2->body : proxy1->body;
+    Body *body2 = rule->swapped ? proxy1->body : proxy2->body;
+    if(body_is_removed(body1) || body_is_removed(body2)){
+        return;
+    }
+    double center_distance = vec_distance(body_get_centroid(body1), body_get_centroid(body2));
+    if(center_distance > body_radius(body1) + body_radius(body2)){
+        return;
+    }
+
+    CollisionInfo collision_info = find_collision(
+      body_get_shape_view(body1), body_get_shape_view(body2));
+    if(!collision_info.collided){
+        return;
+    }
+
+    bool touching = contact_set_find(stage->last_contacts, body1, body2) != NULL;
+    contact_set_insert(stage->contacts, (Contact){body1, body2, collision_info.axis, rule});
+    rule->handler(body1, body2, collision_info.axis, rule->aux,
+      touching ? COLLISION_TOUCHING : COLLISION_START);
+}
+
+void end_separated_contacts(CollisionStage *stage){
+    ContactSet *last = stage->last_contacts;
+    for(size_t i = 0; i < last->capacity; i++){
+        Contact contact = last->entries[i];
+        if(contact.body1 == NULL
+          || body_is_removed(contact.body1) || body_is_removed(contact.body2)
+          || contact_set_find(stage->contacts, contact.body1, contact.body2) != NULL){
+            continue;
+        }
+        // The rule may have been cleared since, but it is never moved
+        CollisionRule *rule = contact.rule;
+        if(rule->handler != NULL){
+            rule->handler(contact.body1, contact.body2, contact.axis, rule->aux,
+              COLLISION_END);
+        }
+    }
+}
+
+void collision_stage_tick(CollisionStage *stage, Scene *scene){
+    size_t n;
+    collect_proxies(stage, scene, &n);
+    contact_set_clear(stage->contacts);
+
+    // Sweep along x; bodies further along can only overlap bodies whose
+    // intervals have not ended yet
+    for(size_t i = 0; i < n; i++){
+        StageProxy *proxy1 = &stage->proxies[i];
+        for(size_t j = i + 1; j < n && stage->proxies[j].min_x <= proxy1->max_x; j++){
+            StageProxy *proxy2 = &stage->proxies[j];
+            if(proxy2->min_y > proxy1->max_y || proxy1->min_y > proxy2->max_y){
+                continue;
+            }
+            collide_pair(stage, proxy1, proxy2);
+        }
+    }
+    end_separated_contacts(stage);
+    contact_set_purge_removed(stage->contacts);
+
+    ContactSet *swap = stage->last_contacts;
+    stage->last_contacts = stage->contacts;
+    stage->contacts = swap;
+}
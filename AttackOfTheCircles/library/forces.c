@@ -1,5 +1,8 @@
 #include "forces.h"
 #include "collision.h"
+#include "quadtree.h"
+#include "pool.h"
+#include "arena.h"
 #include <math.h>
 #include <assert.h>
 
@@ -17,7 +20,8 @@ typedef struct jump_aux{
 
 typedef struct shoot_aux{
     Body *enemy;
-    Body *player;
+    // The enemy keeps shooting after the player is removed, so hold a handle
+    BodyHandle player;
     Scene *scene;
     double chance;
 } ShootAux;
@@ -30,12 +34,27 @@ typedef struct collision_aux{
     bool collided_last_tick;
 } CollisionAux;
 
+// Collisions and pairwise forces are created and dropped with every bullet
+Pool FORCE_AUX_POOL = POOL_INIT(sizeof(ForceAux));
+Pool COLLISION_AUX_POOL = POOL_INIT(sizeof(CollisionAux));
+
 void free_force_aux(ForceAux *force_aux){
-    free(force_aux);
+    list_free(force_aux->bodies);
+    pool_release(&FORCE_AUX_POOL, force_aux);
 }
 
 void free_collision_aux(CollisionAux *collision_aux){
-    free(collision_aux);
+    pool_release(&COLLISION_AUX_POOL, collision_aux);
+}
+
+// Adds a force creator that the scene drops once any of force_aux's bodies is removed.
+// These creators only add forces to their bodies, so they can run in parallel.
+void add_force_aux_creator(Scene *scene, ForceCreator forcer, ForceAux *force_aux){
+    List *bodies = list_init(list_size(force_aux->bodies), NULL);
+    for(size_t i = 0; i < list_size(force_aux->bodies); i++){
+        list_add(bodies, list_get(force_aux->bodies, i));
+    }
+    scene_add_parallel_force_creator(scene, forcer, force_aux, bodies, (FreeFunc)free_force_aux);
 }
 
 void add_forces_gravity(ForceAux* force_aux){
@@ -43,10 +62,10 @@ void add_forces_gravity(ForceAux* force_aux){
     Vector center2 = body_get_centroid(list_get(force_aux->bodies, 1));
     Vector r12 = vec_subtract(center2, center1);
     double distance = sqrt(vec_dot(r12, r12));
-    if(vec_distance(center1, center2) > body_radius(list_get(force_aux->bodies, 0)) + body_radius(list_get(force_aux->bodies, 1))){
+    if(distance > body_radius(list_get(force_aux->bodies, 0)) + body_radius(list_get(force_aux->bodies, 1))){
         double mass1 = body_get_mass(list_get(force_aux->bodies, 0));
         double mass2 = body_get_mass(list_get(force_aux->bodies, 1));
-        double scaling_factor = force_aux->constant * mass1 * mass2 / (pow(distance, 3));
+        double scaling_factor = force_aux->constant * mass1 * mass2 / (distance * distance * distance);
         Vector f12 = vec_multiply(scaling_factor, r12);
         Vector f21 = vec_negate(f12);
 
@@ -56,13 +75,62 @@ void add_forces_gravity(ForceAux* force_aux){
 }
 
 void create_newtonian_gravity(Scene *scene, double G, Body *body1, Body *body2){
-    ForceAux *force_aux = malloc(sizeof(ForceAux));
+    ForceAux *force_aux = pool_alloc(&FORCE_AUX_POOL);
     force_aux->constant = G;
     List *bodies = list_init(0, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
     force_aux->bodies = bodies;
-    scene_add_force_creator(scene, (ForceCreator)add_forces_gravity, force_aux, (FreeFunc)free_force_aux);
+    add_force_aux_creator(scene, (ForceCreator)add_forces_gravity, force_aux);
+}
+
+typedef struct scene_gravity_aux{
+    double constant;
+    double theta;
+    Scene *scene;
+    List *bodies;
+    Quadtree *tree;
+} SceneGravityAux;
+
+void free_scene_gravity_aux(SceneGravityAux *aux){
+    list_free(aux->bodies);
+    quadtree_free(aux->tree);
+    arena_release(aux);
+}
+
+void add_scene_gravity_range(SceneGravityAux *aux, size_t start, size_t end){
+    quadtree_add_gravity_range(aux->tree, aux->constant, aux->theta, start, end);
+}
+
+void add_scene_gravity(SceneGravityAux *aux){
+    List *bodies = aux->bodies;
+    while(list_size(bodies) > 0){
+        list_remove(bodies, list_size(bodies) - 1);
+    }
+    for(size_t i = 0; i < scene_bodies(aux->scene); i++){
+        list_add(bodies, scene_get_body(aux->scene, i));
+    }
+    quadtree_build(aux->tree, bodies);
+    // The tree only pays for itself once there are enough bodies
+    if(list_size(bodies) < SCENE_GRAVITY_MIN_TREE_BODIES || aux->theta <= 0){
+        quadtree_add_gravity(aux->tree, aux->constant, 0);
+        return;
+    }
+    // Each body's walk of the tree only adds to that body
+    scene_parallel_for(aux->scene, quadtree_bodies(aux->tree),
+      (RangeTask)add_scene_gravity_range, aux);
+}
+
+void create_scene_gravity(Scene *scene, double G, double theta){
+    assert(theta >= 0);
+    SceneGravityAux *aux = arena_malloc(sizeof(SceneGravityAux));
+    aux->constant = G;
+    aux->theta = theta;
+    aux->scene = scene;
+    aux->bodies = list_init(0, NULL);
+    aux->tree = quadtree_init();
+    scene_add_force_creator(scene, (ForceCreator)add_scene_gravity, aux,
+      (FreeFunc)free_scene_gravity_aux);
 }
 
 void add_forces_spring(ForceAux *force_aux){
@@ -78,13 +146,13 @@ void add_forces_spring(ForceAux *force_aux){
 
 void create_spring(Scene *scene, double k, Body *body1, Body *body2){
     assert(k >= 0);
-    ForceAux *force_aux = malloc(sizeof(ForceAux));
+    ForceAux *force_aux = pool_alloc(&FORCE_AUX_POOL);
     force_aux->constant = k;
     List *bodies = list_init(0, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
     force_aux->bodies = bodies;
-    scene_add_force_creator(scene, (ForceCreator)add_forces_spring, force_aux, (FreeFunc)free_force_aux);
+    add_force_aux_creator(scene, (ForceCreator)add_forces_spring, force_aux);
 }
 
 void add_forces_drag(ForceAux *force_aux){
@@ -94,12 +162,12 @@ void add_forces_drag(ForceAux *force_aux){
 
 void create_drag(Scene *scene, double gamma, Body *body){
     assert(gamma >= 0);
-    ForceAux *force_aux = malloc(sizeof(ForceAux));
+    ForceAux *force_aux = pool_alloc(&FORCE_AUX_POOL);
     force_aux->constant = gamma;
     List *bodies = list_init(0, NULL);
     list_add(bodies, body);
     force_aux->bodies = bodies;
-    scene_add_force_creator(scene, (ForceCreator)add_forces_drag, force_aux, (FreeFunc)free_force_aux);
+    add_force_aux_creator(scene, (ForceCreator)add_forces_drag, force_aux);
 }
 
 void add_destructive(Body *body1, Body *body2, Vector axis, void *aux, CollisionEventType type){
@@ -137,11 +205,8 @@ void collision_detector(void *aux){
     Body *body2 = list_get(collision_aux->bodies, 1);
     double center_distance = vec_distance(body_get_centroid(body1), body_get_centroid(body2));
     if (center_distance <= body_radius(body1) + body_radius(body2)){
-        List *shape1 = body_get_shape(body1);
-        List *shape2 = body_get_shape(body2);
-        CollisionInfo collision_info = find_collision(shape1, shape2);
-        list_free(shape1);
-        list_free(shape2);
+        CollisionInfo collision_info = find_collision(
+          body_get_shape_view(body1), body_get_shape_view(body2));
         CollisionEventType type = COLLISION_NONE;
         if(collision_info.collided && !collision_aux->collided_last_tick){
             type = COLLISION_START;
@@ -164,7 +229,7 @@ void create_collision(Scene *scene, Body *body1, Body *body2, CollisionHandler h
     list_add(bodies, body1);
     list_add(bodies, body2);
 
-    CollisionAux *collision_aux = malloc(sizeof(CollisionAux));
+    CollisionAux *collision_aux = pool_alloc(&COLLISION_AUX_POOL);
 
     collision_aux->bodies = bodies;
     collision_aux->handler = handler;
@@ -182,7 +247,7 @@ void create_destructive_collision(Scene *scene, Body *body1, Body *body2){
 
 void create_physics_collision(Scene *scene, double elasticity, Body *body1, Body *body2){
     assert (elasticity >= 0);
-    ForceAux *elasticity_aux = malloc(sizeof(ForceAux));
+    ForceAux *elasticity_aux = pool_alloc(&FORCE_AUX_POOL);
     elasticity_aux->constant = elasticity;
     List *bodies = list_init(0, NULL);
     list_add(bodies, body1);
@@ -191,11 +256,15 @@ void create_physics_collision(Scene *scene, double elasticity, Body *body1, Body
     create_collision(scene, body1, body2, (CollisionHandler)add_bounce, elasticity_aux, (FreeFunc)free_force_aux);
 }
 
-void apply_powerup(Body *player, Body *powerup, Vector axis, void *aux){
-    BodyInfo *type = (BodyInfo *)body_get_info(powerup);
+void apply_powerup(Body *player, Body *powerup, Vector axis, void *aux,
+  CollisionEventType type){
+    if(type != COLLISION_START){
+        return;
+    }
+    BodyInfo *powerup_info = (BodyInfo *)body_get_info(powerup);
     BodyInfo *info = (BodyInfo *)body_get_info(player);
     Scene *scene = (Scene *)aux;
-    switch(type->type){
+    switch(powerup_info->type){
         case BULLET_POWERUP:
             info->MAX_BULLETS = info->MAX_BULLETS + 1;
             break;
@@ -211,7 +280,7 @@ void apply_powerup(Body *player, Body *powerup, Vector axis, void *aux){
 void create_powerup_collision(Scene *scene, Body *player, Body *powerup){
     assert(player != NULL);
     assert(body_get_info(powerup) != NULL);
-    create_collision(scene, player, powerup, (CollisionHandler)apply_powerup, scene, NULL);
+    create_collision(scene, player, powerup, apply_powerup, scene, NULL);
 }
 
 void add_platform_gravity(ForceAux *aux){
@@ -226,13 +295,13 @@ void add_platform_gravity(ForceAux *aux){
 
 void create_platform_gravity(Scene *scene, double G,
    Body *body1, Body *body2){
-    ForceAux *force_aux = malloc(sizeof(ForceAux));
+    ForceAux *force_aux = pool_alloc(&FORCE_AUX_POOL);
     force_aux->constant = G;
     List *bodies = list_init(0, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
     force_aux->bodies = bodies;
-    scene_add_force_creator(scene, (ForceCreator)add_platform_gravity, force_aux, (FreeFunc)free_force_aux);
+    add_force_aux_creator(scene, (ForceCreator)add_platform_gravity, force_aux);
 }
 
 void add_friction(ForceAux *aux){
@@ -244,21 +313,24 @@ void add_friction(ForceAux *aux){
 }
 
 void create_friction(Scene *scene, double gamma, Body *body){
-    ForceAux *force_aux = malloc(sizeof(ForceAux));
+    ForceAux *force_aux = pool_alloc(&FORCE_AUX_POOL);
     force_aux->constant = gamma;
     List *bodies = list_init(0, NULL);
     list_add(bodies, body);
     force_aux->bodies = bodies;
-    scene_add_force_creator(scene, (ForceCreator)add_friction, force_aux, (FreeFunc)free_force_aux);
+    add_force_aux_creator(scene, (ForceCreator)add_friction, force_aux);
 }
 
 
 void add_enemy_bullet(ShootAux *aux){
-    double chance = rand() / (float)RAND_MAX;
+    double chance = rng_double(scene_rng(aux->scene));
     if(chance < aux->chance){
         Scene *scene = aux->scene;
         Body *enemy = aux->enemy;
-        Body *player = aux->player;
+        Body *player = scene_get_handle_body(scene, aux->player);
+        if(player == NULL){
+            return;
+        }
         Body *bullet = gen_bullet(100, scene, ENEMY_BULLET);
 
         body_set_centroid(bullet, body_get_centroid(enemy));
@@ -266,21 +338,20 @@ void add_enemy_bullet(ShootAux *aux){
         double angle = atan2(dir.y, dir.x);
         body_set_rotation(bullet, angle);
         body_set_velocity(bullet, vec_rotate(body_get_velocity(bullet), angle));
-
-        add_bullet_forces(scene, bullet);
     }
 }
 
 void create_enemy_bullet(Scene *scene, double chance, Body *enemy, Body *player){
-    ShootAux *shoot_aux = malloc(sizeof(ShootAux));
+    ShootAux *shoot_aux = arena_malloc(sizeof(ShootAux));
     shoot_aux->scene = scene;
     shoot_aux->enemy = enemy;
     shoot_aux->chance = chance;
-    shoot_aux->player = player;
+    shoot_aux->player = scene_get_handle(scene, player);
     List *bodies = list_init(0, NULL);
     list_add(bodies, enemy);
 
-    scene_add_bodies_force_creator(scene, (ForceCreator)add_enemy_bullet, shoot_aux, bodies, free);
+    scene_add_bodies_force_creator(scene, (ForceCreator)add_enemy_bullet, shoot_aux, bodies,
+      arena_release);
 }
 
 void add_player_movement(JumpAux *aux){
@@ -313,12 +384,13 @@ void add_player_movement(JumpAux *aux){
 }
 
 void create_player_movement(Scene *scene, double max_speed, double jump_impulse, Body *player){
-    JumpAux *aux = malloc(sizeof(JumpAux));
+    JumpAux *aux = arena_malloc(sizeof(JumpAux));
     aux->max_horiz_speed = max_speed;
     aux->jump_impulse = jump_impulse;
     aux->player = player;
     aux->key_data = scene_key_data(scene);
     List *bodies = list_init(0, NULL);
     list_add(bodies, player);
-    scene_add_bodies_force_creator(scene, (ForceCreator)add_player_movement, aux, bodies, free);
+    scene_add_bodies_force_creator(scene, (ForceCreator)add_player_movement, aux, bodies,
+      arena_release);
 }
@@ -1,5 +1,7 @@
 #include "gen_forces.h"
 #include "helpers.h"
+#include "collision_stage.h"
+#include <math.h>
 
 const double GRAV = 0.00009;
 const double PLAYER_JUMP_IMPULSE = 7.5E4;
@@ -58,25 +60,29 @@ void add_platform_collision(Body *player, Body *platform, Vector axis, void *aux
     }
 }
 
-void add_enemy_collision(Body *player, Body *enemy, Vector axis, void *aux){
+void add_enemy_collision(Body *player, Body *enemy, Vector axis, void *aux,
+  CollisionEventType type){
+    if(type != COLLISION_START){
+        return;
+    }
     Scene *scene = (Scene *)aux;
     scene_set_done(scene, true);
 }
 
-void create_enemy_collision(Scene *scene, Body *player, Body *enemy){
-    create_collision(scene, player, enemy, (CollisionHandler)add_enemy_collision, scene, NULL);
-}
-
-void add_bullet_collision(Body *bullet, Body *enemy, Vector axis, void *aux){
+void add_bullet_collision(Body *bullet, Body *enemy, Vector axis, void *aux,
+  CollisionEventType type){
+    if(type != COLLISION_START){
+        return;
+    }
     body_remove(enemy);
     body_remove(bullet);
 }
 
-void create_bullet_collision(Scene *scene, Body *bullet, Body *enemy){
-    create_collision(scene, bullet, enemy, (CollisionHandler)add_bullet_collision, scene, NULL);
-}
-
-void add_boss_collision(Body *bullet, Body *boss, Vector axis, void *aux){
+void add_boss_collision(Body *bullet, Body *boss, Vector axis, void *aux,
+  CollisionEventType type){
+    if(type != COLLISION_START){
+        return;
+    }
     BodyInfo *boss_info = body_get_info(boss);
 
     body_remove(bullet);
@@ -86,35 +92,56 @@ void add_boss_collision(Body *bullet, Body *boss, Vector axis, void *aux){
     }
 }
 
-void create_boss_collision(Scene *scene, Body *bullet, Body *enemy){
-    create_collision(scene, bullet, enemy, (CollisionHandler)add_boss_collision, scene, NULL);
-}
-
-void add_spike_collision(Body *spike, Body *boss, Vector axis, void *aux){
-    body_set_velocity(boss, vec_negate(body_get_velocity(boss)));
+void add_spike_collision(Body *spike, Body *boss, Vector axis, void *aux,
+  CollisionEventType type){
+    // Only turn around once per spike, not on every tick of touching it
+    if(type == COLLISION_START){
+        body_set_velocity(boss, vec_negate(body_get_velocity(boss)));
+    }
 }
 
-void create_spike_collision(Scene *scene, Body *spike, Body *enemy){
-    create_collision(scene, spike, enemy, (CollisionHandler)add_spike_collision, scene, NULL);
+int get_collision_type(Body *body){
+    BodyInfo *info = body_get_info(body);
+    return info == NULL ? -1 : (int)info->type;
 }
 
-void create_platform_collision(Scene *scene, Body *player, Body *platform){
-	create_collision(scene, player, platform, (CollisionHandler)add_platform_collision, scene, NULL);
+void add_collision_handlers(Scene *scene){
+    CollisionStage *stage = collision_stage_init(NUM_BODY_TYPES, get_collision_type);
+    CollisionHandler platform = add_platform_collision;
+    CollisionHandler enemy = add_enemy_collision;
+
+    collision_stage_add_handler(stage, PLAYER, FLOOR, platform, scene, NULL);
+    collision_stage_add_handler(stage, PLAYER, MOVING_FLOOR, platform, scene, NULL);
+    collision_stage_add_handler(stage, PLAYER, SPIKE, enemy, scene, NULL);
+    collision_stage_add_handler(stage, PLAYER, ENEMY_BULLET, enemy, scene, NULL);
+    collision_stage_add_handler(stage, PLAYER, BULLET_POWERUP,
+      apply_powerup, scene, NULL);
+    collision_stage_add_handler(stage, PLAYER, FINISHED_LEVEL_POWERUP,
+      apply_powerup, scene, NULL);
+
+    collision_stage_add_handler(stage, ENEMY, FLOOR, platform, scene, NULL);
+    collision_stage_add_handler(stage, ENEMY, MOVING_FLOOR, platform, scene, NULL);
+    collision_stage_add_handler(stage, ENEMY, PLAYER, enemy, scene, NULL);
+
+    collision_stage_add_handler(stage, BOSS, FLOOR, platform, scene, NULL);
+    collision_stage_add_handler(stage, BOSS, PLAYER, enemy, scene, NULL);
+    collision_stage_add_handler(stage, BOSS, SPIKE,
+      add_spike_collision, scene, NULL);
+
+    collision_stage_add_handler(stage, BULLET, ENEMY,
+      add_bullet_collision, scene, NULL);
+    collision_stage_add_handler(stage, BULLET, BOSS,
+      add_boss_collision, scene, NULL);
+
+    scene_set_collision_stage(scene, stage);
 }
 
 void add_player_forces(Scene *scene, Body *player){
 	for(int i = 0; i < scene_bodies(scene); i++){
 		Body *body = scene_get_body(scene, i);
-		if(get_body_type(body) == FLOOR || get_body_type(body) == MOVING_FLOOR){
-			create_platform_collision(scene, player, body);
-		}
-
 		if(get_body_type(body) == GRAVITY_BODY){
 			create_platform_gravity(scene, GRAV, player, body);
 		}
-        if(get_body_type(body) == SPIKE){
-            create_enemy_collision(scene, player, body);
-        }
 	}
 	create_friction(scene, 1000.0, player);
     create_player_movement(scene, PLAYER_MAX_SPEED, PLAYER_JUMP_IMPULSE, player);
@@ -123,12 +150,6 @@ void add_player_forces(Scene *scene, Body *player){
 void add_enemy_forces(Scene *scene, Body *enemy, Body *player){
     for(int i = 0; i < scene_bodies(scene); i++){
 		Body *body = scene_get_body(scene, i);
-		if(get_body_type(body) == FLOOR || get_body_type(body) == MOVING_FLOOR){
-			create_platform_collision(scene, enemy, body);
-		}
-        if(get_body_type(body) == PLAYER){
-            create_enemy_collision(scene, enemy, body);
-        }
         if(get_body_type(body) == GRAVITY_BODY){
             create_platform_gravity(scene, GRAV, enemy, body);
         }
@@ -140,42 +161,16 @@ void add_boss_forces(Scene *scene, Body *enemy){
     Body *player = get_first_body(scene, PLAYER);
     for(int i = 0; i < scene_bodies(scene); i++){
         Body *body = scene_get_body(scene, i);
-        if(get_body_type(body) == FLOOR){
-            create_platform_collision(scene, enemy, body);
-        }
-        if(get_body_type(body) == PLAYER){
-            create_enemy_collision(scene, enemy, body);
-        }
         if(get_body_type(body) == GRAVITY_BODY){
             create_platform_gravity(scene, GRAV, enemy, body);
         }
-        if(get_body_type(body) == SPIKE){
-            create_spike_collision(scene, enemy, body);
-        }
     }
     create_enemy_bullet(scene, SHOOT_CHANCE * 2, enemy, player);
 }
 
-void add_bullet_forces(Scene *scene, Body *bullet){
-    if(get_body_type(bullet) == BULLET){
-        for(int i = 0; i < scene_bodies(scene); i++){
-    		Body *body = scene_get_body(scene, i);
-            if(get_body_type(body) == ENEMY){
-                create_bullet_collision(scene, bullet, body);
-            }
-            if(get_body_type(body) == BOSS){
-                create_boss_collision(scene, bullet, body);
-            }
-    	}
-    }
-    if(get_body_type(bullet) == ENEMY_BULLET){
-        Body *player = get_first_body(scene, PLAYER);
-        create_enemy_collision(scene, player, bullet);
-    }
-}
-
 void gen_forces(Scene *scene){
     Body *player = get_first_body(scene, PLAYER);
+    add_collision_handlers(scene);
 	add_player_forces(scene, player);
     for(int i = 0; i < scene_bodies(scene); i++){
         Body *curr = scene_get_body(scene, i);
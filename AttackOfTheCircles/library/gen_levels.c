@@ -4,6 +4,8 @@
 #include "enemies.h"
 #include "sdl_wrapper.h"
 #include "gen_forces.h"
+#include "pool.h"
+#include "arena.h"
 #include <math.h>
 
 const RGBColor BLACK = (RGBColor){0,0,0};
@@ -20,15 +22,17 @@ const double GRAVITY_Y_OFFSET = -5E6;
 const double TRIANGLE_RADIUS = 50;
 const double BULL_SPEED = 1500;
 
+Pool BODY_INFO_POOL = POOL_INIT(sizeof(BodyInfo));
+
 void body_info_free(BodyInfo *body_info){
-    free(body_info);
+    pool_release(&BODY_INFO_POOL, body_info);
 }
 BODY_TYPE get_body_type(Body *powerup){
     return ((BodyInfo *)body_get_info(powerup))->type;
 }
 
 BodyInfo *create_body_info(BODY_TYPE type, BODY_MOVEMENT movement){
-    BodyInfo *info = malloc(sizeof(BodyInfo));
+    BodyInfo *info = pool_alloc(&BODY_INFO_POOL);
     info->type = type;
     info->movement = movement;
     info->touch = TOUCHING_NONE;
@@ -39,13 +43,12 @@ BodyInfo *create_body_info(BODY_TYPE type, BODY_MOVEMENT movement){
     return info;
 }
 
-Body* add_powerup(Scene *scene, Body *player, double radius, double mass,
+Body* add_powerup(Scene *scene, double radius, double mass,
   Vector centroid, RGBColor color, BODY_TYPE powerup_type){
     BodyInfo *info = create_body_info(powerup_type, NONE);
     Body *powerup = body_init_with_info(shape_estrella(radius), mass, color, info, (FreeFunc)body_info_free);
     body_set_centroid(powerup, centroid);
     scene_add_body(scene, powerup);
-    create_powerup_collision(scene, player, powerup);
     return powerup;
 }
 
@@ -79,7 +82,7 @@ Body* add_moving_platform(Scene* scene, double width, double height, double mass
 
 Body* add_spike(Scene *scene, double radius, Vector spawn_point){
     BodyInfo *info = create_body_info(SPIKE, NONE);
-    List *shape = shape_triangle(radius);
+    VectorList *shape = shape_triangle(radius);
     Body *spike = body_init_with_info(shape, M, RED, info, (FreeFunc)body_info_free);
     body_set_centroid(spike, spawn_point);
     scene_add_body(scene, spike);
@@ -115,14 +118,16 @@ void add_moving_upsidedown_spike(Scene *scene, double radius, Vector spawn_point
 // adds a body between two floors body1 and body2 by connecting the necessary points.
 // body1 is on the left, and body2 is on the right.
 Body* add_sloped_floor(Scene *scene, Body* body1, Body* body2, double mass, RGBColor color){
-  List *floor_points = list_init(4, free);
-  List *shape1 = body_get_shape(body1);
-  List *shape2 = body_get_shape(body2);
+  VectorList *floor_points = vec_list_init(4);
+  VectorList *shape1 = body_get_shape(body1);
+  VectorList *shape2 = body_get_shape(body2);
 
-  list_add(floor_points, list_get(shape2, 1));
-  list_add(floor_points, list_get(shape1, 0));
-  list_add(floor_points, list_get(shape1, 3));
-  list_add(floor_points, list_get(shape2, 2));
+  vec_list_add(floor_points, vec_list_get(shape2, 1));
+  vec_list_add(floor_points, vec_list_get(shape1, 0));
+  vec_list_add(floor_points, vec_list_get(shape1, 3));
+  vec_list_add(floor_points, vec_list_get(shape2, 2));
+  vec_list_free(shape1);
+  vec_list_free(shape2);
 
   BodyInfo *info = create_body_info(FLOOR, NONE);
   Body *sloped_floor = body_init_with_info(floor_points, mass, color,
@@ -133,41 +138,30 @@ Body* add_sloped_floor(Scene *scene, Body* body1, Body* body2, double mass, RGBC
 
 void add_stairs(Scene *scene, Body* body1, Body* body2, double mass, double player_size,
    RGBColor color){
-     List *shape1 = body_get_shape(body1);
-     List *shape2 = body_get_shape(body2);
+     VectorList *shape1 = body_get_shape(body1);
+     VectorList *shape2 = body_get_shape(body2);
 
      // Points labeled 0, 1, 2, 3 counterclockwise from top right.
-     Vector *shape1_pt3 = malloc(sizeof(Vector));
-     *shape1_pt3 = *(Vector *)list_get(shape1, 3);
-     Vector *shape1_pt0 = malloc(sizeof(Vector));
-     *shape1_pt0 = *(Vector *)list_get(shape1, 0);
-     Vector *shape2_pt1 = malloc(sizeof(Vector));
-     *shape2_pt1 = *(Vector *)list_get(shape2, 1);
+     Vector shape1_pt3 = vec_list_get(shape1, 3);
+     Vector shape1_pt0 = vec_list_get(shape1, 0);
+     Vector shape2_pt1 = vec_list_get(shape2, 1);
+     vec_list_free(shape1);
+     vec_list_free(shape2);
 
-    int num_stairs = (int) (shape2_pt1->y - shape1_pt0->y)/player_size;
-    double stair_width = (shape2_pt1->x - shape1_pt0->x)/num_stairs;
+    int num_stairs = (int) (shape2_pt1.y - shape1_pt0.y)/player_size;
+    double stair_width = (shape2_pt1.x - shape1_pt0.x)/num_stairs;
 
     for (int i = 0; i < num_stairs; i++){
-      List *stair_points = list_init(4, free);
+      VectorList *stair_points = vec_list_init(4);
       Vector add_0 = {(i + 1) * stair_width, (i + 1) * player_size};
       Vector add_1 = {i * stair_width, (i + 1) * player_size};
       Vector add_2 = {i * stair_width, 0};
       Vector add_3 = {(i + 1) * stair_width, 0};
 
-      Vector *stair_pt0 = malloc(sizeof(Vector));
-      Vector *stair_pt1 = malloc(sizeof(Vector));
-      Vector *stair_pt2 = malloc(sizeof(Vector));
-      Vector *stair_pt3 = malloc(sizeof(Vector));
-
-      *stair_pt0 = vec_add(*shape1_pt0, add_0);
-      *stair_pt1 = vec_add(*shape1_pt0, add_1);
-      *stair_pt2 = vec_add(*shape1_pt3, add_2);
-      *stair_pt3 = vec_add(*shape1_pt3, add_3);
-
-      list_add(stair_points, stair_pt0);
-      list_add(stair_points, stair_pt1);
-      list_add(stair_points, stair_pt2);
-      list_add(stair_points, stair_pt3);
+      vec_list_add(stair_points, vec_add(shape1_pt0, add_0));
+      vec_list_add(stair_points, vec_add(shape1_pt0, add_1));
+      vec_list_add(stair_points, vec_add(shape1_pt3, add_2));
+      vec_list_add(stair_points, vec_add(shape1_pt3, add_3));
 
       double j = (double) i;
       RGBColor color1 = (RGBColor) {1/(j+2), 1/(j+43), 1/(j+16)};
@@ -188,7 +182,7 @@ void one_by_two_floors(Scene* scene, double mass, RGBColor color, List* centroid
 }
 
 Body *gen_player_sq(double player_size, Scene *scene){
-    List *shape = shape_rectangle(player_size, player_size);
+    VectorList *shape = shape_rectangle(player_size, player_size);
     BodyInfo *info = create_body_info(PLAYER, FALLING);
     Body *rect = body_init_with_info(shape, PLAYER_MASS, GREEN, info, (FreeFunc)body_info_free);
     body_set_centroid(rect, (Vector){player_size*2, player_size*2});
@@ -197,7 +191,7 @@ Body *gen_player_sq(double player_size, Scene *scene){
 }
 
 Body *gen_bullet(double player_size, Scene *scene, BODY_TYPE btype){
-    List *shape = shape_estrella(player_size/5);
+    VectorList *shape = shape_estrella(player_size/5);
     BodyInfo *info = create_body_info(btype, NONE);
     Body *star = body_init_with_info(shape, 20, BLUE, info, (FreeFunc)body_info_free);
     Body *player = get_first_body(scene, PLAYER);
@@ -215,36 +209,37 @@ void gen_tutorial_level(double player_size, Scene *scene, Body *player){
       INFINITY, (Vector){10 * player_size, 1.5 * player_size}, BLACK, FLOOR);
     add_spike_row(scene, TRIANGLE_RADIUS, (Vector){22.5 * player_size, 1.3 * TRIANGLE_RADIUS}, 2);
     gen_enemy(70, 50, scene, (Vector){28 * player_size, 3.5 * player_size});
-    add_powerup(scene, player, 60, INFINITY, (Vector){45.75 * player_size, 1.5 * player_size}, BLUE, BULLET_POWERUP);
+    add_powerup(scene, 60, INFINITY, (Vector){45.75 * player_size, 1.5 * player_size}, BLUE, BULLET_POWERUP);
     add_rectangle_floor(scene, 2 * player_size, 3 * player_size,
       INFINITY, (Vector){55 * player_size, 1.5 * player_size}, BLACK, FLOOR);
-    add_powerup(scene, player, 60, INFINITY, (Vector){70 * player_size, 1.5 * player_size}, GREEN, FINISHED_LEVEL_POWERUP);
+    add_powerup(scene, 60, INFINITY, (Vector){70 * player_size, 1.5 * player_size}, GREEN, FINISHED_LEVEL_POWERUP);
 }
 
 void gen_first_level(double player_size, Scene *scene, Body *player){
 
     add_gravity_body(scene);
 
-    List *one_by_two_centroids = list_init(6, free);
-    Vector *v = malloc(sizeof(Vector));
+    List *one_by_two_centroids = list_init(6, arena_release);
+    Vector *v = arena_malloc(sizeof(Vector));
     *v = (Vector){17 * player_size, 5.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){20 * player_size, 7.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){23 * player_size, 9.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){52 * player_size, 1.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){55 * player_size, 2.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){58 * player_size, 3.5 * player_size};
     list_add(one_by_two_centroids, v);
     one_by_two_floors(scene, INFINITY, BLACK, one_by_two_centroids, player_size);
+    list_free(one_by_two_centroids);
 
     add_rectangle_floor(scene, 8 * player_size, player_size,
       INFINITY, (Vector){4 * player_size, 0}, BLACK, FLOOR);
@@ -254,7 +249,7 @@ void gen_first_level(double player_size, Scene *scene, Body *player){
       (Vector){14.5 * player_size, 4 * player_size}, (Vector){0, 2 * player_size}, BLACK);
     add_rectangle_floor(scene, 6 * player_size, player_size,
       INFINITY, (Vector){28 * player_size, 11.5 * player_size}, BLACK, FLOOR);
-    add_powerup(scene, player, 0.5 * player_size, INFINITY,
+    add_powerup(scene, 0.5 * player_size, INFINITY,
       (Vector){28 * player_size, 13 * player_size}, BLUE, (BODY_TYPE) BULLET_POWERUP);
     Body *body8 = add_rectangle_floor(scene, 9 * player_size, player_size,
       INFINITY, (Vector){18.5 * player_size, 0}, BLACK, FLOOR);
@@ -276,7 +271,7 @@ void gen_first_level(double player_size, Scene *scene, Body *player){
       (Vector){94 * player_size, 8 * player_size}, (Vector){3 * player_size, 3 * player_size}, BLACK);
     add_rectangle_floor(scene, 20 * player_size, 2 * player_size,
       INFINITY, (Vector){114 * player_size, 11.5 * player_size}, BLACK, FLOOR);
-    add_powerup(scene, player, 60, INFINITY, (Vector){120 * player_size, 13.5 * player_size},
+    add_powerup(scene, 60, INFINITY, (Vector){120 * player_size, 13.5 * player_size},
       GREEN, FINISHED_LEVEL_POWERUP);
     gen_enemy(70, 50, scene, (Vector){2820, 300});
     gen_enemy(70, 50, scene, (Vector){7157, 420});
@@ -286,38 +281,39 @@ void gen_first_level(double player_size, Scene *scene, Body *player){
 void gen_second_level(double player_size, Scene *scene, Body *player){
   add_gravity_body(scene);
 
-  List *one_by_two_centroids = list_init(6, free);
-  Vector *v = malloc(sizeof(Vector));
+  List *one_by_two_centroids = list_init(6, arena_release);
+  Vector *v = arena_malloc(sizeof(Vector));
   *v = (Vector){27 * player_size, 6.25 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){24 * player_size, 7.25 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){21 * player_size, 8.25 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){21 * player_size, 11.75 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){35 * player_size, 5.5 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){43 * player_size, 5.5 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){51 * player_size, 5.5 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){54 * player_size, 12.5 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){57 * player_size, 10.5 * player_size};
   list_add(one_by_two_centroids, v);
-  v = malloc(sizeof(Vector));
+  v = arena_malloc(sizeof(Vector));
   *v = (Vector){60 * player_size, 5.5 * player_size};
   list_add(one_by_two_centroids, v);
   one_by_two_floors(scene, INFINITY, BLACK, one_by_two_centroids, player_size);
+  list_free(one_by_two_centroids);
 
   add_moving_platform(scene, 2 * player_size, player_size,  M, S,
     (Vector){18 * player_size, 10 * player_size}, (Vector){2 * player_size, 0}, BLACK);
@@ -355,7 +351,7 @@ void gen_second_level(double player_size, Scene *scene, Body *player){
     INFINITY, (Vector){70.5 * player_size, 7 * player_size}, BLACK, FLOOR);
   add_rectangle_floor(scene, 1 * player_size, 2 * player_size,
     INFINITY, (Vector){77.5 * player_size, 7 * player_size}, BLACK, FLOOR);
-  add_powerup(scene, player, 60, INFINITY, (Vector){96 * player_size, 7.5 * player_size},
+  add_powerup(scene, 60, INFINITY, (Vector){96 * player_size, 7.5 * player_size},
     GREEN, FINISHED_LEVEL_POWERUP);
 }
 
@@ -363,41 +359,42 @@ void gen_third_level(double player_size, Scene *scene, Body *player){
 
     add_gravity_body(scene);
 
-    List *one_by_two_centroids = list_init(6, free);
-    Vector *v = malloc(sizeof(Vector));
+    List *one_by_two_centroids = list_init(6, arena_release);
+    Vector *v = arena_malloc(sizeof(Vector));
     *v = (Vector){11 * player_size, 0.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){14 * player_size, 1.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){17 * player_size, 2.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){20 * player_size, 3.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){23 * player_size, 4.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){35 * player_size, 4.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){38 * player_size, 3.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){41 * player_size, 2.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){44 * player_size, 1.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){47 * player_size, 0.5 * player_size};
     list_add(one_by_two_centroids, v);
-    v = malloc(sizeof(Vector));
+    v = arena_malloc(sizeof(Vector));
     *v = (Vector){81 * player_size, 8.5 * player_size};
     list_add(one_by_two_centroids, v);
     one_by_two_floors(scene, INFINITY, BLACK, one_by_two_centroids, player_size);
+    list_free(one_by_two_centroids);
 
     gen_enemy(70, 50, scene, (Vector){2833, 665});
     gen_enemy(70, 50, scene, (Vector){5432, 120});
@@ -423,7 +420,7 @@ void gen_third_level(double player_size, Scene *scene, Body *player){
     add_rectangle_floor(scene, 8 * player_size, player_size,
       INFINITY, (Vector){67 * player_size, 13.5 * player_size}, BLACK, FLOOR);
 
-    add_powerup(scene, player, 0.5 * player_size, INFINITY,
+    add_powerup(scene, 0.5 * player_size, INFINITY,
       (Vector){66.5 * player_size, 10.5 * player_size}, BLUE, (BODY_TYPE) BULLET_POWERUP);
 
     add_moving_platform(scene, 2 * player_size, player_size,  M, S,
@@ -439,7 +436,7 @@ void gen_third_level(double player_size, Scene *scene, Body *player){
 
     add_rectangle_floor(scene, 8 * player_size, player_size,
       INFINITY, (Vector){105 * player_size, 9.5 * player_size}, BLACK, FLOOR);
-    add_powerup(scene, player, 60, INFINITY, (Vector){109 * player_size, 11 * player_size},
+    add_powerup(scene, 60, INFINITY, (Vector){109 * player_size, 11 * player_size},
       GREEN, FINISHED_LEVEL_POWERUP);
 }
 
@@ -458,10 +455,10 @@ void gen_boss_level(double player_size, Scene *scene, Body *player){
     add_moving_upsidedown_spike(scene, TRIANGLE_RADIUS, (Vector){0 * player_size, 4 * TRIANGLE_RADIUS}, (Vector){0, player_size}, S * 1.5);
     add_spike_row(scene, TRIANGLE_RADIUS, (Vector){8 * player_size, 1.3 * TRIANGLE_RADIUS}, 5);
 
-    add_powerup(scene, player, 60, INFINITY, (Vector){-5 * player_size, 1.5 * player_size}, BLUE, BULLET_POWERUP);
-    add_powerup(scene, player, 60, INFINITY, (Vector){6 * player_size, 1.5 * player_size}, BLUE, BULLET_POWERUP);
+    add_powerup(scene, 60, INFINITY, (Vector){-5 * player_size, 1.5 * player_size}, BLUE, BULLET_POWERUP);
+    add_powerup(scene, 60, INFINITY, (Vector){6 * player_size, 1.5 * player_size}, BLUE, BULLET_POWERUP);
 
     add_boss_forces(scene, gen_boss(700, scene, (Vector){18*player_size, 4 * player_size}));
-    add_powerup(scene, player, 60, INFINITY, (Vector){18 * player_size, 4 * player_size},
+    add_powerup(scene, 60, INFINITY, (Vector){18 * player_size, 4 * player_size},
       GREEN, FINISHED_LEVEL_POWERUP);
 }
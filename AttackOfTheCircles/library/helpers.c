@@ -15,8 +15,26 @@ List *get_bodies_type(Scene *scene, BODY_TYPE type){
 }
 
 Body *get_first_body(Scene *scene, BODY_TYPE type){
-    List *list = get_bodies_type(scene, type);
-    Body *body = list_get(list, 0);
-    list_free(list);
-    return body;
+    for(int i = 0; i < scene_bodies(scene); i++){
+        Body *curr_body = scene_get_body(scene, i);
+        BodyInfo *body_info = (BodyInfo*)body_get_info(curr_body);
+        if(body_info->type == type){
+            return curr_body;
+        }
+    }
+    return NULL;
+}
+
+List *get_bodies_type_near(Scene *scene, BODY_TYPE type, Vector min, Vector max){
+    List *nearby = scene_query_aabb(scene, min, max);
+    List *list = list_init(1, NULL);
+    for(size_t i = 0; i < list_size(nearby); i++){
+        Body *curr_body = list_get(nearby, i);
+        BodyInfo *body_info = (BodyInfo*)body_get_info(curr_body);
+        if(body_info->type == type){
+            list_add(list, curr_body);
+        }
+    }
+    list_free(nearby);
+    return list;
 }
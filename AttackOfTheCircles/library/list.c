@@ -1,11 +1,39 @@
 #include "list.h"
+#include "pool.h"
+#include "arena.h"
 #include <stdlib.h>
 #include <assert.h>
 
+// Lists with room for up to this many elements use arrays from LIST_DATA_POOL,
+// so the many small lists (e.g. each force handler's bodies) don't call malloc
+const size_t POOLED_LIST_CAPACITY = 4;
+
+Pool LIST_POOL = POOL_INIT(sizeof(List));
+Pool LIST_DATA_POOL = POOL_INIT(4 * sizeof(void*));
+
+void** list_data_alloc(size_t capacity){
+  if(capacity == POOLED_LIST_CAPACITY){
+    return pool_alloc(&LIST_DATA_POOL);
+  }
+  return arena_malloc(sizeof(void*)*capacity);
+}
+
+void list_data_release(void** data, size_t capacity){
+  if(capacity == POOLED_LIST_CAPACITY){
+    pool_release(&LIST_DATA_POOL, data);
+  }
+  else{
+    arena_release(data);
+  }
+}
+
 List* list_init(size_t initial_size, FreeFunc freeObj){
   assert(initial_size >= 0);
-  List* list = malloc(sizeof(List));
-  list->data = malloc(sizeof(void*)*initial_size);
+  List* list = pool_alloc(&LIST_POOL);
+  if(initial_size < POOLED_LIST_CAPACITY){
+    initial_size = POOLED_LIST_CAPACITY;
+  }
+  list->data = list_data_alloc(initial_size);
   list->capacity = initial_size;
   list->size = 0;
   list->freeObj = freeObj;
@@ -18,8 +46,8 @@ void list_free(List* list){
           list->freeObj(list->data[i]);
         }
     }
-    free(list->data);
-    free(list);
+    list_data_release(list->data, list->capacity);
+    pool_release(&LIST_POOL, list);
 }
 
 // list->size is the number of elements in the list, not according to indices.
@@ -40,11 +68,11 @@ void list_set(List* list, size_t index, void* value){
 
 void list_increase_capacity(List* list){
   size_t new_capacity = (list->capacity + 1) * 2;
-  void** new_data = malloc(sizeof(void*)*new_capacity);
+  void** new_data = list_data_alloc(new_capacity);
   for(int i = 0; i < list->size; i++){
     new_data[i] = list->data[i];
   }
-  free(list->data);
+  list_data_release(list->data, list->capacity);
   list->data = new_data;
   list->capacity = new_capacity;
 }
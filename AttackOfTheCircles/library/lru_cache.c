@@ -0,0 +1,191 @@
+#include "lru_cache.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The constants of 64-bit FNV-1a hashing
+const uint64_t FNV_OFFSET = 0xCBF29CE484222325;
+const uint64_t FNV_PRIME = 0x100000001B3;
+
+typedef struct lru_entry{
+    char *key;
+    uint64_t hash;
+    void *value;
+    // The next entry in the same bucket
+    struct lru_entry *next;
+    // The neighbours in the order of use, from the newest to the oldest
+    struct lru_entry *newer;
+    struct lru_entry *older;
+} LruEntry;
+
+struct lru_cache{
+    size_t capacity;
+    size_t size;
+    // All the entries there will ever be, allocated up front
+    LruEntry *entries;
+    // Chains of entries by hash; the number of buckets is a power of two
+    LruEntry **buckets;
+    size_t bucket_mask;
+    LruEntry *newest;
+    LruEntry *oldest;
+    FreeFunc freer;
+};
+
+uint64_t lru_hash(const char *key){
+    uint64_t hash = FNV_OFFSET;
+    for(const char *c = key; *c != '\0'; c++){
+        hash = (hash ^ (unsigned char)*c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+LruCache *lru_cache_init(size_t capacity, FreeFunc freer){
+    assert(capacity > 0);
+    LruCache *cache = malloc(sizeof(LruCache));
+    assert(cache);
+    cache->capacity = capacity;
+    cache->size = 0;
+    cache->entries = malloc(sizeof(LruEntry) * capacity);
+    assert(cache->entries);
+    // At least twice as many buckets as entries keeps the chains short
+    size_t buckets = 1;
+    while(buckets < 2 * capacity){
+        buckets *= 2;
+    }
+    cache->buckets = calloc(buckets, sizeof(LruEntry *));
+    assert(cache->buckets);
+    cache->bucket_mask = buckets - 1;
+    cache->newest = NULL;
+    cache->oldest = NULL;
+    cache->freer = freer;
+    return cache;
+}
+
+void lru_cache_free(LruCache *cache){
+    lru_cache_clear(cache);
+    free(cache->buckets);
+    free(cache->entries);
+    free(cache);
+}
+
+// Finds the entry with a key, or returns NULL
+LruEntry *lru_find(LruCache *cache, const char *key, uint64_t hash){
+    for(LruEntry *entry = cache->buckets[hash & cache->bucket_mask]; entry != NULL;
+      entry = entry->next){
+        if(entry->hash == hash && strcmp(entry->key, key) == 0){
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void lru_unlink(LruCache *cache, LruEntry *entry){
+    if(entry->newer != NULL){
+        entry->newer->older = entry->older;
+    }
+    else{
+        cache->newest = entry->older;
+    }
+    if(entry->older != NULL){
+        entry->older->newer = entry->newer;
+    }
+    else{
+        cache->oldest = entry->newer;
+    }
+}
+
+void lru_push_newest(LruCache *cache, LruEntry *entry){
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if(cache->newest != NULL){
+        cache->newest->newer = entry;
+    }
+    else{
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+}
+
+void lru_free_value(LruCache *cache, void *value){
+    if(cache->freer != NULL){
+        cache->freer(value);
+    }
+}
+
+// Takes the oldest entry out of the cache, freeing its key and value,
+// and returns it to be reused
+LruEntry *lru_evict(LruCache *cache){
+    LruEntry *entry = cache->oldest;
+    lru_unlink(cache, entry);
+    LruEntry **link = &cache->buckets[entry->hash & cache->bucket_mask];
+    while(*link != entry){
+        link = &(*link)->next;
+    }
+    *link = entry->next;
+    free(entry->key);
+    lru_free_value(cache, entry->value);
+    return entry;
+}
+
+void *lru_cache_get(LruCache *cache, const char *key){
+    LruEntry *entry = lru_find(cache, key, lru_hash(key));
+    if(entry == NULL){
+        return NULL;
+    }
+    if(entry != cache->newest){
+        lru_unlink(cache, entry);
+        lru_push_newest(cache, entry);
+    }
+    return entry->value;
+}
+
+void lru_cache_put(LruCache *cache, const char *key, void *value){
+    uint64_t hash = lru_hash(key);
+    LruEntry *entry = lru_find(cache, key, hash);
+    if(entry != NULL){
+        if(entry->value != value){
+            lru_free_value(cache, entry->value);
+        }
+        entry->value = value;
+        lru_unlink(cache, entry);
+        lru_push_newest(cache, entry);
+        return;
+    }
+    if(cache->size == cache->capacity){
+        entry = lru_evict(cache);
+    }
+    else{
+        entry = &cache->entries[cache->size];
+        cache->size++;
+    }
+    size_t length = strlen(key) + 1;
+    entry->key = malloc(length);
+    assert(entry->key);
+    memcpy(entry->key, key, length);
+    entry->hash = hash;
+    entry->value = value;
+    LruEntry **bucket = &cache->buckets[hash & cache->bucket_mask];
+    entry->next = *bucket;
+    *bucket = entry;
+    lru_push_newest(cache, entry);
+}
+
+bool lru_cache_contains(LruCache *cache, const char *key){
+    return lru_find(cache, key, lru_hash(key)) != NULL;
+}
+
+size_t lru_cache_size(LruCache *cache){
+    return cache->size;
+}
+
+void lru_cache_clear(LruCache *cache){
+    for(size_t i = 0; i < cache->size; i++){
+        free(cache->entries[i].key);
+        lru_free_value(cache, cache->entries[i].value);
+    }
+    memset(cache->buckets, 0, sizeof(LruEntry *) * (cache->bucket_mask + 1));
+    cache->size = 0;
+    cache->newest = NULL;
+    cache->oldest = NULL;
+}
@@ -1,45 +1,49 @@
 #include <math.h>
 #include "polygon.h"
+#include "vec_batch.h"
 
-double polygon_area(VectorList *polygon){
-  double area = 0.0;
-  size_t numVertices = vec_list_size(polygon);
-  for(size_t i = 0; i < numVertices; i++){
-    Vector v1 = vec_list_get(polygon, i);
-    Vector v2 = vec_list_get(polygon, (i+1)%numVertices);
-    area += vec_cross(v1, v2);
-  }
-  area = 0.5 * area;
-  return area;
+double polygon_area(const VectorList *polygon){
+  return 0.5 * vec_batch_shoelace(polygon->data, polygon->size, NULL);
 }
 
-Vector polygon_centroid(VectorList* polygon){
-  Vector centroid = VEC_ZERO;
-  size_t numVertices = vec_list_size(polygon);
-  for(size_t i = 0; i < numVertices; i++){
-    Vector v1 = vec_list_get(polygon, i);
-    Vector v2 = vec_list_get(polygon, (i+1)%numVertices);
-    double cross = vec_cross(v1, v2);
-    centroid = vec_add(vec_multiply(cross, vec_add(v1, v2)), centroid);
-  }
-  centroid = vec_multiply(1.0/(6*polygon_area(polygon)), centroid);
-  return centroid;
+Vector polygon_centroid(const VectorList* polygon){
+  Vector moment;
+  double area = 0.5 * vec_batch_shoelace(polygon->data, polygon->size, &moment);
+  return vec_multiply(1.0/(6*area), moment);
 }
 
 
 void polygon_translate(VectorList* polygon, Vector translation){
-  for(size_t i = 0; i < vec_list_size(polygon); i++){
-    Vector translatedVector = vec_add(vec_list_get(polygon, i), translation);
-    vec_list_set(polygon, i, translatedVector);
-  }
+  vec_batch_translate(polygon->data, polygon->data, polygon->size, translation);
 }
 
 
 void polygon_rotate(VectorList* polygon, double angle, Vector point){
-  polygon_translate(polygon, vec_negate(point));
-  for(size_t i = 0; i < vec_list_size(polygon); i++){
-    Vector rotatedVector = vec_rotate(vec_list_get(polygon, i), angle);
-    vec_list_set(polygon, i, rotatedVector);
+  vec_batch_rotate(polygon->data, polygon->data, polygon->size, cos(angle), sin(angle),
+    point, point);
+  if(polygon->kind == SHAPE_AABB && angle != 0){
+    polygon->kind = SHAPE_POLYGON;
+  }
+}
+
+bool polygon_is_convex(const VectorList *polygon){
+  size_t n = polygon->size;
+  // Every turn must go the same way; collinear vertices don't turn at all
+  bool left = false, right = false;
+  for(size_t i = 0; i < n; i++){
+    Vector a = polygon->data[i];
+    Vector b = polygon->data[(i + 1) % n];
+    Vector c = polygon->data[(i + 2) % n];
+    double turn = vec_cross(vec_subtract(b, a), vec_subtract(c, b));
+    if(turn > 0){
+      left = true;
+    }
+    else if(turn < 0){
+      right = true;
+    }
+    if(left && right){
+      return false;
+    }
   }
-  polygon_translate(polygon, point);
+  return true;
 }
@@ -0,0 +1,165 @@
+#include "pool.h"
+#include "arena.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Poison free objects under asan, so using a released object is still reported
+#if defined(__SANITIZE_ADDRESS__)
+#define POOL_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define POOL_ASAN
+#endif
+#endif
+
+#ifdef POOL_ASAN
+#include <sanitizer/asan_interface.h>
+#define POOL_POISON(object, size) ASAN_POISON_MEMORY_REGION(object, size)
+#define POOL_UNPOISON(object, size) ASAN_UNPOISON_MEMORY_REGION(object, size)
+#else
+#define POOL_POISON(object, size) ((void)(object), (void)(size))
+#define POOL_UNPOISON(object, size) ((void)(object), (void)(size))
+#endif
+
+const size_t POOL_CHUNK_BYTES = 16384;
+const size_t POOL_MIN_CHUNK_OBJECTS = 16;
+
+// The distance between objects in a chunk: big enough for the free list
+// pointer, and a multiple of the strictest alignment
+size_t pool_stride(Pool *pool){
+    size_t align = alignof(max_align_t);
+    size_t size = pool->object_size < sizeof(void *) ? sizeof(void *) : pool->object_size;
+    return (size + align - 1) / align * align;
+}
+
+// The number of threads that have used a pool so far; each thread's shard
+// is its number modulo POOL_SHARDS
+atomic_size_t POOL_THREADS = 0;
+_Thread_local size_t POOL_THREAD_SHARD = SIZE_MAX;
+
+size_t pool_shard_index(void){
+    if(POOL_THREAD_SHARD == SIZE_MAX){
+        POOL_THREAD_SHARD = atomic_fetch_add(&POOL_THREADS, 1) % POOL_SHARDS;
+    }
+    return POOL_THREAD_SHARD;
+}
+
+// Spins until the flag is clear. A shard's lock is almost always free,
+// since only the threads sharing the shard and rare thieves take it
+void pool_lock(atomic_flag *lock){
+    while(atomic_flag_test_and_set_explicit(lock, memory_order_acquire)){
+    }
+}
+
+void pool_unlock(atomic_flag *lock){
+    atomic_flag_clear_explicit(lock, memory_order_release);
+}
+
+// Allocates a chunk and threads its objects onto a shard's free list
+void pool_grow(Pool *pool, PoolShard *shard){
+    size_t stride = pool_stride(pool);
+    size_t count = POOL_CHUNK_BYTES / stride;
+    if(count < POOL_MIN_CHUNK_OBJECTS){
+        count = POOL_MIN_CHUNK_OBJECTS;
+    }
+    // The first stride holds the link to the previous chunk
+    char *chunk = malloc(stride * (count + 1));
+    assert(chunk);
+    pool_lock(&pool->chunks_lock);
+    *(void **)chunk = pool->chunks;
+    pool->chunks = chunk;
+    pool_unlock(&pool->chunks_lock);
+    for(size_t i = count; i > 0; i--){
+        void *object = chunk + i * stride;
+        *(void **)object = shard->free_list;
+        shard->free_list = object;
+        POOL_POISON(object, stride);
+    }
+}
+
+// Moves every free object of another shard to an empty one, e.g. when one
+// thread allocates objects that another releases. Only takes shards that
+// aren't locked, since the caller holds its own shard's lock and two threads
+// waiting for each other's shards would never finish.
+// Returns whether any objects were found.
+bool pool_steal(Pool *pool, PoolShard *shard){
+    size_t own = shard - pool->shards;
+    for(size_t i = 1; i < POOL_SHARDS; i++){
+        PoolShard *victim = &pool->shards[(own + i) % POOL_SHARDS];
+        if(atomic_flag_test_and_set_explicit(&victim->lock, memory_order_acquire)){
+            continue;
+        }
+        shard->free_list = victim->free_list;
+        victim->free_list = NULL;
+        pool_unlock(&victim->lock);
+        if(shard->free_list != NULL){
+            return true;
+        }
+    }
+    return false;
+}
+
+Pool *pool_init(size_t object_size){
+    // Pools hold cache-line aligned shards, which malloc() doesn't promise
+    size_t bytes = (sizeof(Pool) + alignof(Pool) - 1) / alignof(Pool) * alignof(Pool);
+    Pool *pool = aligned_alloc(alignof(Pool), bytes);
+    assert(pool);
+    *pool = (Pool)POOL_INIT(object_size);
+    return pool;
+}
+
+void pool_free(Pool *pool){
+    void *chunk = pool->chunks;
+    while(chunk != NULL){
+        void *next = *(void **)chunk;
+        free(chunk);
+        chunk = next;
+    }
+    free(pool);
+}
+
+void *pool_alloc(Pool *pool){
+    Arena *arena = arena_current();
+    if(arena != NULL){
+        return arena_alloc(arena, pool->object_size);
+    }
+    PoolShard *shard = &pool->shards[pool_shard_index()];
+    pool_lock(&shard->lock);
+    if(shard->free_list == NULL && !pool_steal(pool, shard)){
+        pool_grow(pool, shard);
+    }
+    void *object = shard->free_list;
+    POOL_UNPOISON(object, pool->object_size < sizeof(void *)
+      ? sizeof(void *) : pool->object_size);
+    shard->free_list = *(void **)object;
+    shard->live++;
+    pool_unlock(&shard->lock);
+    return object;
+}
+
+void pool_release(Pool *pool, void *object){
+    // Arena objects are released with their arena
+    if(object == NULL || arena_owns(object)){
+        return;
+    }
+    PoolShard *shard = &pool->shards[pool_shard_index()];
+    pool_lock(&shard->lock);
+    *(void **)object = shard->free_list;
+    shard->free_list = object;
+    shard->live--;
+    POOL_POISON(object, pool_stride(pool));
+    pool_unlock(&shard->lock);
+}
+
+size_t pool_live(Pool *pool){
+    ptrdiff_t live = 0;
+    for(size_t i = 0; i < POOL_SHARDS; i++){
+        PoolShard *shard = &pool->shards[i];
+        pool_lock(&shard->lock);
+        live += shard->live;
+        pool_unlock(&shard->lock);
+    }
+    return live;
+}
@@ -1,7 +1,7 @@
 #include "powerups.h"
 
-void add_random_velocity(Body *player){
-  double factor = (double)(rand() % 4) + 2;
+void add_random_velocity(Scene *scene, Body *player){
+  double factor = (double)rng_below(scene_rng(scene), 4) + 2;
   Vector new_velocity = vec_multiply(factor, body_get_velocity(player));
   body_add_impulse(player, new_velocity);
 }
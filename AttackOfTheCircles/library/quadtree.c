@@ -0,0 +1,296 @@
+#include "quadtree.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+// Cells with this many bodies or fewer are not split
+const size_t QUADTREE_LEAF_SIZE = 8;
+// Stops splitting bodies that sit on top of each other
+#define QUADTREE_MAX_DEPTH 32
+const size_t QUADTREE_INITIAL_CAPACITY = 64;
+
+typedef struct quad_node{
+    Vector center;
+    double half_size;
+    Vector center_of_mass;
+    double mass;
+    // The largest body_radius() of any body in the cell
+    double max_radius;
+    // Indices of the children in tree->nodes, or 0 if a quadrant is empty
+    size_t children[4];
+    // The cell's bodies are tree->order[first] to tree->order[first + count - 1]
+    size_t first;
+    size_t count;
+    bool leaf;
+} QuadNode;
+
+struct quadtree{
+    QuadNode *nodes;
+    size_t nodes_size;
+    size_t nodes_capacity;
+
+    Body **bodies;
+    Vector *positions;
+    double *masses;
+    double *radii;
+    size_t *order;
+    size_t *scratch;
+    Vector *forces;
+    size_t bodies_size;
+    size_t bodies_capacity;
+};
+
+Quadtree *quadtree_init(void){
+    Quadtree *tree = calloc(1, sizeof(Quadtree));
+    assert(tree);
+    return tree;
+}
+
+void quadtree_free(Quadtree *tree){
+    free(tree->nodes);
+    free(tree->bodies);
+    free(tree->positions);
+    free(tree->masses);
+    free(tree->radii);
+    free(tree->order);
+    free(tree->scratch);
+    free(tree->forces);
+    free(tree);
+}
+
+void quadtree_reserve_bodies(Quadtree *tree, size_t count){
+    if(count <= tree->bodies_capacity){
+        return;
+    }
+    size_t capacity = tree->bodies_capacity == 0 ? QUADTREE_INITIAL_CAPACITY : tree->bodies_capacity;
+    while(capacity < count){
+        capacity *= 2;
+    }
+    tree->bodies = realloc(tree->bodies, sizeof(Body *) * capacity);
+    tree->positions = realloc(tree->positions, sizeof(Vector) * capacity);
+    tree->masses = realloc(tree->masses, sizeof(double) * capacity);
+    tree->radii = realloc(tree->radii, sizeof(double) * capacity);
+    tree->order = realloc(tree->order, sizeof(size_t) * capacity);
+    tree->scratch = realloc(tree->scratch, sizeof(size_t) * capacity);
+    tree->forces = realloc(tree->forces, sizeof(Vector) * capacity);
+    assert(tree->bodies && tree->positions && tree->masses && tree->radii);
+    assert(tree->order && tree->scratch && tree->forces);
+    tree->bodies_capacity = capacity;
+}
+
+size_t quadtree_new_node(Quadtree *tree){
+    if(tree->nodes_size == tree->nodes_capacity){
+        tree->nodes_capacity = tree->nodes_capacity == 0
+          ? QUADTREE_INITIAL_CAPACITY : tree->nodes_capacity * 2;
+        tree->nodes = realloc(tree->nodes, sizeof(QuadNode) * tree->nodes_capacity);
+        assert(tree->nodes);
+    }
+    return tree->nodes_size++;
+}
+
+int quadrant(Vector position, Vector center){
+    return (position.x >= center.x) + 2 * (position.y >= center.y);
+}
+
+size_t quadtree_build_node(Quadtree *tree, size_t first, size_t count,
+  Vector center, double half_size, int depth){
+    size_t index = quadtree_new_node(tree);
+    QuadNode node = {center, half_size, VEC_ZERO, 0, 0, {0, 0, 0, 0}, first, count, true};
+
+    if(count <= QUADTREE_LEAF_SIZE || depth == QUADTREE_MAX_DEPTH){
+        Vector weighted = VEC_ZERO;
+        for(size_t i = first; i < first + count; i++){
+            size_t body = tree->order[i];
+            node.mass += tree->masses[body];
+            weighted = vec_add(weighted, vec_multiply(tree->masses[body], tree->positions[body]));
+            if(tree->radii[body] > node.max_radius){
+                node.max_radius = tree->radii[body];
+            }
+        }
+        node.center_of_mass = vec_multiply(1 / node.mass, weighted);
+        tree->nodes[index] = node;
+        return index;
+    }
+
+    // Counting sort of the cell's bodies by quadrant
+    size_t counts[4] = {0, 0, 0, 0};
+    for(size_t i = first; i < first + count; i++){
+        counts[quadrant(tree->positions[tree->order[i]], center)]++;
+    }
+    size_t starts[4] = {first, first + counts[0], first + counts[0] + counts[1],
+      first + counts[0] + counts[1] + counts[2]};
+    size_t next[4] = {starts[0], starts[1], starts[2], starts[3]};
+    for(size_t i = first; i < first + count; i++){
+        size_t body = tree->order[i];
+        tree->scratch[next[quadrant(tree->positions[body], center)]++] = body;
+    }
+    for(size_t i = first; i < first + count; i++){
+        tree->order[i] = tree->scratch[i];
+    }
+
+    node.leaf = false;
+    Vector weighted = VEC_ZERO;
+    double quarter = half_size / 2;
+    for(int q = 0; q < 4; q++){
+        if(counts[q] == 0){
+            continue;
+        }
+        Vector child_center = {
+            center.x + (q & 1 ? quarter : -quarter),
+            center.y + (q & 2 ? quarter : -quarter)
+        };
+        size_t child = quadtree_build_node(tree, starts[q], counts[q],
+          child_center, quarter, depth + 1);
+        QuadNode *child_node = &tree->nodes[child];
+        node.children[q] = child;
+        node.mass += child_node->mass;
+        weighted = vec_add(weighted, vec_multiply(child_node->mass, child_node->center_of_mass));
+        if(child_node->max_radius > node.max_radius){
+            node.max_radius = child_node->max_radius;
+        }
+    }
+    node.center_of_mass = vec_multiply(1 / node.mass, weighted);
+    tree->nodes[index] = node;
+    return index;
+}
+
+void quadtree_build(Quadtree *tree, List *bodies){
+    quadtree_reserve_bodies(tree, list_size(bodies));
+    tree->bodies_size = 0;
+    tree->nodes_size = 0;
+    Vector min = {INFINITY, INFINITY};
+    Vector max = {-INFINITY, -INFINITY};
+    for(size_t i = 0; i < list_size(bodies); i++){
+        Body *body = list_get(bodies, i);
+        if(body_is_removed(body)){
+            continue;
+        }
+        size_t n = tree->bodies_size++;
+        Vector position = body_get_centroid(body);
+        tree->bodies[n] = body;
+        tree->positions[n] = position;
+        tree->masses[n] = body_get_mass(body);
+        tree->radii[n] = body_radius(body);
+        tree->order[n] = n;
+        min = (Vector){fmin(min.x, position.x), fmin(min.y, position.y)};
+        max = (Vector){fmax(max.x, position.x), fmax(max.y, position.y)};
+    }
+    if(tree->bodies_size == 0){
+        return;
+    }
+    Vector center = vec_multiply(0.5, vec_add(min, max));
+    double half_size = fmax(max.x - min.x, max.y - min.y) / 2;
+    quadtree_build_node(tree, 0, tree->bodies_size, center, half_size, 0);
+}
+
+// Adds the force on body1 from body2 to (*force_x, *force_y),
+// unless their bounding circles overlap.
+// Kept to plain arithmetic since it runs for every pair of nearby bodies.
+void add_gravity_force(double G, Vector position1, double mass1, double radius1,
+  Vector position2, double mass2, double radius2, double *force_x, double *force_y){
+    double dx = position2.x - position1.x;
+    double dy = position2.y - position1.y;
+    double distance = sqrt(dx * dx + dy * dy);
+    if(distance <= radius1 + radius2){
+        return;
+    }
+    double scale = G * mass1 * mass2 / (distance * distance * distance);
+    *force_x += scale * dx;
+    *force_y += scale * dy;
+}
+
+void quadtree_add_exact_gravity(Quadtree *tree, double G){
+    Vector *forces = tree->forces;
+    for(size_t i = 0; i < tree->bodies_size; i++){
+        forces[i] = VEC_ZERO;
+    }
+    for(size_t i = 0; i < tree->bodies_size; i++){
+        double force_x = 0, force_y = 0;
+        for(size_t j = i + 1; j < tree->bodies_size; j++){
+            double pair_x = 0, pair_y = 0;
+            add_gravity_force(G,
+              tree->positions[i], tree->masses[i], tree->radii[i],
+              tree->positions[j], tree->masses[j], tree->radii[j], &pair_x, &pair_y);
+            force_x += pair_x;
+            force_y += pair_y;
+            forces[j].x -= pair_x;
+            forces[j].y -= pair_y;
+        }
+        forces[i].x += force_x;
+        forces[i].y += force_y;
+        body_add_force(tree->bodies[i], forces[i]);
+    }
+}
+
+bool node_contains(QuadNode *node, Vector position){
+    return fabs(position.x - node->center.x) <= node->half_size
+      && fabs(position.y - node->center.y) <= node->half_size;
+}
+
+// The squared distance from a position to the nearest point of a cell
+double node_distance_squared(QuadNode *node, Vector position){
+    double dx = fmax(fabs(position.x - node->center.x) - node->half_size, 0);
+    double dy = fmax(fabs(position.y - node->center.y) - node->half_size, 0);
+    return dx * dx + dy * dy;
+}
+
+size_t quadtree_bodies(Quadtree *tree){
+    return tree->bodies_size;
+}
+
+void quadtree_add_gravity_range(Quadtree *tree, double G, double theta,
+  size_t start, size_t end){
+    assert(theta > 0);
+    assert(start <= end && end <= tree->bodies_size);
+    size_t stack[3 * QUADTREE_MAX_DEPTH + 4];
+    for(size_t i = start; i < end; i++){
+        Vector position = tree->positions[i];
+        double mass = tree->masses[i];
+        double radius = tree->radii[i];
+        double force_x = 0, force_y = 0;
+
+        size_t stack_size = 0;
+        stack[stack_size++] = 0;
+        while(stack_size > 0){
+            QuadNode *node = &tree->nodes[stack[--stack_size]];
+            if(node->leaf){
+                for(size_t k = node->first; k < node->first + node->count; k++){
+                    size_t j = tree->order[k];
+                    if(j != i){
+                        add_gravity_force(G, position, mass, radius,
+                          tree->positions[j], tree->masses[j], tree->radii[j],
+                          &force_x, &force_y);
+                    }
+                }
+                continue;
+            }
+            if(!node_contains(node, position)){
+                // Compare squares to avoid the square roots on the common path
+                double dx = node->center_of_mass.x - position.x;
+                double dy = node->center_of_mass.y - position.y;
+                double width = 2 * node->half_size;
+                double reach = radius + node->max_radius;
+                if(width * width < theta * theta * (dx * dx + dy * dy)
+                  && node_distance_squared(node, position) > reach * reach){
+                    add_gravity_force(G, position, mass, radius,
+                      node->center_of_mass, node->mass, 0, &force_x, &force_y);
+                    continue;
+                }
+            }
+            for(int q = 0; q < 4; q++){
+                if(node->children[q] != 0){
+                    stack[stack_size++] = node->children[q];
+                }
+            }
+        }
+        body_add_force(tree->bodies[i], (Vector){force_x, force_y});
+    }
+}
+
+void quadtree_add_gravity(Quadtree *tree, double G, double theta){
+    if(theta <= 0){
+        quadtree_add_exact_gravity(tree, G);
+        return;
+    }
+    quadtree_add_gravity_range(tree, G, theta, 0, tree->bodies_size);
+}
@@ -0,0 +1,35 @@
+#include "rng.h"
+#include <assert.h>
+
+// The constants of SplitMix64; see https://prng.di.unimi.it/splitmix64.c
+const uint64_t RNG_INCREMENT = 0x9E3779B97F4A7C15;
+const uint64_t RNG_MULTIPLIER1 = 0xBF58476D1CE4E5B9;
+const uint64_t RNG_MULTIPLIER2 = 0x94D049BB133111EB;
+
+void rng_seed(Rng *rng, uint64_t seed){
+    rng->state = seed;
+}
+
+uint64_t rng_next(Rng *rng){
+    rng->state += RNG_INCREMENT;
+    uint64_t z = rng->state;
+    z = (z ^ (z >> 30)) * RNG_MULTIPLIER1;
+    z = (z ^ (z >> 27)) * RNG_MULTIPLIER2;
+    return z ^ (z >> 31);
+}
+
+double rng_double(Rng *rng){
+    // The top 53 bits fill a double's mantissa exactly
+    return (rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+uint64_t rng_below(Rng *rng, uint64_t bound){
+    assert(bound > 0);
+    // Rejects the last partial run of bound values, so every value is equally likely
+    uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+    uint64_t value;
+    do{
+        value = rng_next(rng);
+    } while(value >= limit);
+    return value % bound;
+}
@@ -1,10 +1,47 @@
 #include "scene.h"
-#include "sdl_wrapper.h"
+#include "collision_stage.h"
+#include "spatial_grid.h"
+#include "pool.h"
+#include "arena.h"
+#include "workers.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+
+const double GRID_CELL_SIZE = 200.0;
+const size_t INITIAL_SLOT_CAPACITY = 64;
+const double DEFAULT_FIXED_DT = 1.0 / 120;
+const size_t DEFAULT_MAX_SUBSTEPS = 8;
+const uint64_t DEFAULT_SCENE_SEED = 1;
+// Waking the worker threads takes a few microseconds, so parallel force
+// creators in shorter runs, and smaller scenes' bodies, stay on one thread
+const size_t MIN_PARALLEL_HANDLERS = 32;
+const size_t MIN_PARALLEL_BODIES = 1024;
+// Work is split into this many tasks per thread, so a thread that finishes
+// early can take another task instead of waiting
+const size_t TASKS_PER_THREAD = 4;
+// Body ranges start at multiples of this, so no two threads write to the
+// same cache line of the store's arrays
+const size_t BODY_RANGE_ALIGNMENT = 8;
+
+// Where a scene keeps a body, so handles can tell once it is gone
+typedef struct body_slot{
+    // NULL while the slot is free
+    Body *body;
+    // Changes each time the slot's body is reaped
+    size_t generation;
+    GridProxy *proxy;
+    // The next free slot after this one, or SIZE_MAX
+    size_t next_free;
+} BodySlot;
 
 struct scene{
   List *bodies;
   List *force_handlers;
-  int key_presses[5];
+  int key_presses[SCENE_KEYS];
+  KeyHandler key_handler;
+  void *key_aux;
+  Rng rng;
   bool finished_level;
   bool done;
   Vector camera;
@@ -14,21 +51,93 @@ struct scene{
   FreeFunc follower_freer;
   double total_time;
   bool finished_title_screen;
+  CollisionStage *collision_stage;
+  SpatialGrid *grid;
+  BodySlot *slots;
+  size_t slots_size;
+  size_t slots_capacity;
+  // The bodies' kinematic state, indexed by slot
+  BodyStore *store;
+  // The first free slot, or SIZE_MAX
+  size_t free_slot;
+  // Bodies marked for removal since their force handlers were last dropped;
+  // body_remove() adds to it
+  List *removed_queue;
+  // The number of handlers marked removed but not freed yet
+  size_t removed_handlers;
+  // Holds the objects created while scene_use_arena() is on
+  Arena *arena;
+  // scene_step() runs ticks of fixed_dt seconds, at most max_substeps per call,
+  // and carries the leftover time in accumulator
+  double fixed_dt;
+  size_t max_substeps;
+  double accumulator;
+  // How far frames should blend from the saved transforms to the current ones
+  double alpha;
+  Vector saved_camera;
+  Integrator integrator;
+  // Runs the parallel parts of scene_tick(); NULL while the scene uses one thread
+  WorkerPool *workers;
+  bool deterministic;
+  // Where parallel force creators' forces are held until the run is done:
+  // one log per task if the scene is deterministic, otherwise one per thread
+  ForceLog **force_logs;
+  size_t num_force_logs;
 };
 
+// An entry in a body's intrusive list of the force handlers that use it.
+// Each handler owns one link per body, so it can unlink itself in O(1).
+typedef struct handler_link{
+    ForceHandler *handler;
+    Body *body;
+    struct handler_link *prev;
+    struct handler_link *next;
+} HandlerLink;
+
 struct force_handler{
     ForceCreator force;
     void* aux;
     List *bodies;
     FreeFunc freer;
+    // Set once one of the bodies is removed; the handler is freed later in the tick
+    bool removed;
+    // Whether it was added with scene_add_parallel_force_creator()
+    bool parallel;
+    // links[i] is this handler's entry in the list of the i-th body
+    HandlerLink *links;
+    size_t num_links;
+    // Most handlers act on one or two bodies; their links are stored here
+    HandlerLink inline_links[2];
 };
 
+Pool FORCE_HANDLER_POOL = POOL_INIT(sizeof(ForceHandler));
+
+// Removes a handler from the lists of the bodies it uses
+void force_handler_detach(ForceHandler *fh){
+    for(size_t i = 0; i < fh->num_links; i++){
+        HandlerLink *link = &fh->links[i];
+        if(link->prev != NULL){
+            link->prev->next = link->next;
+        }
+        else{
+            body_set_handler_links(link->body, link->next);
+        }
+        if(link->next != NULL){
+            link->next->prev = link->prev;
+        }
+    }
+}
+
 void force_handler_free(ForceHandler *fh){
+    force_handler_detach(fh);
     if(fh->freer != NULL){
         fh->freer(fh->aux);
     }
     list_free(fh->bodies);
-    free(fh);
+    if(fh->links != fh->inline_links){
+        arena_release(fh->links);
+    }
+    pool_release(&FORCE_HANDLER_POOL, fh);
 }
 
 void *get_aux(ForceHandler *fh){
@@ -50,22 +159,68 @@ Scene *scene_init(void){
     scene->follower_freer = NULL;
     scene->finished_level = false;
     //scene->jump_count = 0;
-    for(int i = 0; i < 4; i++){
+    for(int i = 0; i < SCENE_KEYS; i++){
         scene->key_presses[i] = KEY_RELEASED;
     }
+    scene->key_handler = NULL;
+    scene->key_aux = NULL;
+    rng_seed(&scene->rng, DEFAULT_SCENE_SEED);
     scene->total_time = 0;
+    scene->collision_stage = NULL;
+    scene->grid = spatial_grid_init(GRID_CELL_SIZE);
+    scene->slots = malloc(sizeof(BodySlot) * INITIAL_SLOT_CAPACITY);
+    assert(scene->slots);
+    scene->slots_size = 0;
+    scene->slots_capacity = INITIAL_SLOT_CAPACITY;
+    scene->store = body_store_init();
+    body_store_reserve(scene->store, INITIAL_SLOT_CAPACITY);
+    scene->free_slot = SIZE_MAX;
+    scene->removed_queue = list_init(0, NULL);
+    scene->removed_handlers = 0;
+    scene->arena = arena_init();
+    scene->fixed_dt = DEFAULT_FIXED_DT;
+    scene->max_substeps = DEFAULT_MAX_SUBSTEPS;
+    scene->accumulator = 0;
+    scene->alpha = 1;
+    scene->integrator = INTEGRATOR_MIDPOINT;
+    scene->saved_camera = VEC_ZERO;
+    scene->workers = NULL;
+    scene->deterministic = true;
+    scene->force_logs = NULL;
+    scene->num_force_logs = 0;
     return scene;
 }
 
 void scene_free(Scene *scene){
+    // The freers still run for the objects in the arena, since some of them
+    // own heap memory (e.g. a list that grew after the level was generated);
+    // freeing the arena memory itself is left to arena_free()
     list_free(scene->force_handlers);
     list_free(scene->bodies);
+    list_free(scene->removed_queue);
+    free(scene->slots);
+    body_store_free(scene->store);
+    spatial_grid_free(scene->grid);
     if(scene->follower_freer != NULL){
         scene->follower_freer(scene->follower_aux);
     }
+    if(scene->collision_stage != NULL){
+        collision_stage_free(scene->collision_stage);
+    }
+    arena_free(scene->arena);
+    scene_set_threads(scene, 1);
     free(scene);
 }
 
+void scene_use_arena(Scene *scene, bool use){
+    if(use){
+        arena_set_current(scene->arena);
+    }
+    else if(arena_current() == scene->arena){
+        arena_set_current(NULL);
+    }
+}
+
 void scene_set_done(Scene *scene, bool done){
     scene->done = done;
 }
@@ -99,22 +254,82 @@ int* scene_key_data(Scene *scene){
     return scene->key_presses;
 }
 
+void scene_set_key_handler(Scene *scene, KeyHandler handler, void *aux){
+    scene->key_handler = handler;
+    scene->key_aux = aux;
+}
+
+void scene_handle_key(Scene *scene, char key, KeyEventType type, double held_time){
+    if(scene->key_handler != NULL){
+        scene->key_handler(key, type, held_time, scene->key_aux);
+    }
+}
+
+void scene_seed(Scene *scene, uint64_t seed){
+    rng_seed(&scene->rng, seed);
+}
+
+Rng *scene_rng(Scene *scene){
+    return &scene->rng;
+}
+
 size_t scene_bodies(Scene *scene){
     return list_size(scene->bodies);
 }
 
+size_t scene_force_handlers(Scene *scene){
+    return list_size(scene->force_handlers);
+}
+
 Body *scene_get_body(Scene *scene, size_t index){
     return list_get(scene->bodies, index);
 }
 
 void scene_add_body(Scene *scene, Body *body){
+    assert(body_get_scene_slot(body) == SIZE_MAX);
+    size_t slot = scene->free_slot;
+    if(slot != SIZE_MAX){
+        scene->free_slot = scene->slots[slot].next_free;
+    }
+    else{
+        if(scene->slots_size == scene->slots_capacity){
+            scene->slots_capacity *= 2;
+            scene->slots = realloc(scene->slots, sizeof(BodySlot) * scene->slots_capacity);
+            assert(scene->slots);
+            body_store_reserve(scene->store, scene->slots_capacity);
+        }
+        slot = scene->slots_size++;
+        scene->slots[slot].generation = 0;
+    }
+    scene->slots[slot].body = body;
+    body_move_to_store(body, scene->store, slot);
+    scene->slots[slot].proxy = spatial_grid_insert(scene->grid, body);
     list_add(scene->bodies, body);
+    body_set_scene_slot(body, slot, scene->removed_queue);
 }
 
 void scene_remove_body(Scene *scene, size_t index){
     body_remove(scene_get_body(scene, index));
 }
 
+BodyHandle scene_get_handle(Scene *scene, Body *body){
+    size_t slot = body_get_scene_slot(body);
+    assert(slot < scene->slots_size && scene->slots[slot].body == body);
+    return (BodyHandle){slot, scene->slots[slot].generation};
+}
+
+Body *scene_get_handle_body(Scene *scene, BodyHandle handle){
+    if(handle.slot >= scene->slots_size){
+        return NULL;
+    }
+    BodySlot *slot = &scene->slots[handle.slot];
+    if(slot->generation != handle.generation || slot->body == NULL
+      || body_is_removed(slot->body)){
+        return NULL;
+    }
+    return slot->body;
+}
+
 bool scene_get_finished_title_screen(Scene *scene){
     return scene->finished_title_screen;
 }
@@ -129,67 +344,416 @@ double scene_get_time(Scene *scene){
 
 void scene_add_bodies_force_creator(Scene *scene, ForceCreator forcer, void *aux,
   List *bodies, FreeFunc freer){
-    ForceHandler *fh = malloc(sizeof(ForceHandler));
+    ForceHandler *fh = pool_alloc(&FORCE_HANDLER_POOL);
     fh->force = forcer;
     fh->aux = aux;
     fh->bodies = bodies;
     fh->freer = freer;
+    fh->removed = false;
+    fh->parallel = false;
+    fh->num_links = list_size(bodies);
+    size_t inline_links = sizeof(fh->inline_links) / sizeof(*fh->inline_links);
+    if(fh->num_links <= inline_links){
+        fh->links = fh->inline_links;
+    }
+    else{
+        fh->links = arena_malloc(sizeof(HandlerLink) * fh->num_links);
+    }
+    for(size_t i = 0; i < fh->num_links; i++){
+        Body *body = list_get(bodies, i);
+        HandlerLink *head = body_get_handler_links(body);
+        fh->links[i] = (HandlerLink){fh, body, NULL, head};
+        if(head != NULL){
+            head->prev = &fh->links[i];
+        }
+        body_set_handler_links(body, &fh->links[i]);
+        if(body_is_removed(body)){
+            fh->removed = true;
+        }
+    }
+    if(fh->removed){
+        scene->removed_handlers++;
+    }
     list_add(scene->force_handlers, fh);
 }
 
+void scene_add_parallel_force_creator(Scene *scene, ForceCreator forcer, void *aux,
+  List *bodies, FreeFunc freer){
+    scene_add_bodies_force_creator(scene, forcer, aux, bodies, freer);
+    ForceHandler *fh = list_get(scene->force_handlers, list_size(scene->force_handlers) - 1);
+    fh->parallel = true;
+}
+
 void scene_add_force_creator(Scene *scene, ForceCreator forcer, void *aux, FreeFunc freer){
     scene_add_bodies_force_creator(scene, forcer, aux, list_init(0, free), freer);
 }
 
-bool contains_removed_body(ForceHandler *fh){
-  bool flag = false;
-  for (size_t i = 0; i < list_size(fh->bodies); i++){
-    Body *body = list_get(fh->bodies, i);
-    if (body_is_removed(body)){
-      flag = true;
+void scene_set_collision_stage(Scene *scene, CollisionStage *stage){
+    if(scene->collision_stage != NULL && scene->collision_stage != stage){
+        collision_stage_free(scene->collision_stage);
+    }
+    scene->collision_stage = stage;
+}
+
+CollisionStage *scene_get_collision_stage(Scene *scene){
+    return scene->collision_stage;
+}
+
+List *scene_query_aabb(Scene *scene, Vector min, Vector max){
+    List *results = list_init(0, NULL);
+    spatial_grid_query_aabb(scene->grid, min, max, results);
+    return results;
+}
+
+List *scene_query_radius(Scene *scene, Vector center, double radius){
+    List *results = list_init(0, NULL);
+    spatial_grid_query_radius(scene->grid, center, radius, results);
+    return results;
+}
+
+List *scene_query_ray(Scene *scene, Vector origin, Vector direction, double max_distance){
+    List *results = list_init(0, NULL);
+    spatial_grid_query_ray(scene->grid, origin, direction, max_distance, results);
+    return results;
+}
+
+size_t scene_body_force_handlers(Scene *scene, Body *body){
+    size_t count = 0;
+    for(HandlerLink *link = body_get_handler_links(body); link != NULL; link = link->next){
+        if(!link->handler->removed){
+            count++;
+        }
+    }
+    return count;
+}
+
+List *scene_get_body_force_handlers(Scene *scene, Body *body){
+    List *handlers = list_init(0, NULL);
+    for(HandlerLink *link = body_get_handler_links(body); link != NULL; link = link->next){
+        if(!link->handler->removed){
+            list_add(handlers, link->handler);
+        }
+    }
+    return handlers;
+}
+
+void scene_remove_body_force_handlers(Scene *scene, Body *body){
+    for(HandlerLink *link = body_get_handler_links(body); link != NULL; link = link->next){
+        if(!link->handler->removed){
+            link->handler->removed = true;
+            scene->removed_handlers++;
+        }
+    }
+}
+
+// Marks the force handlers of the bodies removed since the last call,
+// so they are skipped from now on and freed by scene_reap_handlers()
+void scene_drop_removed_handlers(Scene *scene){
+    List *queue = scene->removed_queue;
+    for(size_t i = 0; i < list_size(queue); i++){
+        scene_remove_body_force_handlers(scene, list_get(queue, i));
+    }
+    while(list_size(queue) > 0){
+        list_remove(queue, list_size(queue) - 1);
+    }
+}
+
+// Frees the marked force handlers in one pass, keeping the rest in order
+void scene_reap_handlers(Scene *scene){
+    if(scene->removed_handlers == 0){
+        return;
+    }
+    List *handlers = scene->force_handlers;
+    size_t kept = 0;
+    for(size_t i = 0; i < handlers->size; i++){
+        ForceHandler *fh = handlers->data[i];
+        if(fh->removed){
+            force_handler_free(fh);
+        }
+        else{
+            handlers->data[kept++] = fh;
+        }
+    }
+    handlers->size = kept;
+    scene->removed_handlers = 0;
+}
+
+// Frees a removed body and lets its slot be reused
+void scene_reap_body(Scene *scene, Body *body){
+    size_t index = body_get_scene_slot(body);
+    BodySlot *slot = &scene->slots[index];
+    spatial_grid_remove(scene->grid, slot->proxy);
+    slot->body = NULL;
+    slot->proxy = NULL;
+    slot->generation++;
+    slot->next_free = scene->free_slot;
+    scene->free_slot = index;
+    body_free(body);
+}
+
+void scene_set_threads(Scene *scene, size_t threads){
+    assert(threads > 0);
+    if(scene->workers != NULL){
+        worker_pool_free(scene->workers);
+        scene->workers = NULL;
+    }
+    for(size_t i = 0; i < scene->num_force_logs; i++){
+        force_log_free(scene->force_logs[i]);
+    }
+    free(scene->force_logs);
+    scene->force_logs = NULL;
+    scene->num_force_logs = 0;
+    if(threads == 1){
+        return;
+    }
+    scene->workers = worker_pool_init(threads);
+    // Enough for either kind of scene, so switching needs no new logs
+    scene->num_force_logs = threads * TASKS_PER_THREAD;
+    scene->force_logs = malloc(sizeof(ForceLog *) * scene->num_force_logs);
+    assert(scene->force_logs);
+    for(size_t i = 0; i < scene->num_force_logs; i++){
+        scene->force_logs[i] = force_log_init();
+    }
+}
+
+size_t scene_get_threads(Scene *scene){
+    return scene->workers == NULL ? 1 : worker_pool_threads(scene->workers);
+}
+
+void scene_set_deterministic(Scene *scene, bool deterministic){
+    scene->deterministic = deterministic;
+}
+
+// The number of tasks to split count items into
+size_t scene_parallel_tasks(Scene *scene, size_t count){
+    size_t tasks = worker_pool_threads(scene->workers) * TASKS_PER_THREAD;
+    return count < tasks ? count : tasks;
+}
+
+typedef struct range_batch{
+    RangeTask task;
+    void *aux;
+    size_t count;
+    size_t tasks;
+    // Range boundaries are rounded down to a multiple of this
+    size_t alignment;
+} RangeBatch;
+
+void run_range_task(RangeBatch *batch, size_t task, size_t worker){
+    size_t start = batch->count * task / batch->tasks;
+    size_t end = batch->count * (task + 1) / batch->tasks;
+    start -= start % batch->alignment;
+    if(task + 1 < batch->tasks){
+        end -= end % batch->alignment;
+    }
+    if(start < end){
+        batch->task(batch->aux, start, end);
+    }
+}
+
+void scene_parallel_for_aligned(Scene *scene, size_t count, RangeTask task, void *aux,
+  size_t alignment){
+    if(scene->workers == NULL){
+        task(aux, 0, count);
+        return;
+    }
+    RangeBatch batch = {task, aux, count, scene_parallel_tasks(scene, count), alignment};
+    worker_pool_run(scene->workers, (WorkerTask)run_range_task, &batch, batch.tasks);
+}
+
+void scene_parallel_for(Scene *scene, size_t count, RangeTask task, void *aux){
+    scene_parallel_for_aligned(scene, count, task, aux, 1);
+}
+
+typedef struct handler_batch{
+    Scene *scene;
+    // The handlers run are start to end - 1
+    size_t start;
+    size_t end;
+    size_t tasks;
+} HandlerBatch;
+
+// Runs a task's share of the handlers, last first like scene_tick(),
+// so replaying the tasks' logs in task order adds the forces in serial order
+void run_handler_task(HandlerBatch *batch, size_t task, size_t worker){
+    Scene *scene = batch->scene;
+    size_t count = batch->end - batch->start;
+    size_t last = batch->end - count * task / batch->tasks;
+    size_t first = batch->end - count * (task + 1) / batch->tasks;
+    if(scene->deterministic){
+        force_log_start(scene->force_logs[task], NULL);
+    }
+    else{
+        force_log_start(scene->force_logs[worker], scene->store);
+    }
+    for(size_t i = last; i > first; i--){
+        ForceHandler *fh = list_get(scene->force_handlers, i - 1);
+        if(!fh->removed){
+            fh->force(fh->aux);
+        }
+    }
+    force_log_stop();
+}
+
+// Runs handlers start to end - 1, which are all parallel, on the workers
+void scene_run_parallel_handlers(Scene *scene, size_t start, size_t end){
+    HandlerBatch batch = {scene, start, end, scene_parallel_tasks(scene, end - start)};
+    worker_pool_run(scene->workers, (WorkerTask)run_handler_task, &batch, batch.tasks);
+    size_t logs = scene->deterministic ? batch.tasks : worker_pool_threads(scene->workers);
+    for(size_t i = 0; i < logs; i++){
+        force_log_apply(scene->force_logs[i]);
+    }
+}
+
+typedef struct integrate_batch{
+    Scene *scene;
+    double dt;
+} IntegrateBatch;
+
+void integrate_store_range(IntegrateBatch *batch, size_t start, size_t end){
+    Scene *scene = batch->scene;
+    body_store_integrate_range(scene->store, start, end, batch->dt, scene->integrator);
+}
+
+void integrate_bodies_range(IntegrateBatch *batch, size_t start, size_t end){
+    Scene *scene = batch->scene;
+    for(size_t i = start; i < end; i++){
+        Body *body = list_get(scene->bodies, i);
+        if(!body_is_removed(body)){
+            body_integrate(body, batch->dt, scene->integrator);
+        }
     }
-  }
-  return flag;
 }
 
 void scene_tick(Scene *scene, double dt){
     scene->total_time += dt;
-    size_t last_index_fh = list_size(scene->force_handlers) - 1;
+    scene->alpha = 1;
     if(scene->follower != NULL){
         scene_set_camera(scene, scene->follower(scene->follower_aux));
     } else {
         scene_move_camera(scene, vec_multiply(dt, scene->camera_velocity));
     }
 
-    for(size_t i = 0; i < last_index_fh + 1; i++){
-      ForceHandler* fh = list_get(scene->force_handlers, last_index_fh - i);
-      bool contains_removed_body = false;
-
-      for (size_t j = 0; j < list_size(fh->bodies); j++){
-        Body *body = list_get(fh->bodies, j);
-        if (body_is_removed(body)){
-          contains_removed_body = true;
+    // Force creators added during the tick (e.g. for new bullets) first run next tick
+    List *handlers = scene->force_handlers;
+    size_t end = list_size(handlers);
+    // Force creators of bodies removed before the tick don't run, but bodies
+    // removed during it stay until it ends, so the rest all run
+    scene_drop_removed_handlers(scene);
+    while(end > 0){
+        // Parallel force creators in a row can run at once, since they can't
+        // remove bodies from each other
+        size_t start = end - 1;
+        if(scene->workers != NULL && ((ForceHandler *)list_get(handlers, start))->parallel){
+            while(start > 0 && ((ForceHandler *)list_get(handlers, start - 1))->parallel){
+                start--;
+            }
+        }
+        if(end - start >= MIN_PARALLEL_HANDLERS){
+            scene_run_parallel_handlers(scene, start, end);
+        }
+        else{
+            for(size_t j = end; j > start; j--){
+                ForceHandler *fh = list_get(handlers, j - 1);
+                if(!fh->removed){
+                    fh->force(fh->aux);
+                }
+            }
         }
-      }
-      if (!contains_removed_body){
-        fh->force(fh->aux);
-      }
-      else{
-        list_remove(scene->force_handlers, last_index_fh - i);
-        force_handler_free(fh);
-      }
+        end = start;
     }
 
-    size_t last_index_bodies = scene_bodies(scene) - 1;
-    for (size_t i = 0; i < last_index_bodies + 1; i++){
-        Body *curr = scene_get_body(scene, last_index_bodies - i);
-        if (body_is_removed(curr)){
-          list_remove(scene->bodies, last_index_bodies - i);
+    if(scene->collision_stage != NULL){
+        collision_stage_tick(scene->collision_stage, scene);
+    }
+
+    // The handlers go first, since freeing them reads their bodies
+    scene_drop_removed_handlers(scene);
+    scene_reap_handlers(scene);
+
+    // Integrators without history tick every slot in one sweep over the store.
+    // Free slots are at rest, and removed bodies are freed below anyway.
+    bool sweep = scene->integrator == INTEGRATOR_MIDPOINT
+      || scene->integrator == INTEGRATOR_SEMI_IMPLICIT_EULER;
+    List *bodies = scene->bodies;
+    // Each body's tick only depends on that body, so the threads split them up
+    bool parallel = scene->workers != NULL && list_size(bodies) >= MIN_PARALLEL_BODIES;
+    IntegrateBatch batch = {scene, dt};
+    if(parallel && sweep){
+        scene_parallel_for_aligned(scene, scene->slots_size,
+          (RangeTask)integrate_store_range, &batch, BODY_RANGE_ALIGNMENT);
+    }
+    else if(parallel){
+        scene_parallel_for(scene, list_size(bodies), (RangeTask)integrate_bodies_range, &batch);
+    }
+    else if(sweep){
+        body_store_integrate(scene->store, scene->slots_size, dt, scene->integrator);
+    }
+    size_t kept = 0;
+    for(size_t i = 0; i < bodies->size; i++){
+        Body *body = bodies->data[i];
+        if(body_is_removed(body)){
+            scene_reap_body(scene, body);
         }
         else{
-          body_tick(curr, dt);
+            if(!sweep && !parallel){
+                body_integrate(body, dt, scene->integrator);
+            }
+            spatial_grid_update(scene->grid, scene->slots[body_get_scene_slot(body)].proxy);
+            bodies->data[kept++] = body;
         }
     }
+    bodies->size = kept;
+}
+
+void scene_set_integrator(Scene *scene, Integrator integrator){
+    scene->integrator = integrator;
+}
+
+Integrator scene_get_integrator(Scene *scene){
+    return scene->integrator;
+}
+
+void scene_set_fixed_step(Scene *scene, double dt, size_t max_substeps){
+    assert(dt > 0);
+    assert(max_substeps > 0);
+    scene->fixed_dt = dt;
+    scene->max_substeps = max_substeps;
+}
+
+size_t scene_step(Scene *scene, double elapsed){
+    assert(elapsed >= 0);
+    scene->accumulator += elapsed;
+    size_t ticks = 0;
+    while(scene->accumulator >= scene->fixed_dt && ticks < scene->max_substeps){
+        List *bodies = scene->bodies;
+        for(size_t i = 0; i < bodies->size; i++){
+            body_save_transform(bodies->data[i]);
+        }
+        scene->saved_camera = scene->camera;
+        scene_tick(scene, scene->fixed_dt);
+        scene->accumulator -= scene->fixed_dt;
+        ticks++;
+    }
+    // If the ticks can't keep up, drop the time they are behind by instead of
+    // running even more ticks next frame
+    if(scene->accumulator >= scene->fixed_dt){
+        scene->accumulator = fmod(scene->accumulator, scene->fixed_dt);
+    }
+    scene->alpha = scene->accumulator / scene->fixed_dt;
+    return ticks;
+}
+
+double scene_get_interpolation_alpha(Scene *scene){
+    return scene->alpha;
+}
+
+Vector scene_get_interpolated_camera(Scene *scene){
+    if(scene->alpha >= 1){
+        return scene->camera;
+    }
+    return vec_add(scene->saved_camera,
+      vec_multiply(scene->alpha, vec_subtract(scene->camera, scene->saved_camera)));
 }
 
 void scene_set_camera(Scene *scene, Vector camera){
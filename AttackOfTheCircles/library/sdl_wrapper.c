@@ -1,16 +1,44 @@
 #include <assert.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL2_gfxPrimitives.h>
 #include <SDL2/SDL_ttf.h>
-#include <time.h>
 #include "sdl_wrapper.h"
+#include "lru_cache.h"
+#include "polygon.h"
 
 #define WINDOW_TITLE "Attack of the Circles"
 #define WINDOW_WIDTH 1000
 #define WINDOW_HEIGHT 500
 #define MS_PER_S 1e3
+// Enough rendered texts for the busiest screen, e.g. the tutorial's eight
+// lines and the GUI, with room for text that changes every frame
+#define TEXT_CACHE_CAPACITY 64
+// Most text keys fit in this many bytes without allocating
+#define TEXT_KEY_LENGTH 256
+// The width and height of the static layer's tiles, in pixels
+#define TILE_SIZE 256
+// Enough tiles to cover the window a few times over, so tiles just
+// scrolled offscreen are still there if the camera comes back.
+// The cache grows if a frame needs more than half of this many tiles.
+#define TILE_CACHE_CAPACITY 64
+
+// A tile of the static layer, and the static bodies it was drawn from
+typedef struct static_tile {
+    SDL_Texture *texture;
+    uint64_t signature;
+} StaticTile;
+
+struct font {
+    char *file;
+    int ptsize;
+    // NULL if the file couldn't be opened, so it isn't tried every frame
+    TTF_Font *ttf;
+};
 
 /**
  * The coordinate at the center of the screen.
@@ -21,31 +49,74 @@ Vector center;
  */
 Vector max_diff;
 /**
- * The SDL window where the scene is rendered.
+ * The SDL window where the scene is rendered, or NULL if rendering offscreen.
  */
-SDL_Window *window;
+SDL_Window *window = NULL;
 /**
- * The renderer used to draw the scene.
+ * The pixels the scene is rendered to by sdl_init_offscreen(), or NULL if
+ * rendering to the window.
  */
-SDL_Renderer *renderer;
+SDL_Surface *offscreen = NULL;
 /**
- * The keypress handler, or NULL if none has been configured.
+ * The renderer used to draw the scene.
  */
-KeyHandler key_handler = NULL;
+SDL_Renderer *renderer;
 /**
  * SDL's timestamp when a key was last pressed or released.
  * Used to mesasure how long a key has been held.
  */
 uint32_t key_start_timestamp;
 /**
- * The value of clock() when time_since_last_tick() was last called.
- * Initially 0.
+ * The value of SDL_GetPerformanceCounter() when time_since_last_tick()
+ * was last called. Initially 0.
  */
-clock_t last_clock = 0;
-
-void *aux_data = NULL;
-
-Vector camera;
+uint64_t last_counter = 0;
+/**
+ * Holds the blended vertices of bodies drawn between ticks.
+ */
+VectorList *interpolated_shape = NULL;
+/**
+ * What the last call to sdl_render_scene() drew.
+ */
+RenderStats render_stats = {0, 0, 0, 0};
+/**
+ * How sdl_draw_polygon() fills polygons.
+ */
+RenderBackend render_backend = RENDER_GEOMETRY;
+/**
+ * The screen-space vertices and triangles queued by sdl_draw_polygon()
+ * for the next SDL_RenderGeometry() call. The arrays are kept between
+ * frames and only grow.
+ */
+SDL_Vertex *batch_vertices = NULL;
+size_t batch_vertex_count = 0, batch_vertex_capacity = 0;
+int *batch_indices = NULL;
+size_t batch_index_count = 0, batch_index_capacity = 0;
+/**
+ * The screen coordinates of a polygon filled by SDL2_gfx, kept between
+ * calls so drawing doesn't allocate.
+ */
+short *gfx_x_points = NULL, *gfx_y_points = NULL;
+size_t gfx_capacity = 0;
+/**
+ * Whether sdl_render_scene() draws static bodies through cached tiles.
+ */
+bool static_layer = true;
+/**
+ * The tiles of static bodies drawn by sdl_render_scene(), keyed by their
+ * coordinates at static_layer_scale pixels per unit.
+ */
+LruCache *static_tiles = NULL;
+size_t static_tiles_capacity = TILE_CACHE_CAPACITY;
+double static_layer_scale = 0;
+/**
+ * The fonts opened by sdl_get_font(), which stay open until the window closes.
+ */
+List *fonts = NULL;
+/**
+ * The textures of recently drawn text, keyed by font, color and text.
+ */
+LruCache *text_textures = NULL;
 
 /**
  * Converts an SDL key code to a char.
@@ -64,18 +135,37 @@ char get_keycode(SDL_Keycode key) {
     }
 }
 
-void sdl_init(Vector min, Vector max) {
+void font_free(Font *font) {
+    if (font->ttf != NULL) {
+        TTF_CloseFont(font->ttf);
+    }
+    free(font->file);
+    free(font);
+}
+
+void static_tile_free(StaticTile *tile) {
+    SDL_DestroyTexture(tile->texture);
+    free(tile);
+}
+
+// Sets up what the window and offscreen targets share, once the renderer exists
+void sdl_init_view(Vector min, Vector max) {
     // Check parameters
     assert(min.x < max.x);
     assert(min.y < max.y);
 
-    camera = VEC_ZERO;
     center = vec_multiply(0.5, vec_add(min, max)),
     max_diff = vec_subtract(max, center);
-    SDL_Init(SDL_INIT_EVERYTHING);
     if (TTF_Init() < 0){
       printf("TTF did not init.");
     }
+    fonts = list_init(1, (FreeFunc) font_free);
+    text_textures = lru_cache_init(TEXT_CACHE_CAPACITY, (FreeFunc) SDL_DestroyTexture);
+    static_tiles = lru_cache_init(static_tiles_capacity, (FreeFunc) static_tile_free);
+}
+
+void sdl_init(Vector min, Vector max) {
+    SDL_Init(SDL_INIT_EVERYTHING);
     window = SDL_CreateWindow(
         WINDOW_TITLE,
         SDL_WINDOWPOS_CENTERED,
@@ -85,24 +175,172 @@ void sdl_init(Vector min, Vector max) {
         SDL_WINDOW_RESIZABLE
     );
     renderer = SDL_CreateRenderer(window, -1, 0);
+    sdl_init_view(min, max);
 }
 
-void write_font(const char* file, int ptsize, const char* text, SDL_Color color,
-  Vector top_left_corner, double width, double height){
-    TTF_Font *font = TTF_OpenFont(file, ptsize);
-    SDL_Surface *surface_text = TTF_RenderUTF8_Blended(font, text, color);
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface_text);
+void sdl_init_offscreen(Vector min, Vector max, int width, int height) {
+    assert(width > 0 && height > 0);
+    // The software renderer needs no video driver, so this runs without a display
+    SDL_Init(0);
+    offscreen = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    assert(offscreen);
+    renderer = SDL_CreateSoftwareRenderer(offscreen);
+    assert(renderer);
+    sdl_init_view(min, max);
+}
+
+// Gets the number of pixels per scene unit that fits the whole scene in the
+// window (or offscreen image), and the window's center in pixels
+double sdl_view_scale(double *center_x, double *center_y) {
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    *center_x = width / 2.0;
+    *center_y = height / 2.0;
+    double x_scale = *center_x / max_diff.x,
+           y_scale = *center_y / max_diff.y;
+    return x_scale < y_scale ? x_scale : y_scale;
+}
+
+void sdl_reserve_gfx(size_t n) {
+    if (n <= gfx_capacity) {
+        return;
+    }
+    gfx_capacity = n * 2;
+    gfx_x_points = realloc(gfx_x_points, sizeof(*gfx_x_points) * gfx_capacity);
+    gfx_y_points = realloc(gfx_y_points, sizeof(*gfx_y_points) * gfx_capacity);
+    assert(gfx_x_points);
+    assert(gfx_y_points);
+}
+
+void sdl_reserve_geometry(size_t vertices, size_t indices) {
+    if (batch_vertex_count + vertices > batch_vertex_capacity) {
+        batch_vertex_capacity = (batch_vertex_count + vertices) * 2;
+        batch_vertices = realloc(batch_vertices,
+            sizeof(*batch_vertices) * batch_vertex_capacity);
+        assert(batch_vertices);
+    }
+    if (batch_index_count + indices > batch_index_capacity) {
+        batch_index_capacity = (batch_index_count + indices) * 2;
+        batch_indices = realloc(batch_indices,
+            sizeof(*batch_indices) * batch_index_capacity);
+        assert(batch_indices);
+    }
+}
+
+// Fills the first n points of the gfx buffers, which are in screen coordinates
+void sdl_fill_gfx(size_t n, SDL_Color color) {
+    filledPolygonRGBA(
+        renderer,
+        gfx_x_points, gfx_y_points, n,
+        color.r, color.g, color.b, color.a
+    );
+}
+
+void sdl_flush_geometry(void) {
+    if (batch_index_count > 0
+        && SDL_RenderGeometry(renderer, NULL, batch_vertices, batch_vertex_count,
+            batch_indices, batch_index_count) < 0) {
+        // The renderer can't draw geometry (e.g. SDL is older than 2.0.18),
+        // so fill the queued triangles on the CPU and stop queueing
+        printf("SDL_RenderGeometry failed, falling back to SDL2_gfx: %s\n", SDL_GetError());
+        render_backend = RENDER_GFX;
+        sdl_reserve_gfx(3);
+        for (size_t i = 0; i < batch_index_count; i += 3) {
+            for (size_t j = 0; j < 3; j++) {
+                SDL_FPoint position = batch_vertices[batch_indices[i + j]].position;
+                gfx_x_points[j] = round(position.x);
+                gfx_y_points[j] = round(position.y);
+            }
+            sdl_fill_gfx(3, batch_vertices[batch_indices[i]].color);
+        }
+    }
+    batch_vertex_count = 0;
+    batch_index_count = 0;
+}
+
+void sdl_set_render_backend(RenderBackend backend) {
+    sdl_flush_geometry();
+    render_backend = backend;
+}
+
+RenderBackend sdl_get_render_backend(void) {
+    return render_backend;
+}
+
+Font *sdl_get_font(const char *file, int ptsize) {
+    for (size_t i = 0; i < list_size(fonts); i++) {
+        Font *font = list_get(fonts, i);
+        if (font->ptsize == ptsize && strcmp(font->file, file) == 0) {
+            return font;
+        }
+    }
+    Font *font = malloc(sizeof(Font));
+    assert(font);
+    font->file = malloc(strlen(file) + 1);
+    assert(font->file);
+    strcpy(font->file, file);
+    font->ptsize = ptsize;
+    font->ttf = TTF_OpenFont(file, ptsize);
+    list_add(fonts, font);
+    return font;
+}
+
+void sdl_draw_text(Font *font, const char *text, SDL_Color color,
+  Vector top_left_corner, double width, double height) {
+    if (font->ttf == NULL) {
+        return;
+    }
+    char short_key[TEXT_KEY_LENGTH];
+    char *key = short_key;
+    const char *format = "%p %02x%02x%02x%02x %s";
+    int length = snprintf(key, TEXT_KEY_LENGTH, format,
+        (void *) font, color.r, color.g, color.b, color.a, text);
+    if (length >= TEXT_KEY_LENGTH) {
+        key = malloc(length + 1);
+        assert(key);
+        snprintf(key, length + 1, format,
+            (void *) font, color.r, color.g, color.b, color.a, text);
+    }
+    SDL_Texture *texture = lru_cache_get(text_textures, key);
+    if (texture == NULL) {
+        SDL_Surface *surface_text = TTF_RenderUTF8_Blended(font->ttf, text, color);
+        if (surface_text != NULL) {
+            texture = SDL_CreateTextureFromSurface(renderer, surface_text);
+            SDL_FreeSurface(surface_text);
+        }
+        if (texture != NULL) {
+            lru_cache_put(text_textures, key, texture);
+        }
+    }
+    if (key != short_key) {
+        free(key);
+    }
+    if (texture == NULL) {
+        return;
+    }
+    // Text goes on top of the polygons drawn before it
+    sdl_flush_geometry();
     SDL_Rect message_rect;
     message_rect.x = top_left_corner.x;
     message_rect.y = top_left_corner.y;
     message_rect.w = width;
     message_rect.h = height;
-    //SDL_QueryTexture(texture, NULL, NULL, &width, &height);
-    //SDL_RenderClear(renderer);
     SDL_RenderCopy(renderer, texture, NULL, &message_rect);
-    TTF_CloseFont(font);
-    SDL_FreeSurface(surface_text);
-    SDL_DestroyTexture(texture);
+}
+
+void write_font(const char* file, int ptsize, const char* text, SDL_Color color,
+  Vector top_left_corner, double width, double height){
+    sdl_draw_text(sdl_get_font(file, ptsize), text, color, top_left_corner, width, height);
+}
+
+// Releases the cached textures and fonts, which must happen before TTF_Quit()
+void sdl_free_textures(void) {
+    lru_cache_free(static_tiles);
+    static_tiles = NULL;
+    lru_cache_free(text_textures);
+    text_textures = NULL;
+    list_free(fonts);
+    fonts = NULL;
 }
 
 Vector get_min(void){
@@ -113,20 +351,21 @@ Vector get_max(void){
   return vec_subtract(center, max_diff);
 }
 
-bool sdl_is_done() {
+bool sdl_is_done(Scene *scene) {
     SDL_Event *event = malloc(sizeof(*event));
     assert(event);
     while (SDL_PollEvent(event)) {
         switch (event->type) {
             case SDL_QUIT:
+                sdl_free_textures();
                 TTF_Quit();
                 free(event);
                 return true;
             case SDL_KEYDOWN:
             case SDL_KEYUP:
-                // Skip the keypress if no handler is configured
+                // Skip the keypress if there is no scene to handle it
                 // or an unrecognized key was pressed
-                if (!key_handler) break;
+                if (!scene) break;
                 char key = get_keycode(event->key.keysym.sym);
                 if (!key) break;
 
@@ -138,7 +377,7 @@ bool sdl_is_done() {
                     event->type == SDL_KEYDOWN ? KEY_PRESSED : KEY_RELEASED;
                 double held_time =
                     (timestamp - key_start_timestamp) / MS_PER_S;
-                key_handler(key, type, held_time, aux_data);
+                scene_handle_key(scene, key, type, held_time);
                 break;
         }
     }
@@ -147,88 +386,325 @@ bool sdl_is_done() {
 }
 
 void sdl_clear(void) {
+    // Anything queued before the clear would be covered by it
+    batch_vertex_count = 0;
+    batch_index_count = 0;
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
 }
 
-void sdl_draw_polygon(List *points, RGBColor color, bool draw_camera) {
+// Draws a polygon whose vertices v land on the pixels
+// (offset_x + scale * v.x, offset_y - scale * v.y) of the render target.
+// convex says whether the polygon is convex, so it can be drawn as a fan.
+void sdl_queue_polygon(const VectorList *points, bool convex, RGBColor color,
+    double scale, double offset_x, double offset_y) {
     // Check parameters
-    size_t n = list_size(points);
+    size_t n = vec_list_size(points);
     assert(n >= 3);
     assert(0 <= color.r && color.r <= 1);
     assert(0 <= color.g && color.g <= 1);
     assert(0 <= color.b && color.b <= 1);
+    SDL_Color sdl_color = {color.r * 255, color.g * 255, color.b * 255, 255};
 
-    // Scale scene so it fits entirely in the window,
-    // with the center of the scene at the center of the window
-    int *width = malloc(sizeof(*width)),
-        *height = malloc(sizeof(*height));
-    assert(width);
-    assert(height);
-    SDL_GetWindowSize(window, width, height);
-    double center_x = *width / 2.0,
-           center_y = *height / 2.0;
-    free(width);
-    free(height);
-    double x_scale = center_x / max_diff.x,
-           y_scale = center_y / max_diff.y;
-    double scale = x_scale < y_scale ? x_scale : y_scale;
-
-    // Convert each vertex to a point on screen
-    short *x_points = malloc(sizeof(*x_points) * n),
-          *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points);
-    assert(y_points);
+    if (render_backend == RENDER_GEOMETRY && convex) {
+        // Queue the polygon as a fan of triangles from its first vertex
+        sdl_reserve_geometry(n, 3 * (n - 2));
+        int first = batch_vertex_count;
+        for (size_t i = 0; i < n; i++) {
+            Vector vertex = vec_list_get(points, i);
+            // Flip y axis since positive y is down on the screen
+            batch_vertices[batch_vertex_count++] = (SDL_Vertex) {
+                {offset_x + scale * vertex.x, offset_y - scale * vertex.y},
+                sdl_color,
+                {0, 0}
+            };
+        }
+        for (size_t i = 1; i + 1 < n; i++) {
+            batch_indices[batch_index_count++] = first;
+            batch_indices[batch_index_count++] = first + i;
+            batch_indices[batch_index_count++] = first + i + 1;
+        }
+        return;
+    }
+
+    // Concave polygons are filled on the CPU, on top of what is queued so far
+    sdl_flush_geometry();
+    sdl_reserve_gfx(n);
     for (size_t i = 0; i < n; i++) {
-        Vector *vertex = list_get(points, i);
-        Vector displacement = draw_camera ? vec_add(center, camera) : center;
-        Vector pos_from_center =
-            vec_multiply(scale, vec_subtract(*vertex, displacement));
-        // Flip y axis since positive y is down on the screen
-        x_points[i] = round(center_x + pos_from_center.x);
-        y_points[i] = round(center_y - pos_from_center.y);
+        Vector vertex = vec_list_get(points, i);
+        gfx_x_points[i] = round(offset_x + scale * vertex.x);
+        gfx_y_points[i] = round(offset_y - scale * vertex.y);
     }
+    sdl_fill_gfx(n, sdl_color);
+}
 
-    // Draw polygon with the given color
-    filledPolygonRGBA(
-        renderer,
-        x_points, y_points, n,
-        color.r * 255, color.g * 255, color.b * 255, 255
-    );
-    free(x_points);
-    free(y_points);
+void sdl_draw_polygon(const VectorList *points, RGBColor color, Vector camera) {
+    // Scale scene so it fits entirely in the window,
+    // with the center of the scene at the center of the window
+    double center_x, center_y;
+    double scale = sdl_view_scale(&center_x, &center_y);
+    Vector displacement = vec_add(center, camera);
+    // Circles and boxes are always convex, so only other polygons are checked
+    bool convex = points->kind != SHAPE_POLYGON || polygon_is_convex(points);
+    sdl_queue_polygon(points, convex, color, scale,
+        center_x - scale * displacement.x, center_y + scale * displacement.y);
 }
 
 void sdl_show(void) {
+    sdl_flush_geometry();
     SDL_RenderPresent(renderer);
 }
 
+void sdl_get_frame_size(int *width, int *height) {
+    SDL_GetRendererOutputSize(renderer, width, height);
+}
+
+void sdl_read_frame(uint8_t *pixels) {
+    // Anything still queued belongs in the frame
+    sdl_flush_geometry();
+    int width, height;
+    sdl_get_frame_size(&width, &height);
+    if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGB24, pixels, 3 * width) < 0) {
+        printf("SDL_RenderReadPixels failed: %s\n", SDL_GetError());
+    }
+}
+
+bool sdl_write_ppm(const char *path) {
+    int width, height;
+    sdl_get_frame_size(&width, &height);
+    uint8_t *pixels = malloc(3 * (size_t) width * height);
+    assert(pixels);
+    sdl_read_frame(pixels);
+    FILE *file = fopen(path, "wb");
+    bool written = file != NULL
+        && fprintf(file, "P6\n%d %d\n255\n", width, height) > 0
+        && fwrite(pixels, 3 * (size_t) width, height, file) == (size_t) height;
+    if (file != NULL && fclose(file) != 0) {
+        written = false;
+    }
+    free(pixels);
+    return written;
+}
+
+// Whether a body can be drawn in the static layer: it moves with the camera,
+// can't be pushed and isn't moving, like the levels' floors and spikes
+bool sdl_is_static(Body *body) {
+    Vector velocity = body_get_velocity(body);
+    return body_get_camera_attachment(body) && body_get_mass(body) == INFINITY
+        && velocity.x == 0 && velocity.y == 0;
+}
+
+// A 64-bit FNV-1a step over a whole word
+uint64_t sdl_hash_word(uint64_t hash, uint64_t word) {
+    return (hash ^ word) * 0x100000001B3;
+}
+
+uint64_t sdl_hash_double(uint64_t hash, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return sdl_hash_word(hash, bits);
+}
+
+// Sums up where the static bodies in a list are and how they look, so a tile
+// drawn from them can tell when it is out of date. Returns 0 if there are none.
+uint64_t sdl_static_signature(List *bodies) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        Body *body = list_get(bodies, i);
+        if (!sdl_is_static(body)) {
+            continue;
+        }
+        if (hash == 0) {
+            hash = 0xCBF29CE484222325;
+        }
+        hash = sdl_hash_word(hash, (uintptr_t) body);
+        Vector centroid = body_get_centroid(body);
+        // The first vertex moves when the body is turned about its centroid
+        Vector vertex = vec_list_get(body_get_shape_view(body), 0);
+        RGBColor color = body_get_color(body);
+        hash = sdl_hash_double(hash, centroid.x);
+        hash = sdl_hash_double(hash, centroid.y);
+        hash = sdl_hash_double(hash, vertex.x);
+        hash = sdl_hash_double(hash, vertex.y);
+        hash = sdl_hash_double(hash, color.r);
+        hash = sdl_hash_double(hash, color.g);
+        hash = sdl_hash_double(hash, color.b);
+    }
+    return hash;
+}
+
+// Gets the tile at (tile_x, tile_y), drawing it if it isn't cached or its
+// static bodies have changed. Returns NULL if the tile has no static bodies,
+// or if the renderer can't draw to textures, which turns the static layer off.
+StaticTile *sdl_get_static_tile(Scene *scene, long tile_x, long tile_y, double scale,
+    RenderStats *stats) {
+    Vector min = {tile_x * TILE_SIZE / scale, tile_y * TILE_SIZE / scale};
+    Vector max = {(tile_x + 1) * TILE_SIZE / scale, (tile_y + 1) * TILE_SIZE / scale};
+    List *bodies = scene_query_aabb(scene, min, max);
+    uint64_t signature = sdl_static_signature(bodies);
+    char key[48];
+    snprintf(key, sizeof(key), "%ld,%ld", tile_x, tile_y);
+    StaticTile *tile = lru_cache_get(static_tiles, key);
+    if (signature == 0 || (tile != NULL && tile->signature == signature)) {
+        list_free(bodies);
+        return signature == 0 ? NULL : tile;
+    }
+
+    if (tile == NULL) {
+        SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+            SDL_TEXTUREACCESS_TARGET, TILE_SIZE, TILE_SIZE);
+        if (texture == NULL) {
+            printf("Static layer tiles unsupported, drawing every body: %s\n", SDL_GetError());
+            static_layer = false;
+            list_free(bodies);
+            return NULL;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        tile = malloc(sizeof(StaticTile));
+        assert(tile);
+        tile->texture = texture;
+        lru_cache_put(static_tiles, key, tile);
+    }
+    tile->signature = signature;
+    SDL_SetRenderTarget(renderer, tile->texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        Body *body = list_get(bodies, i);
+        if (sdl_is_static(body)) {
+            // The tile's top left corner is pixel (0, 0)
+            sdl_queue_polygon(body_get_shape_view(body), body_is_convex(body),
+                body_get_color(body), scale, -tile_x * TILE_SIZE, (tile_y + 1) * TILE_SIZE);
+        }
+    }
+    sdl_flush_geometry();
+    SDL_SetRenderTarget(renderer, NULL);
+    list_free(bodies);
+    stats->tiles_drawn++;
+    return tile;
+}
+
+// Copies the tiles of static bodies that cover the window into it, where the
+// scene's origin is at pixel (offset_x, offset_y). Copies none if the static
+// layer has to be turned off.
+void sdl_draw_static_layer(Scene *scene, double scale, double offset_x, double offset_y,
+    int width, int height, RenderStats *stats) {
+    if (scale != static_layer_scale) {
+        lru_cache_clear(static_tiles);
+        static_layer_scale = scale;
+    }
+    // Pixel x of the window is column offset_x + x of the scene's pixels,
+    // and pixel y is row offset_y - y, counting rows upwards
+    long min_x = floor(-offset_x / TILE_SIZE),
+         max_x = floor((width - 1 - offset_x) / TILE_SIZE),
+         min_y = floor((offset_y - height) / TILE_SIZE),
+         max_y = floor(offset_y / TILE_SIZE);
+    // Keep room for twice the most tiles a frame of this size can need, e.g.
+    // after the window is made bigger, so one frame's tiles never evict each other
+    size_t most_tiles = (width / TILE_SIZE + 2) * (height / TILE_SIZE + 2);
+    if (2 * most_tiles > static_tiles_capacity) {
+        static_tiles_capacity = 2 * most_tiles;
+        lru_cache_free(static_tiles);
+        static_tiles = lru_cache_init(static_tiles_capacity, (FreeFunc) static_tile_free);
+    }
+    // Each tile is copied before the next is fetched, since fetching one
+    // may evict tiles from the cache
+    for (long tile_y = min_y; tile_y <= max_y; tile_y++) {
+        for (long tile_x = min_x; tile_x <= max_x; tile_x++) {
+            StaticTile *tile = sdl_get_static_tile(scene, tile_x, tile_y, scale, stats);
+            if (!static_layer) {
+                return;
+            }
+            if (tile != NULL) {
+                SDL_Rect rect = {
+                    offset_x + tile_x * TILE_SIZE, offset_y - (tile_y + 1) * TILE_SIZE,
+                    TILE_SIZE, TILE_SIZE
+                };
+                SDL_RenderCopy(renderer, tile->texture, NULL, &rect);
+            }
+        }
+    }
+}
+
+// Draws the bodies that are (or aren't) attached to the camera, where the
+// scene's origin is at pixel (offset_x, offset_y). Static bodies are skipped
+// and counted as cached if the static layer has drawn them.
+void sdl_draw_bodies(List *bodies, bool attached, double scale, double offset_x,
+    double offset_y, double alpha, RenderStats *stats) {
+    if (interpolated_shape == NULL) {
+        interpolated_shape = vec_list_init(0);
+    }
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        Body *body = list_get(bodies, i);
+        if (body_get_camera_attachment(body) != attached) {
+            continue;
+        }
+        if (static_layer && sdl_is_static(body)) {
+            stats->cached++;
+            continue;
+        }
+        sdl_queue_polygon(body_get_interpolated_shape(body, alpha, interpolated_shape),
+            body_is_convex(body), body_get_color(body), scale, offset_x, offset_y);
+        stats->drawn++;
+    }
+}
+
 void sdl_render_scene(Scene *scene) {
     sdl_clear();
-    sdl_set_camera(scene_get_camera(scene));
-    size_t body_count = scene_bodies(scene);
-    for (size_t i = 0; i < body_count; i++) {
-        Body *body = scene_get_body(scene, i);
-        List *shape = body_get_shape(body);
-        sdl_draw_polygon(shape, body_get_color(body), body_get_camera_attachment(body));
-        list_free(shape);
+    // Blend between the last two ticks, so motion is smooth at any frame rate
+    double alpha = scene_get_interpolation_alpha(scene);
+    Vector camera = scene_get_interpolated_camera(scene);
+    RenderStats stats = {0, 0, 0, 0};
+
+    // Only draw the bodies that overlap the window, as sdl_draw_polygon()
+    // would place them: camera-attached bodies are offset by the camera
+    double center_x, center_y;
+    double scale = sdl_view_scale(&center_x, &center_y);
+    Vector half_view = {center_x / scale, center_y / scale};
+    Vector world_center = vec_add(center, camera);
+    // Whole pixels, so the static layer's tiles and the bodies on them line up
+    double offset_x = round(center_x - scale * world_center.x),
+           offset_y = round(center_y + scale * world_center.y);
+
+    // Static bodies go underneath everything else
+    if (static_layer && static_tiles != NULL) {
+        sdl_draw_static_layer(scene, scale, offset_x, offset_y,
+            2 * center_x, 2 * center_y, &stats);
     }
+    List *visible = scene_query_aabb(scene, vec_subtract(world_center, half_view),
+        vec_add(world_center, half_view));
+    sdl_draw_bodies(visible, true, scale, offset_x, offset_y, alpha, &stats);
+    list_free(visible);
+
+    // Bodies that ignore the camera (e.g. the GUI) are drawn on top
+    visible = scene_query_aabb(scene, vec_subtract(center, half_view),
+        vec_add(center, half_view));
+    sdl_draw_bodies(visible, false, scale, center_x - scale * center.x,
+        center_y + scale * center.y, alpha, &stats);
+    list_free(visible);
+
+    stats.skipped = scene_bodies(scene) - stats.drawn - stats.cached;
+    render_stats = stats;
 }
 
-void sdl_on_key(KeyHandler handler, void *data) {
-    key_handler = handler;
-    aux_data = data;
+void sdl_set_static_layer(bool enabled) {
+    static_layer = enabled;
+    if (static_tiles != NULL) {
+        lru_cache_clear(static_tiles);
+    }
 }
 
-void sdl_set_camera(Vector camera_pos){
-    camera = camera_pos;
+RenderStats sdl_get_render_stats(void) {
+    return render_stats;
 }
 
 double time_since_last_tick(void) {
-    clock_t now = clock();
-    double difference = last_clock
-        ? (double) (now - last_clock) / CLOCKS_PER_SEC
+    // A monotonic wall clock: clock() would count CPU time,
+    // which stops while the program waits (e.g. for vsync)
+    uint64_t now = SDL_GetPerformanceCounter();
+    double difference = last_counter
+        ? (double) (now - last_counter) / SDL_GetPerformanceFrequency()
         : 0.0; // return 0 the first time this is called
-    last_clock = now;
+    last_counter = now;
     return difference;
 }
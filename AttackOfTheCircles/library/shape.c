@@ -5,86 +5,75 @@
 #include <time.h>
 #include <assert.h>
 
-List* shape_star(int num_spokes, double scale, double ld, double sd){
+VectorList* shape_star(int num_spokes, double scale, double ld, double sd){
     Vector unit = {.x = 0, .y = scale};
-    List* points = list_init(num_spokes * 2, free);
+    VectorList* points = vec_list_init(num_spokes * 2);
     double rotation_angle = (2 * M_PI) / (num_spokes * 2);
 
     for(int i = 0; i < num_spokes; i++){
-        Vector *v = malloc(sizeof(Vector));
-        *v = vec_multiply(ld, unit);
-        list_add(points, v);
+        vec_list_add(points, vec_multiply(ld, unit));
         unit = vec_rotate(unit, rotation_angle);
-        v = malloc(sizeof(Vector));
-        *v = vec_multiply(sd, unit);
-        list_add(points, v);
+        vec_list_add(points, vec_multiply(sd, unit));
         unit = vec_rotate(unit, rotation_angle);
     }
     return points;
 }
 
-List *shape_triangle(double radius){
-    List *points = list_init(3, free);
+VectorList *shape_triangle(double radius){
+    VectorList *points = vec_list_init(3);
     double rotation_angle = (2 * M_PI) / 3;
     Vector init = {.x = 0, .y = radius};
 
     for(int i =  0; i < 3; i++){
-        Vector *v = malloc(sizeof(Vector));
-        *v = init;
-        list_add(points, v);
+        vec_list_add(points, init);
         init = vec_rotate(init, rotation_angle);
     }
     return points;
 }
 
-List *shape_regular_star(int num_spokes, double scale){
+VectorList *shape_regular_star(int num_spokes, double scale){
     return shape_star(num_spokes, scale, .144*scale, .089*scale);
 }
 
-List *shape_estrella(double radius){
+VectorList *shape_estrella(double radius){
     return shape_star(4, 1, radius, radius/2);
 }
 
-List* shape_partial_circle(double radius, int num_vertices, double proportion){
+VectorList* shape_partial_circle(double radius, int num_vertices, double proportion){
     assert(num_vertices >= 3);
-    Vector *v = malloc(sizeof(Vector));
-    *v = (Vector){0, radius};
-    List *l = list_init(num_vertices, free);
+    Vector v = (Vector){0, radius};
+    VectorList *l = vec_list_init(num_vertices);
     for(int i = 0; i < num_vertices; i++){
-        list_add(l, v);
-        Vector *new_v = malloc(sizeof(Vector));
-        *new_v = vec_rotate(*v, 2 * M_PI/num_vertices * proportion);
-        v = new_v;
+        vec_list_add(l, v);
+        v = vec_rotate(v, 2 * M_PI/num_vertices * proportion);
     }
     return l;
 }
 
-List *shape_circle(double radius, int num_vertices){
-    return shape_partial_circle(radius, num_vertices, 1.0);
+VectorList *shape_circle(double radius, int num_vertices){
+    VectorList *l = shape_partial_circle(radius, num_vertices, 1.0);
+    l->kind = SHAPE_CIRCLE;
+    return l;
 }
 
-List *shape_rectangle(double width, double height){
-    List *l = list_init(4, free);
-    Vector *v = malloc(sizeof(Vector));
-    *v = (Vector){width/2.0, height/2.0};
-    list_add(l, v);
-    v = malloc(sizeof(Vector));
-    *v = (Vector){-width/2.0, height/2.0};
-    list_add(l, v);
-    v = malloc(sizeof(Vector));
-    *v = (Vector){-width/2.0, -height/2.0};
-    list_add(l, v);
-    v = malloc(sizeof(Vector));
-    *v = (Vector){width/2.0, -height/2.0};
-    list_add(l, v);
+VectorList *shape_rectangle(double width, double height){
+    VectorList *l = vec_list_init(4);
+    vec_list_add(l, (Vector){width/2.0, height/2.0});
+    vec_list_add(l, (Vector){-width/2.0, height/2.0});
+    vec_list_add(l, (Vector){-width/2.0, -height/2.0});
+    vec_list_add(l, (Vector){width/2.0, -height/2.0});
+    l->kind = SHAPE_AABB;
     return l;
 }
 
 
-double gen_single_color(){
-    return  1.0 * rand() / RAND_MAX;
+double gen_single_color(Rng *rng){
+    return rng_double(rng);
 }
 
-RGBColor gen_color(){
-    return (RGBColor){gen_single_color(), gen_single_color(), gen_single_color()};
+RGBColor gen_color(Rng *rng){
+    double r = gen_single_color(rng);
+    double g = gen_single_color(rng);
+    double b = gen_single_color(rng);
+    return (RGBColor){r, g, b};
 }
@@ -0,0 +1,415 @@
+#include "spatial_grid.h"
+#include "pool.h"
+#include "arena.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+const size_t GRID_BUCKETS = 4096;
+// Bodies covering more cells than this are kept in the oversized list
+const long MAX_PROXY_CELLS = 64;
+const size_t INITIAL_BUCKET_CAPACITY = 4;
+
+struct grid_proxy{
+    Body *body;
+    size_t order;
+    // index of this proxy in grid->proxies
+    size_t index;
+    long min_cx;
+    long min_cy;
+    long max_cx;
+    long max_cy;
+    bool oversized;
+    size_t stamp;
+};
+
+Pool GRID_PROXY_POOL = POOL_INIT(sizeof(GridProxy));
+
+typedef struct grid_bucket{
+    GridProxy **items;
+    size_t size;
+    size_t capacity;
+} GridBucket;
+
+// A query match, sorted by key before being returned
+typedef struct grid_hit{
+    GridProxy *proxy;
+    double key;
+} GridHit;
+
+struct spatial_grid{
+    double cell_size;
+    GridBucket *buckets;
+    // The first INITIAL_BUCKET_CAPACITY items of every bucket, allocated
+    // together up front, so filing bodies into new cells doesn't allocate
+    GridProxy **bucket_slots;
+    GridBucket oversized;
+    GridProxy **proxies;
+    size_t proxies_size;
+    size_t proxies_capacity;
+    size_t next_order;
+    size_t stamp;
+    GridHit *hits;
+    size_t hits_size;
+    size_t hits_capacity;
+};
+
+// Frees an array of proxies, unless it is a bucket's first slots
+void grid_release_proxies(SpatialGrid *grid, GridProxy **items){
+    if(items < grid->bucket_slots
+      || items >= grid->bucket_slots + GRID_BUCKETS * INITIAL_BUCKET_CAPACITY){
+        arena_release(items);
+    }
+}
+
+// Grows an array of proxies. Arrays grown while a level is generated come from
+// the scene's arena, so they aren't reallocated with realloc()
+GridProxy **grid_grow_proxies(SpatialGrid *grid, GridProxy **items, size_t size,
+  size_t *capacity){
+    *capacity = *capacity == 0 ? INITIAL_BUCKET_CAPACITY : *capacity * 2;
+    GridProxy **grown = arena_malloc(sizeof(GridProxy *) * *capacity);
+    if(size > 0){
+        memcpy(grown, items, sizeof(GridProxy *) * size);
+    }
+    grid_release_proxies(grid, items);
+    return grown;
+}
+
+void grid_bucket_add(SpatialGrid *grid, GridBucket *bucket, GridProxy *proxy){
+    if(bucket->size == bucket->capacity){
+        bucket->items = grid_grow_proxies(grid, bucket->items, bucket->size, &bucket->capacity);
+    }
+    bucket->items[bucket->size++] = proxy;
+}
+
+void grid_bucket_remove(GridBucket *bucket, GridProxy *proxy){
+    for(size_t i = 0; i < bucket->size; i++){
+        if(bucket->items[i] == proxy){
+            bucket->items[i] = bucket->items[--bucket->size];
+            return;
+        }
+    }
+}
+
+size_t grid_cell_hash(long cx, long cy){
+    uint64_t h = (uint64_t)cx * 73856093u ^ (uint64_t)cy * 19349663u;
+    h ^= h >> 13;
+    return (size_t)(h & (GRID_BUCKETS - 1));
+}
+
+long grid_cell(SpatialGrid *grid, double coordinate){
+    return (long)floor(coordinate / grid->cell_size);
+}
+
+SpatialGrid *spatial_grid_init(double cell_size){
+    assert(cell_size > 0);
+    SpatialGrid *grid = malloc(sizeof(SpatialGrid));
+    assert(grid);
+    grid->cell_size = cell_size;
+    grid->buckets = malloc(sizeof(GridBucket) * GRID_BUCKETS);
+    grid->bucket_slots = malloc(sizeof(GridProxy *) * GRID_BUCKETS * INITIAL_BUCKET_CAPACITY);
+    assert(grid->buckets);
+    assert(grid->bucket_slots);
+    for(size_t i = 0; i < GRID_BUCKETS; i++){
+        grid->buckets[i] = (GridBucket){
+            grid->bucket_slots + i * INITIAL_BUCKET_CAPACITY, 0, INITIAL_BUCKET_CAPACITY
+        };
+    }
+    grid->oversized = (GridBucket){NULL, 0, 0};
+    grid->proxies = NULL;
+    grid->proxies_size = 0;
+    grid->proxies_capacity = 0;
+    grid->next_order = 0;
+    grid->stamp = 0;
+    grid->hits = NULL;
+    grid->hits_size = 0;
+    grid->hits_capacity = 0;
+    return grid;
+}
+
+void spatial_grid_free(SpatialGrid *grid){
+    for(size_t i = 0; i < GRID_BUCKETS; i++){
+        grid_release_proxies(grid, grid->buckets[i].items);
+    }
+    free(grid->buckets);
+    free(grid->bucket_slots);
+    arena_release(grid->oversized.items);
+    for(size_t i = 0; i < grid->proxies_size; i++){
+        pool_release(&GRID_PROXY_POOL, grid->proxies[i]);
+    }
+    arena_release(grid->proxies);
+    free(grid->hits);
+    free(grid);
+}
+
+void grid_proxy_file(SpatialGrid *grid, GridProxy *proxy){
+    if(proxy->oversized){
+        grid_bucket_add(grid, &grid->oversized, proxy);
+        return;
+    }
+    for(long cx = proxy->min_cx; cx <= proxy->max_cx; cx++){
+        for(long cy = proxy->min_cy; cy <= proxy->max_cy; cy++){
+            grid_bucket_add(grid, &grid->buckets[grid_cell_hash(cx, cy)], proxy);
+        }
+    }
+}
+
+void grid_proxy_unfile(SpatialGrid *grid, GridProxy *proxy){
+    if(proxy->oversized){
+        grid_bucket_remove(&grid->oversized, proxy);
+        return;
+    }
+    for(long cx = proxy->min_cx; cx <= proxy->max_cx; cx++){
+        for(long cy = proxy->min_cy; cy <= proxy->max_cy; cy++){
+            grid_bucket_remove(&grid->buckets[grid_cell_hash(cx, cy)], proxy);
+        }
+    }
+}
+
+// Computes the cells covered by the body's current bounding box.
+// Returns true if they differ from the cells the proxy is filed under.
+bool grid_proxy_measure(SpatialGrid *grid, GridProxy *proxy, long cells[4]){
+    Vector center = body_get_centroid(proxy->body);
+    double radius = body_radius(proxy->body);
+    cells[0] = grid_cell(grid, center.x - radius);
+    cells[1] = grid_cell(grid, center.y - radius);
+    cells[2] = grid_cell(grid, center.x + radius);
+    cells[3] = grid_cell(grid, center.y + radius);
+    return cells[0] != proxy->min_cx || cells[1] != proxy->min_cy
+      || cells[2] != proxy->max_cx || cells[3] != proxy->max_cy;
+}
+
+void grid_proxy_set_cells(GridProxy *proxy, long cells[4]){
+    proxy->min_cx = cells[0];
+    proxy->min_cy = cells[1];
+    proxy->max_cx = cells[2];
+    proxy->max_cy = cells[3];
+    proxy->oversized = (cells[2] - cells[0] + 1) * (cells[3] - cells[1] + 1)
+      > MAX_PROXY_CELLS;
+}
+
+GridProxy *spatial_grid_insert(SpatialGrid *grid, Body *body){
+    GridProxy *proxy = pool_alloc(&GRID_PROXY_POOL);
+    proxy->body = body;
+    proxy->order = grid->next_order++;
+    proxy->stamp = 0;
+    long cells[4];
+    grid_proxy_measure(grid, proxy, cells);
+    grid_proxy_set_cells(proxy, cells);
+    grid_proxy_file(grid, proxy);
+
+    if(grid->proxies_size == grid->proxies_capacity){
+        grid->proxies = grid_grow_proxies(grid, grid->proxies, grid->proxies_size,
+          &grid->proxies_capacity);
+    }
+    proxy->index = grid->proxies_size;
+    grid->proxies[grid->proxies_size++] = proxy;
+    return proxy;
+}
+
+void spatial_grid_update(SpatialGrid *grid, GridProxy *proxy){
+    long cells[4];
+    if(!grid_proxy_measure(grid, proxy, cells)){
+        return;
+    }
+    grid_proxy_unfile(grid, proxy);
+    grid_proxy_set_cells(proxy, cells);
+    grid_proxy_file(grid, proxy);
+}
+
+void spatial_grid_remove(SpatialGrid *grid, GridProxy *proxy){
+    grid_proxy_unfile(grid, proxy);
+    GridProxy *last = grid->proxies[--grid->proxies_size];
+    grid->proxies[proxy->index] = last;
+    last->index = proxy->index;
+    pool_release(&GRID_PROXY_POOL, proxy);
+}
+
+void grid_add_hit(SpatialGrid *grid, GridProxy *proxy, double key){
+    proxy->stamp = grid->stamp;
+    if(grid->hits_size == grid->hits_capacity){
+        grid->hits_capacity = grid->hits_capacity == 0
+          ? INITIAL_BUCKET_CAPACITY : grid->hits_capacity * 2;
+        grid->hits = realloc(grid->hits, sizeof(GridHit) * grid->hits_capacity);
+        assert(grid->hits);
+    }
+    grid->hits[grid->hits_size++] = (GridHit){proxy, key};
+}
+
+int compare_hits(const void *a, const void *b){
+    const GridHit *hit1 = a;
+    const GridHit *hit2 = b;
+    if(hit1->key != hit2->key){
+        return (hit1->key > hit2->key) - (hit1->key < hit2->key);
+    }
+    return (hit1->proxy->order > hit2->proxy->order)
+      - (hit1->proxy->order < hit2->proxy->order);
+}
+
+void grid_flush_hits(SpatialGrid *grid, List *results){
+    qsort(grid->hits, grid->hits_size, sizeof(GridHit), compare_hits);
+    for(size_t i = 0; i < grid->hits_size; i++){
+        list_add(results, grid->hits[i].proxy->body);
+    }
+    grid->hits_size = 0;
+}
+
+// Calls visit on every live proxy filed under the cell (or in the oversized
+// list) that has not been visited yet by the current query
+typedef void (*ProxyVisitor)(SpatialGrid *grid, GridProxy *proxy, void *aux);
+
+void grid_visit_bucket(SpatialGrid *grid, GridBucket *bucket, ProxyVisitor visit,
+  void *aux){
+    for(size_t i = 0; i < bucket->size; i++){
+        GridProxy *proxy = bucket->items[i];
+        if(proxy->stamp != grid->stamp && !body_is_removed(proxy->body)){
+            visit(grid, proxy, aux);
+        }
+    }
+}
+
+// Visits every proxy that might overlap the box from min to max
+void grid_visit_box(SpatialGrid *grid, Vector min, Vector max, ProxyVisitor visit,
+  void *aux){
+    grid->stamp++;
+    grid_visit_bucket(grid, &grid->oversized, visit, aux);
+    long min_cx = grid_cell(grid, min.x), max_cx = grid_cell(grid, max.x);
+    long min_cy = grid_cell(grid, min.y), max_cy = grid_cell(grid, max.y);
+    if((double)(max_cx - min_cx + 1) * (max_cy - min_cy + 1) > grid->proxies_size){
+        // Cheaper to look at every body than at every cell
+        for(size_t i = 0; i < grid->proxies_size; i++){
+            GridProxy *proxy = grid->proxies[i];
+            if(proxy->stamp != grid->stamp && !body_is_removed(proxy->body)){
+                visit(grid, proxy, aux);
+            }
+        }
+        return;
+    }
+    for(long cx = min_cx; cx <= max_cx; cx++){
+        for(long cy = min_cy; cy <= max_cy; cy++){
+            grid_visit_bucket(grid, &grid->buckets[grid_cell_hash(cx, cy)], visit, aux);
+        }
+    }
+}
+
+void visit_aabb(SpatialGrid *grid, GridProxy *proxy, void *aux){
+    Vector *box = aux;
+    Vector center = body_get_centroid(proxy->body);
+    double radius = body_radius(proxy->body);
+    if(center.x + radius < box[0].x || center.x - radius > box[1].x
+      || center.y + radius < box[0].y || center.y - radius > box[1].y){
+        return;
+    }
+    grid_add_hit(grid, proxy, 0);
+}
+
+void spatial_grid_query_aabb(SpatialGrid *grid, Vector min, Vector max, List *results){
+    Vector box[2] = {min, max};
+    grid_visit_box(grid, min, max, visit_aabb, box);
+    grid_flush_hits(grid, results);
+}
+
+typedef struct circle_query{
+    Vector center;
+    double radius;
+} CircleQuery;
+
+void visit_radius(SpatialGrid *grid, GridProxy *proxy, void *aux){
+    CircleQuery *query = aux;
+    double reach = query->radius + body_radius(proxy->body);
+    if(vec_distance_squared(body_get_centroid(proxy->body), query->center) > reach * reach){
+        return;
+    }
+    grid_add_hit(grid, proxy, 0);
+}
+
+void spatial_grid_query_radius(SpatialGrid *grid, Vector center, double radius,
+  List *results){
+    CircleQuery query = {center, radius};
+    Vector extent = {radius, radius};
+    grid_visit_box(grid, vec_subtract(center, extent), vec_add(center, extent),
+      visit_radius, &query);
+    grid_flush_hits(grid, results);
+}
+
+typedef struct ray_query{
+    Vector origin;
+    Vector direction;
+    double max_distance;
+} RayQuery;
+
+void visit_ray(SpatialGrid *grid, GridProxy *proxy, void *aux){
+    RayQuery *query = aux;
+    double radius = body_radius(proxy->body);
+    Vector offset = vec_subtract(query->origin, body_get_centroid(proxy->body));
+    double b = vec_dot(offset, query->direction);
+    double c = vec_dot(offset, offset) - radius * radius;
+    double distance;
+    if(c <= 0){
+        // The ray starts inside the body's bounding circle
+        distance = 0;
+    } else {
+        double discriminant = b * b - c;
+        if(b > 0 || discriminant < 0){
+            return;
+        }
+        distance = -b - sqrt(discriminant);
+    }
+    if(distance <= query->max_distance){
+        grid_add_hit(grid, proxy, distance);
+    }
+}
+
+void spatial_grid_query_ray(SpatialGrid *grid, Vector origin, Vector direction,
+  double max_distance, List *results){
+    double length = vec_magnitude(direction);
+    assert(length > 0);
+    RayQuery query = {origin, vec_multiply(1 / length, direction), max_distance};
+
+    grid->stamp++;
+    grid_visit_bucket(grid, &grid->oversized, visit_ray, &query);
+
+    // Walk the cells along the ray (Amanatides & Woo). Bodies are filed under
+    // every cell their box covers, so the cells the ray crosses are enough.
+    long cx = grid_cell(grid, origin.x), cy = grid_cell(grid, origin.y);
+    int step_x = query.direction.x > 0 ? 1 : -1;
+    int step_y = query.direction.y > 0 ? 1 : -1;
+    double next_x = (cx + (step_x > 0)) * grid->cell_size;
+    double next_y = (cy + (step_y > 0)) * grid->cell_size;
+    double t_max_x = query.direction.x != 0
+      ? (next_x - origin.x) / query.direction.x : INFINITY;
+    double t_max_y = query.direction.y != 0
+      ? (next_y - origin.y) / query.direction.y : INFINITY;
+    double t_delta_x = query.direction.x != 0
+      ? grid->cell_size / fabs(query.direction.x) : INFINITY;
+    double t_delta_y = query.direction.y != 0
+      ? grid->cell_size / fabs(query.direction.y) : INFINITY;
+
+    size_t cells = 0;
+    double t = 0;
+    while(t <= max_distance){
+        if(cells++ > grid->proxies_size){
+            // The ray is long compared to the number of bodies
+            for(size_t i = 0; i < grid->proxies_size; i++){
+                GridProxy *proxy = grid->proxies[i];
+                if(proxy->stamp != grid->stamp && !body_is_removed(proxy->body)){
+                    visit_ray(grid, proxy, &query);
+                }
+            }
+            break;
+        }
+        grid_visit_bucket(grid, &grid->buckets[grid_cell_hash(cx, cy)], visit_ray, &query);
+        if(t_max_x < t_max_y){
+            t = t_max_x;
+            t_max_x += t_delta_x;
+            cx += step_x;
+        } else {
+            t = t_max_y;
+            t_max_y += t_delta_y;
+            cy += step_y;
+        }
+    }
+    grid_flush_hits(grid, results);
+}
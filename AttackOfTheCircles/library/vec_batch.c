@@ -0,0 +1,388 @@
+#include "vec_batch.h"
+#include <math.h>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+void vec_batch_translate_scalar(Vector *out, const Vector *in, size_t n, Vector translation){
+    for(size_t i = 0; i < n; i++){
+        out[i].x = in[i].x + translation.x;
+        out[i].y = in[i].y + translation.y;
+    }
+}
+
+void vec_batch_rotate_scalar(Vector *out, const Vector *in, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset){
+    for(size_t i = 0; i < n; i++){
+        double x = in[i].x - pivot.x;
+        double y = in[i].y - pivot.y;
+        out[i].x = x * cos_angle - y * sin_angle + offset.x;
+        out[i].y = x * sin_angle + y * cos_angle + offset.y;
+    }
+}
+
+void vec_batch_project_scalar(const Vector *in, size_t n, Vector axis, double *min, double *max){
+    double lowest = INFINITY;
+    double highest = -INFINITY;
+    for(size_t i = 0; i < n; i++){
+        double project = in[i].x * axis.x + in[i].y * axis.y;
+        if(project < lowest){
+            lowest = project;
+        }
+        if(project > highest){
+            highest = project;
+        }
+    }
+    *min = lowest;
+    *max = highest;
+}
+
+double vec_batch_shoelace_scalar(const Vector *in, size_t n, Vector *moment){
+    double sum = 0;
+    Vector moment_sum = VEC_ZERO;
+    for(size_t i = 0; i < n; i++){
+        Vector v1 = in[i];
+        Vector v2 = i + 1 < n ? in[i + 1] : in[0];
+        double cross = v1.x * v2.y - v1.y * v2.x;
+        sum += cross;
+        moment_sum.x += cross * (v1.x + v2.x);
+        moment_sum.y += cross * (v1.y + v2.y);
+    }
+    if(moment != NULL){
+        *moment = moment_sum;
+    }
+    return sum;
+}
+
+void vec_batch_integrate_midpoint_scalar(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    for(size_t i = 0; i < n; i++){
+        double inverse_mass = 1 / mass[i];
+        double dt_over_mass = dt / mass[i];
+        Vector v = velocity[i];
+        Vector final_velocity = {
+            v.x + inverse_mass * impulses[i].x + dt_over_mass * forces[i].x,
+            v.y + inverse_mass * impulses[i].y + dt_over_mass * forces[i].y
+        };
+        centroid[i].x += 0.5 * dt * (v.x + final_velocity.x);
+        centroid[i].y += 0.5 * dt * (v.y + final_velocity.y);
+        velocity[i] = final_velocity;
+        forces[i] = VEC_ZERO;
+        impulses[i] = VEC_ZERO;
+    }
+}
+
+void vec_batch_integrate_euler_scalar(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    for(size_t i = 0; i < n; i++){
+        double inverse_mass = 1 / mass[i];
+        velocity[i].x += inverse_mass * (impulses[i].x + dt * forces[i].x);
+        velocity[i].y += inverse_mass * (impulses[i].y + dt * forces[i].y);
+        centroid[i].x += dt * velocity[i].x;
+        centroid[i].y += dt * velocity[i].y;
+        forces[i] = VEC_ZERO;
+        impulses[i] = VEC_ZERO;
+    }
+}
+
+#if defined(__SSE2__)
+
+// A Vector fits one SSE2 register as {x, y}. The AVX versions below work on
+// two Vectors at a time and finish odd-sized arrays with these.
+
+void vec_batch_translate_sse2(Vector *out, const Vector *in, size_t start, size_t n,
+  Vector translation){
+    __m128d t = _mm_set_pd(translation.y, translation.x);
+    for(size_t i = start; i < n; i++){
+        _mm_storeu_pd(&out[i].x, _mm_add_pd(_mm_loadu_pd(&in[i].x), t));
+    }
+}
+
+void vec_batch_rotate_sse2(Vector *out, const Vector *in, size_t start, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset){
+    __m128d c = _mm_set1_pd(cos_angle);
+    // Multiplying {y, x} by {-sin, sin} gives {-y sin, x sin}
+    __m128d s = _mm_set_pd(sin_angle, -sin_angle);
+    __m128d p = _mm_set_pd(pivot.y, pivot.x);
+    __m128d o = _mm_set_pd(offset.y, offset.x);
+    for(size_t i = start; i < n; i++){
+        __m128d v = _mm_sub_pd(_mm_loadu_pd(&in[i].x), p);
+        __m128d swapped = _mm_shuffle_pd(v, v, 1);
+        __m128d rotated = _mm_add_pd(_mm_mul_pd(v, c), _mm_mul_pd(swapped, s));
+        _mm_storeu_pd(&out[i].x, _mm_add_pd(rotated, o));
+    }
+}
+
+void vec_batch_project_sse2(const Vector *in, size_t start, size_t n, Vector axis,
+  double *min, double *max){
+    __m128d a = _mm_set_pd(axis.y, axis.x);
+    __m128d lowest = _mm_set_sd(*min);
+    __m128d highest = _mm_set_sd(*max);
+    for(size_t i = start; i < n; i++){
+        __m128d products = _mm_mul_pd(_mm_loadu_pd(&in[i].x), a);
+        __m128d dot = _mm_add_sd(products, _mm_unpackhi_pd(products, products));
+        lowest = _mm_min_sd(lowest, dot);
+        highest = _mm_max_sd(highest, dot);
+    }
+    *min = _mm_cvtsd_f64(lowest);
+    *max = _mm_cvtsd_f64(highest);
+}
+
+// Adds the edges from in[start] to in[n - 1] (and back to in[0]) to the sums
+void vec_batch_shoelace_sse2(const Vector *in, size_t start, size_t n, double *sum,
+  Vector *moment){
+    __m128d total = _mm_set_sd(*sum);
+    __m128d moment_sum = _mm_set_pd(moment->y, moment->x);
+    for(size_t i = start; i < n; i++){
+        __m128d v1 = _mm_loadu_pd(&in[i].x);
+        __m128d v2 = _mm_loadu_pd(&in[i + 1 < n ? i + 1 : 0].x);
+        // {x1 y2, y1 x2}
+        __m128d products = _mm_mul_pd(v1, _mm_shuffle_pd(v2, v2, 1));
+        __m128d cross = _mm_sub_sd(products, _mm_unpackhi_pd(products, products));
+        total = _mm_add_sd(total, cross);
+        cross = _mm_unpacklo_pd(cross, cross);
+        moment_sum = _mm_add_pd(moment_sum, _mm_mul_pd(cross, _mm_add_pd(v1, v2)));
+    }
+    *sum = _mm_cvtsd_f64(total);
+    _mm_storeu_pd(&moment->x, moment_sum);
+}
+
+void vec_batch_integrate_midpoint_sse2(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t start, size_t n, double dt){
+    __m128d one = _mm_set1_pd(1);
+    __m128d step = _mm_set1_pd(dt);
+    __m128d half_step = _mm_set1_pd(0.5 * dt);
+    __m128d zero = _mm_setzero_pd();
+    for(size_t i = start; i < n; i++){
+        __m128d m = _mm_set1_pd(mass[i]);
+        __m128d v = _mm_loadu_pd(&velocity[i].x);
+        __m128d final_velocity = _mm_add_pd(
+          _mm_add_pd(v, _mm_mul_pd(_mm_div_pd(one, m), _mm_loadu_pd(&impulses[i].x))),
+          _mm_mul_pd(_mm_div_pd(step, m), _mm_loadu_pd(&forces[i].x)));
+        __m128d c = _mm_loadu_pd(&centroid[i].x);
+        c = _mm_add_pd(c, _mm_mul_pd(half_step, _mm_add_pd(v, final_velocity)));
+        _mm_storeu_pd(&centroid[i].x, c);
+        _mm_storeu_pd(&velocity[i].x, final_velocity);
+        _mm_storeu_pd(&forces[i].x, zero);
+        _mm_storeu_pd(&impulses[i].x, zero);
+    }
+}
+
+void vec_batch_integrate_euler_sse2(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t start, size_t n, double dt){
+    __m128d one = _mm_set1_pd(1);
+    __m128d step = _mm_set1_pd(dt);
+    __m128d zero = _mm_setzero_pd();
+    for(size_t i = start; i < n; i++){
+        __m128d inverse_mass = _mm_div_pd(one, _mm_set1_pd(mass[i]));
+        __m128d dv = _mm_mul_pd(inverse_mass, _mm_add_pd(_mm_loadu_pd(&impulses[i].x),
+          _mm_mul_pd(step, _mm_loadu_pd(&forces[i].x))));
+        __m128d v = _mm_add_pd(_mm_loadu_pd(&velocity[i].x), dv);
+        __m128d c = _mm_add_pd(_mm_loadu_pd(&centroid[i].x), _mm_mul_pd(step, v));
+        _mm_storeu_pd(&centroid[i].x, c);
+        _mm_storeu_pd(&velocity[i].x, v);
+        _mm_storeu_pd(&forces[i].x, zero);
+        _mm_storeu_pd(&impulses[i].x, zero);
+    }
+}
+
+#endif // #if defined(__SSE2__)
+
+#if defined(__AVX__)
+
+// Two Vectors fit one AVX register as {x0, y0, x1, y1}
+
+const char *vec_batch_instruction_set(void){
+    return "avx";
+}
+
+void vec_batch_translate(Vector *out, const Vector *in, size_t n, Vector translation){
+    __m256d t = _mm256_set_pd(translation.y, translation.x, translation.y, translation.x);
+    size_t i = 0;
+    for(; i + 2 <= n; i += 2){
+        _mm256_storeu_pd(&out[i].x, _mm256_add_pd(_mm256_loadu_pd(&in[i].x), t));
+    }
+    vec_batch_translate_sse2(out, in, i, n, translation);
+}
+
+void vec_batch_rotate(Vector *out, const Vector *in, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset){
+    __m256d c = _mm256_set1_pd(cos_angle);
+    __m256d s = _mm256_set_pd(sin_angle, -sin_angle, sin_angle, -sin_angle);
+    __m256d p = _mm256_set_pd(pivot.y, pivot.x, pivot.y, pivot.x);
+    __m256d o = _mm256_set_pd(offset.y, offset.x, offset.y, offset.x);
+    size_t i = 0;
+    for(; i + 2 <= n; i += 2){
+        __m256d v = _mm256_sub_pd(_mm256_loadu_pd(&in[i].x), p);
+        // Swaps x and y within each vector
+        __m256d swapped = _mm256_permute_pd(v, 0x5);
+        __m256d rotated = _mm256_add_pd(_mm256_mul_pd(v, c), _mm256_mul_pd(swapped, s));
+        _mm256_storeu_pd(&out[i].x, _mm256_add_pd(rotated, o));
+    }
+    vec_batch_rotate_sse2(out, in, i, n, cos_angle, sin_angle, pivot, offset);
+}
+
+void vec_batch_project(const Vector *in, size_t n, Vector axis, double *min, double *max){
+    __m256d a = _mm256_set_pd(axis.y, axis.x, axis.y, axis.x);
+    __m256d lowest = _mm256_set1_pd(INFINITY);
+    __m256d highest = _mm256_set1_pd(-INFINITY);
+    size_t i = 0;
+    for(; i + 2 <= n; i += 2){
+        __m256d products = _mm256_mul_pd(_mm256_loadu_pd(&in[i].x), a);
+        // {x0 ax + y0 ay, (same), x1 ax + y1 ay, (same)}
+        __m256d dots = _mm256_hadd_pd(products, products);
+        lowest = _mm256_min_pd(lowest, dots);
+        highest = _mm256_max_pd(highest, dots);
+    }
+    __m128d low = _mm_min_pd(_mm256_castpd256_pd128(lowest), _mm256_extractf128_pd(lowest, 1));
+    __m128d high = _mm_max_pd(_mm256_castpd256_pd128(highest), _mm256_extractf128_pd(highest, 1));
+    *min = _mm_cvtsd_f64(low);
+    *max = _mm_cvtsd_f64(high);
+    vec_batch_project_sse2(in, i, n, axis, min, max);
+}
+
+double vec_batch_shoelace(const Vector *in, size_t n, Vector *moment){
+    __m256d totals = _mm256_setzero_pd();
+    __m256d moment_sums = _mm256_setzero_pd();
+    size_t i = 0;
+    // Edges i to i + 1 and i + 1 to i + 2, while neither wraps around
+    for(; i + 2 < n; i += 2){
+        __m256d v1 = _mm256_loadu_pd(&in[i].x);
+        __m256d v2 = _mm256_loadu_pd(&in[i + 1].x);
+        __m256d products = _mm256_mul_pd(v1, _mm256_permute_pd(v2, 0x5));
+        // Each edge's cross product, twice
+        __m256d cross = _mm256_hsub_pd(products, products);
+        totals = _mm256_add_pd(totals, cross);
+        moment_sums = _mm256_add_pd(moment_sums, _mm256_mul_pd(cross, _mm256_add_pd(v1, v2)));
+    }
+    __m128d total = _mm_add_sd(_mm256_castpd256_pd128(totals), _mm256_extractf128_pd(totals, 1));
+    __m128d moment_sum = _mm_add_pd(_mm256_castpd256_pd128(moment_sums),
+      _mm256_extractf128_pd(moment_sums, 1));
+    double sum = _mm_cvtsd_f64(total);
+    Vector moment_total;
+    _mm_storeu_pd(&moment_total.x, moment_sum);
+    vec_batch_shoelace_sse2(in, i, n, &sum, &moment_total);
+    if(moment != NULL){
+        *moment = moment_total;
+    }
+    return sum;
+}
+
+void vec_batch_integrate_midpoint(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    __m256d one = _mm256_set1_pd(1);
+    __m256d step = _mm256_set1_pd(dt);
+    __m256d half_step = _mm256_set1_pd(0.5 * dt);
+    __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for(; i + 2 <= n; i += 2){
+        __m256d m = _mm256_set_pd(mass[i + 1], mass[i + 1], mass[i], mass[i]);
+        __m256d v = _mm256_loadu_pd(&velocity[i].x);
+        __m256d final_velocity = _mm256_add_pd(
+          _mm256_add_pd(v, _mm256_mul_pd(_mm256_div_pd(one, m), _mm256_loadu_pd(&impulses[i].x))),
+          _mm256_mul_pd(_mm256_div_pd(step, m), _mm256_loadu_pd(&forces[i].x)));
+        __m256d c = _mm256_loadu_pd(&centroid[i].x);
+        c = _mm256_add_pd(c, _mm256_mul_pd(half_step, _mm256_add_pd(v, final_velocity)));
+        _mm256_storeu_pd(&centroid[i].x, c);
+        _mm256_storeu_pd(&velocity[i].x, final_velocity);
+        _mm256_storeu_pd(&forces[i].x, zero);
+        _mm256_storeu_pd(&impulses[i].x, zero);
+    }
+    vec_batch_integrate_midpoint_sse2(centroid, velocity, forces, impulses, mass, i, n, dt);
+}
+
+void vec_batch_integrate_euler(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    __m256d one = _mm256_set1_pd(1);
+    __m256d step = _mm256_set1_pd(dt);
+    __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for(; i + 2 <= n; i += 2){
+        __m256d m = _mm256_set_pd(mass[i + 1], mass[i + 1], mass[i], mass[i]);
+        __m256d dv = _mm256_mul_pd(_mm256_div_pd(one, m), _mm256_add_pd(
+          _mm256_loadu_pd(&impulses[i].x), _mm256_mul_pd(step, _mm256_loadu_pd(&forces[i].x))));
+        __m256d v = _mm256_add_pd(_mm256_loadu_pd(&velocity[i].x), dv);
+        __m256d c = _mm256_add_pd(_mm256_loadu_pd(&centroid[i].x), _mm256_mul_pd(step, v));
+        _mm256_storeu_pd(&centroid[i].x, c);
+        _mm256_storeu_pd(&velocity[i].x, v);
+        _mm256_storeu_pd(&forces[i].x, zero);
+        _mm256_storeu_pd(&impulses[i].x, zero);
+    }
+    vec_batch_integrate_euler_sse2(centroid, velocity, forces, impulses, mass, i, n, dt);
+}
+
+#elif defined(__SSE2__)
+
+const char *vec_batch_instruction_set(void){
+    return "sse2";
+}
+
+void vec_batch_translate(Vector *out, const Vector *in, size_t n, Vector translation){
+    vec_batch_translate_sse2(out, in, 0, n, translation);
+}
+
+void vec_batch_rotate(Vector *out, const Vector *in, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset){
+    vec_batch_rotate_sse2(out, in, 0, n, cos_angle, sin_angle, pivot, offset);
+}
+
+void vec_batch_project(const Vector *in, size_t n, Vector axis, double *min, double *max){
+    *min = INFINITY;
+    *max = -INFINITY;
+    vec_batch_project_sse2(in, 0, n, axis, min, max);
+}
+
+double vec_batch_shoelace(const Vector *in, size_t n, Vector *moment){
+    double sum = 0;
+    Vector moment_sum = VEC_ZERO;
+    vec_batch_shoelace_sse2(in, 0, n, &sum, &moment_sum);
+    if(moment != NULL){
+        *moment = moment_sum;
+    }
+    return sum;
+}
+
+void vec_batch_integrate_midpoint(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    vec_batch_integrate_midpoint_sse2(centroid, velocity, forces, impulses, mass, 0, n, dt);
+}
+
+void vec_batch_integrate_euler(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    vec_batch_integrate_euler_sse2(centroid, velocity, forces, impulses, mass, 0, n, dt);
+}
+
+#else
+
+const char *vec_batch_instruction_set(void){
+    return "scalar";
+}
+
+void vec_batch_translate(Vector *out, const Vector *in, size_t n, Vector translation){
+    vec_batch_translate_scalar(out, in, n, translation);
+}
+
+void vec_batch_rotate(Vector *out, const Vector *in, size_t n,
+  double cos_angle, double sin_angle, Vector pivot, Vector offset){
+    vec_batch_rotate_scalar(out, in, n, cos_angle, sin_angle, pivot, offset);
+}
+
+void vec_batch_project(const Vector *in, size_t n, Vector axis, double *min, double *max){
+    vec_batch_project_scalar(in, n, axis, min, max);
+}
+
+double vec_batch_shoelace(const Vector *in, size_t n, Vector *moment){
+    return vec_batch_shoelace_scalar(in, n, moment);
+}
+
+void vec_batch_integrate_midpoint(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    vec_batch_integrate_midpoint_scalar(centroid, velocity, forces, impulses, mass, n, dt);
+}
+
+void vec_batch_integrate_euler(Vector *centroid, Vector *velocity, Vector *forces,
+  Vector *impulses, const double *mass, size_t n, double dt){
+    vec_batch_integrate_euler_scalar(centroid, velocity, forces, impulses, mass, n, dt);
+}
+
+#endif
@@ -1,39 +1,119 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "vec_list.h"
 #include "vector.h"
+#include "pool.h"
+#include "arena.h"
+
+// Vertex arrays for up to MAX_POOLED_VERTICES vectors come from VERTEX_POOLS,
+// whose capacities are powers of two starting at MIN_POOLED_VERTICES
+const size_t MIN_POOLED_VERTICES = 4;
+const size_t MAX_POOLED_VERTICES = 64;
+
+Pool VEC_LIST_POOL = POOL_INIT(sizeof(VectorList));
+Pool VERTEX_POOLS[] = {
+    POOL_INIT(4 * sizeof(Vector)),
+    POOL_INIT(8 * sizeof(Vector)),
+    POOL_INIT(16 * sizeof(Vector)),
+    POOL_INIT(32 * sizeof(Vector)),
+    POOL_INIT(64 * sizeof(Vector))
+};
+
+// Rounds a capacity up to the size of a pooled array, if one is big enough
+size_t vertex_capacity(size_t capacity){
+    if(capacity > MAX_POOLED_VERTICES){
+        return capacity;
+    }
+    size_t pooled = MIN_POOLED_VERTICES;
+    while(pooled < capacity){
+        pooled *= 2;
+    }
+    return pooled;
+}
+
+// Returns the pool for arrays of a capacity from vertex_capacity(), or NULL
+Pool *vertex_pool(size_t capacity){
+    if(capacity > MAX_POOLED_VERTICES){
+        return NULL;
+    }
+    size_t index = 0;
+    for(size_t pooled = MIN_POOLED_VERTICES; pooled < capacity; pooled *= 2){
+        index++;
+    }
+    return &VERTEX_POOLS[index];
+}
+
+Vector *vertices_alloc(size_t capacity){
+    Pool *pool = vertex_pool(capacity);
+    Vector *data = pool != NULL ? pool_alloc(pool) : arena_malloc(sizeof(Vector) * capacity);
+    assert(data);
+    return data;
+}
+
+void vertices_release(Vector *data, size_t capacity){
+    Pool *pool = vertex_pool(capacity);
+    if(pool != NULL){
+        pool_release(pool, data);
+    }
+    else{
+        arena_release(data);
+    }
+}
 
 VectorList* vec_list_init(size_t initial_size){
-    return (VectorList*)list_init(initial_size, free);
+    VectorList *list = pool_alloc(&VEC_LIST_POOL);
+    list->capacity = vertex_capacity(initial_size);
+    list->data = vertices_alloc(list->capacity);
+    list->size = 0;
+    list->kind = SHAPE_POLYGON;
+    return list;
 }
 
 void vec_list_free(VectorList* list){
-    list_free((List*)list);
+    vertices_release(list->data, list->capacity);
+    pool_release(&VEC_LIST_POOL, list);
 }
 
-size_t vec_list_size(VectorList *list){
-    return list_size((List*)list);
+size_t vec_list_size(const VectorList *list){
+    return list->size;
 }
 
-Vector vec_list_get(VectorList *list, size_t index){
-    return *(Vector*)list_get((List*)list, index);
+Vector vec_list_get(const VectorList *list, size_t index){
+    assert(index < list->size);
+    return list->data[index];
 }
 
 void vec_list_set(VectorList *list, size_t index, Vector value){
-    Vector* entry = list_get((List*)list, index);
-    *entry = value;
+    assert(index < list->size);
+    list->data[index] = value;
+    list->kind = SHAPE_POLYGON;
 }
 
 void vec_list_add(VectorList *list, Vector value){
-    Vector* entry = malloc(sizeof(Vector));
-    *entry = value;
-    list_add(list, entry);
+    if(list->size == list->capacity){
+        size_t capacity = vertex_capacity(list->capacity * 2);
+        Vector *data = vertices_alloc(capacity);
+        memcpy(data, list->data, sizeof(Vector) * list->size);
+        vertices_release(list->data, list->capacity);
+        list->data = data;
+        list->capacity = capacity;
+    }
+    list->data[list->size++] = value;
+    list->kind = SHAPE_POLYGON;
 }
 
 Vector vec_list_remove(VectorList *list){
-    Vector* removedPointer = (Vector*)list_remove(list, list_size(list) - 1);
-    Vector result = *removedPointer;
-    free(removedPointer);
-    return result;
+    assert(list->size > 0);
+    list->kind = SHAPE_POLYGON;
+    return list->data[--list->size];
+}
+
+VectorList *vec_list_copy(const VectorList *list){
+    VectorList *copy = vec_list_init(list->size);
+    memcpy(copy->data, list->data, sizeof(Vector) * list->size);
+    copy->size = list->size;
+    copy->kind = list->kind;
+    return copy;
 }
@@ -0,0 +1,139 @@
+#include "workers.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct worker{
+    WorkerPool *pool;
+    size_t index;
+    pthread_t thread;
+} Worker;
+
+struct worker_pool{
+    size_t threads;
+    // The started threads, numbered from 1
+    Worker *workers;
+    pthread_mutex_t lock;
+    // Signaled when a run starts or the pool stops
+    pthread_cond_t start;
+    // Signaled when the last started thread finishes its part of a run
+    pthread_cond_t finish;
+    // Counts the runs, so each thread can tell a new one has started
+    size_t run;
+    bool stopping;
+    // The started threads still working on the current run
+    size_t busy;
+    WorkerTask task;
+    void *aux;
+    size_t tasks;
+    // The next task to hand out
+    atomic_size_t next_task;
+};
+
+// Takes tasks of the current run until there are none left
+void worker_pool_work(WorkerPool *pool, size_t worker){
+    size_t task;
+    while((task = atomic_fetch_add(&pool->next_task, 1)) < pool->tasks){
+        pool->task(pool->aux, task, worker);
+    }
+}
+
+void *worker_main(Worker *worker){
+    WorkerPool *pool = worker->pool;
+    size_t run = 0;
+    pthread_mutex_lock(&pool->lock);
+    while(true){
+        while(pool->run == run && !pool->stopping){
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if(pool->stopping){
+            break;
+        }
+        run = pool->run;
+        pthread_mutex_unlock(&pool->lock);
+        worker_pool_work(pool, worker->index);
+        pthread_mutex_lock(&pool->lock);
+        pool->busy--;
+        if(pool->busy == 0){
+            pthread_cond_signal(&pool->finish);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+WorkerPool *worker_pool_init(size_t threads){
+    assert(threads > 0);
+    WorkerPool *pool = malloc(sizeof(WorkerPool));
+    assert(pool);
+    pool->threads = threads;
+    pool->workers = malloc(sizeof(Worker) * threads);
+    assert(pool->workers);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->finish, NULL);
+    pool->run = 0;
+    pool->stopping = false;
+    pool->busy = 0;
+    pool->task = NULL;
+    pool->aux = NULL;
+    pool->tasks = 0;
+    atomic_init(&pool->next_task, 0);
+    for(size_t i = 1; i < threads; i++){
+        Worker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        int error = pthread_create(&worker->thread, NULL,
+          (void *(*)(void *))worker_main, worker);
+        assert(error == 0);
+    }
+    return pool;
+}
+
+void worker_pool_free(WorkerPool *pool){
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for(size_t i = 1; i < pool->threads; i++){
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    pthread_cond_destroy(&pool->finish);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t worker_pool_threads(WorkerPool *pool){
+    return pool->threads;
+}
+
+void worker_pool_run(WorkerPool *pool, WorkerTask task, void *aux, size_t tasks){
+    // Waking the threads isn't worth it for a single task
+    if(pool->threads == 1 || tasks <= 1){
+        for(size_t i = 0; i < tasks; i++){
+            task(aux, i, 0);
+        }
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->aux = aux;
+    pool->tasks = tasks;
+    atomic_store(&pool->next_task, 0);
+    pool->busy = pool->threads - 1;
+    pool->run++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    worker_pool_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while(pool->busy > 0){
+        pthread_cond_wait(&pool->finish, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
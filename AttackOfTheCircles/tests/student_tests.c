@@ -17,20 +17,12 @@ double get_distance_between_centroids(Body *body1, Body *body2){
   return distance_vec(body_get_centroid(body1), body_get_centroid(body2));
 }
 
-List *make_shape() {
-  List *shape = list_init(4, free);
-  Vector *v = malloc(sizeof(*v));
-  *v = (Vector) {-1, -1};
-  list_add(shape, v);
-  v = malloc(sizeof(*v));
-  *v = (Vector) {+1, -1};
-  list_add(shape, v);
-  v = malloc(sizeof(*v));
-  *v = (Vector) {+1, +1};
-  list_add(shape, v);
-  v = malloc(sizeof(*v));
-  *v = (Vector) {-1, +1};
-  list_add(shape, v);
+VectorList *make_shape() {
+  VectorList *shape = vec_list_init(4);
+  vec_list_add(shape, (Vector) {-1, -1});
+  vec_list_add(shape, (Vector) {+1, -1});
+  vec_list_add(shape, (Vector) {+1, +1});
+  vec_list_add(shape, (Vector) {-1, +1});
   return shape;
 }
 
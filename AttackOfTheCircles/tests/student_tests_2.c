@@ -16,26 +16,19 @@
 
 const RGBColor COLOR_YELLOW_temp = {.r = 1, .g = 1, .b = 0};
 
-Vector *vec_clone_temp(Vector v) {
-  Vector *on_heap = malloc(sizeof(Vector));
-  on_heap->x = v.x;
-  on_heap->y = v.y;
-  return on_heap;
-}
-
 double uniform_angle_spacing_temp(size_t num_vertices) {
   return 2 * M_PI / num_vertices;
 }
 
-List *polygon_init_regular_temp(size_t num_vertices, double radius) {
-  List *polygon = list_init(num_vertices, free);
+VectorList *polygon_init_regular_temp(size_t num_vertices, double radius) {
+  VectorList *polygon = vec_list_init(num_vertices);
 
   double vertex_spacing_angle = uniform_angle_spacing_temp(num_vertices);
   Vector vector = {.x = radius, .y = 0};
 
   for (size_t i = 0; i < num_vertices; i++) {
     vector = vec_rotate(vector, vertex_spacing_angle);
-    list_add(polygon, vec_clone_temp(vector));
+    vec_list_add(polygon, vector);
   }
 
   return polygon;
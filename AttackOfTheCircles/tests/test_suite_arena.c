@@ -0,0 +1,156 @@
+#include "arena.h"
+#include "forces.h"
+#include "pool.h"
+#include "shape.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tests bump allocation, including objects bigger than a chunk
+void test_arena_alloc() {
+    Arena *arena = arena_init();
+    assert(arena_bytes(arena) == 0);
+    char *objects[1000];
+    for (size_t i = 0; i < 1000; i++) {
+        objects[i] = arena_alloc(arena, 1 + i % 100);
+        assert((uintptr_t) objects[i] % alignof(max_align_t) == 0);
+        memset(objects[i], (int) i, 1 + i % 100);
+        assert(arena_owns(objects[i]));
+    }
+    // No two objects overlap
+    for (size_t i = 0; i < 1000; i++) {
+        for (size_t j = 0; j < 1 + i % 100; j++) {
+            assert(objects[i][j] == (char) i);
+        }
+    }
+    assert(arena_bytes(arena) >= 1000);
+
+    char *big = arena_alloc(arena, 1000000);
+    memset(big, 1, 1000000);
+    assert(arena_owns(big));
+    char *after = arena_alloc(arena, 16);
+    assert(arena_owns(after));
+
+    void *heap = malloc(16);
+    assert(!arena_owns(heap));
+    assert(!arena_owns(NULL));
+    free(heap);
+    arena_free(arena);
+    assert(!arena_owns(objects[0]));
+    assert(!arena_owns(big));
+}
+
+// Tests that pools and arena_malloc() use the current arena
+void test_current_arena() {
+    Arena *arena = arena_init();
+    Pool *pool = pool_init(sizeof(double));
+    assert(arena_current() == NULL);
+
+    arena_set_current(arena);
+    double *pooled = pool_alloc(pool);
+    assert(arena_owns(pooled));
+    assert(pool_live(pool) == 0);
+    pool_release(pool, pooled);
+    assert(pool_live(pool) == 0);
+    void *object = arena_malloc(100);
+    assert(arena_owns(object));
+    arena_release(object);
+
+    arena_set_current(NULL);
+    pooled = pool_alloc(pool);
+    assert(!arena_owns(pooled));
+    assert(pool_live(pool) == 1);
+    pool_release(pool, pooled);
+    object = arena_malloc(100);
+    assert(!arena_owns(object));
+    arena_release(object);
+
+    // Freeing the current arena leaves no arena current
+    arena_set_current(arena);
+    arena_free(arena);
+    assert(arena_current() == NULL);
+    pool_free(pool);
+}
+
+// Tests two arenas whose chunks are interleaved
+void test_two_arenas() {
+    Arena *arena1 = arena_init();
+    Arena *arena2 = arena_init();
+    void *objects1[100];
+    void *objects2[100];
+    for (size_t i = 0; i < 100; i++) {
+        objects1[i] = arena_alloc(arena1, 5000);
+        objects2[i] = arena_alloc(arena2, 5000);
+    }
+    arena_free(arena1);
+    for (size_t i = 0; i < 100; i++) {
+        assert(!arena_owns(objects1[i]));
+        assert(arena_owns(objects2[i]));
+    }
+    arena_free(arena2);
+}
+
+Body *add_box(Scene *scene, Vector centroid) {
+    Body *body = body_init(shape_rectangle(1, 1), 1, (RGBColor) {0, 0, 0});
+    body_set_centroid(body, centroid);
+    scene_add_body(scene, body);
+    return body;
+}
+
+void ignore_collision(Body *body1, Body *body2, Vector axis, void *aux,
+  CollisionEventType type) {
+}
+
+// Tests a scene with objects in and out of its arena.
+// Under asan, leaks are reported if scene_free() misses anything.
+void test_scene_arena() {
+    Scene *scene = scene_init();
+    scene_use_arena(scene, true);
+    Body *bodies[300];
+    for (size_t i = 0; i < 300; i++) {
+        bodies[i] = add_box(scene, (Vector) {i * 3, 0});
+    }
+    for (size_t i = 1; i < 300; i++) {
+        create_newtonian_gravity(scene, 1, bodies[i - 1], bodies[i]);
+        create_collision(scene, bodies[i - 1], bodies[i], ignore_collision, NULL, NULL);
+    }
+    // An anchor that is never added to the scene is still freed with the arena
+    Body *anchor = body_init(shape_rectangle(1, 1), 1, (RGBColor) {0, 0, 0});
+    create_spring(scene, 1, bodies[0], anchor);
+    // Its list of bodies outgrows its arena array while ticking
+    create_scene_gravity(scene, 1, 0.5);
+    scene_use_arena(scene, false);
+    assert(arena_current() == NULL);
+    assert(arena_owns(bodies[0]));
+
+    Body *outside = add_box(scene, (Vector) {0, 10});
+    assert(!arena_owns(outside));
+    create_newtonian_gravity(scene, 1, outside, bodies[0]);
+    body_remove(bodies[5]);
+    for (int i = 0; i < 10; i++) {
+        scene_tick(scene, 0.01);
+    }
+    assert(scene_bodies(scene) == 300);
+    scene_free(scene);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_arena_alloc)
+    DO_TEST(test_current_arena)
+    DO_TEST(test_two_arenas)
+    DO_TEST(test_scene_arena)
+
+    puts("arena_test PASS");
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "batch.h"
+#include "gen_forces.h"
+#include "gen_levels.h"
+#include "helpers.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+const double BATCH_PLAYER_SIZE = 100;
+const double BATCH_DT = 1.0 / 120;
+
+Scene *make_level(int level) {
+    Scene *scene = scene_init();
+    scene_seed(scene, level);
+    Body *player = gen_player_sq(BATCH_PLAYER_SIZE, scene);
+    switch (level % 5) {
+        case 0: gen_tutorial_level(BATCH_PLAYER_SIZE, scene, player); break;
+        case 1: gen_first_level(BATCH_PLAYER_SIZE, scene, player); break;
+        case 2: gen_second_level(BATCH_PLAYER_SIZE, scene, player); break;
+        case 3: gen_third_level(BATCH_PLAYER_SIZE, scene, player); break;
+        default: gen_boss_level(BATCH_PLAYER_SIZE, scene, player); break;
+    }
+    gen_forces(scene);
+    return scene;
+}
+
+SceneInput released_input() {
+    SceneInput input;
+    for (int key = 0; key < SCENE_KEYS; key++) {
+        input.keys[key] = KEY_RELEASED;
+    }
+    return input;
+}
+
+SceneInput make_input(int level, int step) {
+    SceneInput input = released_input();
+    input.keys[(level + step) % 2 == 0 ? RIGHT_ARROW : LEFT_ARROW] = KEY_PRESSED;
+    if (step % 3 == 0) {
+        input.keys[UP_ARROW] = KEY_PRESSED;
+    }
+    return input;
+}
+
+void test_add_get_replace() {
+    SceneBatch *batch = scene_batch_init(2);
+    assert(scene_batch_size(batch) == 0);
+    Scene *scenes[3];
+    for (size_t i = 0; i < 3; i++) {
+        scenes[i] = scene_init();
+        assert(scene_batch_add(batch, scenes[i]) == i);
+    }
+    assert(scene_batch_size(batch) == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(scene_batch_get(batch, i) == scenes[i]);
+    }
+    Scene *replacement = scene_init();
+    scene_batch_replace(batch, 1, replacement);
+    assert(scene_batch_get(batch, 1) == replacement);
+    assert(scene_batch_size(batch) == 3);
+    // Ticking an empty scene or no scenes at all does nothing
+    scene_batch_tick(batch, NULL, BATCH_DT, 2);
+    scene_batch_free(batch);
+    batch = scene_batch_init(3);
+    scene_batch_tick(batch, NULL, BATCH_DT, 1);
+    scene_batch_free(batch);
+}
+
+// Tests that a batch on several threads moves every scene exactly like
+// ticking each scene alone, with the same inputs
+void test_batch_matches_serial() {
+    const int SCENES = 7;
+    const int STEPS = 10;
+    const size_t TICKS = 12;
+    Scene *serial[SCENES];
+    for (int i = 0; i < SCENES; i++) {
+        serial[i] = make_level(i);
+    }
+    for (int step = 0; step < STEPS; step++) {
+        for (int i = 0; i < SCENES; i++) {
+            SceneInput input = make_input(i, step);
+            memcpy(scene_key_data(serial[i]), input.keys, sizeof(input.keys));
+            for (size_t tick = 0; tick < TICKS; tick++) {
+                scene_tick(serial[i], BATCH_DT);
+            }
+        }
+    }
+
+    for (size_t threads = 1; threads <= 4; threads += 3) {
+        SceneBatch *batch = scene_batch_init(threads);
+        for (int i = 0; i < SCENES; i++) {
+            scene_batch_add(batch, make_level(i));
+        }
+        SceneInput inputs[SCENES];
+        for (int step = 0; step < STEPS; step++) {
+            for (int i = 0; i < SCENES; i++) {
+                inputs[i] = make_input(i, step);
+            }
+            scene_batch_tick(batch, inputs, BATCH_DT, TICKS);
+        }
+        for (int i = 0; i < SCENES; i++) {
+            Scene *scene = scene_batch_get(batch, i);
+            assert(scene_bodies(scene) == scene_bodies(serial[i]));
+            assert(scene_get_time(scene) == scene_get_time(serial[i]));
+            for (size_t j = 0; j < scene_bodies(scene); j++) {
+                Body *body = scene_get_body(scene, j);
+                Body *expected = scene_get_body(serial[i], j);
+                assert(vec_equal(body_get_centroid(body), body_get_centroid(expected)));
+                assert(vec_equal(body_get_velocity(body), body_get_velocity(expected)));
+            }
+        }
+        scene_batch_free(batch);
+    }
+    for (int i = 0; i < SCENES; i++) {
+        scene_free(serial[i]);
+    }
+}
+
+// Tests that each scene's input replaces its key data and moves its player
+void test_inputs_drive_player() {
+    SceneBatch *batch = scene_batch_init(2);
+    for (int i = 0; i < 3; i++) {
+        scene_batch_add(batch, make_level(0));
+    }
+    double start = body_get_centroid(get_first_body(scene_batch_get(batch, 0), PLAYER)).x;
+    SceneInput inputs[3] = {released_input(), released_input(), released_input()};
+    inputs[0].keys[RIGHT_ARROW] = KEY_PRESSED;
+    inputs[2].keys[LEFT_ARROW] = KEY_PRESSED;
+    scene_batch_tick(batch, inputs, BATCH_DT, 30);
+    double x[3];
+    for (int i = 0; i < 3; i++) {
+        Scene *scene = scene_batch_get(batch, i);
+        assert(memcmp(scene_key_data(scene), inputs[i].keys, sizeof(inputs[i].keys)) == 0);
+        x[i] = body_get_centroid(get_first_body(scene, PLAYER)).x;
+    }
+    assert(x[0] > start);
+    assert(within(1, x[1], start));
+    assert(x[2] < start);
+
+    // Without inputs, the keys stay as they were
+    scene_batch_tick(batch, NULL, BATCH_DT, 30);
+    assert(body_get_centroid(get_first_body(scene_batch_get(batch, 0), PLAYER)).x > x[0]);
+    assert(scene_key_data(scene_batch_get(batch, 0))[RIGHT_ARROW] == KEY_PRESSED);
+    scene_batch_free(batch);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_add_get_replace)
+    DO_TEST(test_batch_matches_serial)
+    DO_TEST(test_inputs_drive_player)
+
+    puts("batch_test PASS");
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "body.h"
+#include "shape.h"
 #include "test_util.h"
 #include <assert.h>
 #include <math.h>
@@ -7,20 +8,18 @@
 void test_body_init() {
     Vector v[] = {{1, 1}, {2, 1}, {2, 2}, {1, 2}};
     const size_t VERTICES = sizeof(v) / sizeof(*v);
-    List *shape = list_init(0, free);
+    VectorList *shape = vec_list_init(0);
     for (size_t i = 0; i < VERTICES; i++) {
-        Vector *list_v = malloc(sizeof(*list_v));
-        *list_v = v[i];
-        list_add(shape, list_v);
+        vec_list_add(shape, v[i]);
     }
     RGBColor color = {0, 0.5, 1};
     Body *body = body_init(shape, 3, color);
-    List *shape2 = body_get_shape(body);
-    assert(list_size(shape2) == VERTICES);
+    VectorList *shape2 = body_get_shape(body);
+    assert(vec_list_size(shape2) == VERTICES);
     for (size_t i = 0; i < VERTICES; i++) {
-        assert(vec_isclose(*(Vector *) list_get(shape2, i), v[i]));
+        assert(vec_isclose(vec_list_get(shape2, i), v[i]));
     }
-    list_free(shape2);
+    vec_list_free(shape2);
     assert(vec_isclose(body_get_centroid(body), (Vector) {1.5, 1.5}));
     assert(vec_equal(body_get_velocity(body), VEC_ZERO));
     assert(body_get_color(body).r == color.r);
@@ -31,16 +30,10 @@ void test_body_init() {
 }
 
 void test_body_setters() {
-    List *shape = list_init(3, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = (Vector) {+1, 0};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {0, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, 0};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(3);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
     Body *body = body_init(shape, 1, (RGBColor) {0, 0, 0});
     body_set_velocity(body, (Vector) {+5, -5});
     assert(vec_equal(body_get_velocity(body), (Vector) {+5, -5}));
@@ -48,27 +41,105 @@ void test_body_setters() {
     body_set_centroid(body, (Vector) {1, 2});
     assert(vec_isclose(body_get_centroid(body), (Vector) {1, 2}));
     shape = body_get_shape(body);
-    assert(list_size(shape) == 3);
-    assert(vec_isclose(*(Vector *) list_get(shape, 0), (Vector) {2, 5.0 / 3.0}));
-    assert(vec_isclose(*(Vector *) list_get(shape, 1), (Vector) {1, 8.0 / 3.0}));
-    assert(vec_isclose(*(Vector *) list_get(shape, 2), (Vector) {0, 5.0 / 3.0}));
-    list_free(shape);
+    assert(vec_list_size(shape) == 3);
+    assert(vec_isclose(vec_list_get(shape, 0), (Vector) {2, 5.0 / 3.0}));
+    assert(vec_isclose(vec_list_get(shape, 1), (Vector) {1, 8.0 / 3.0}));
+    assert(vec_isclose(vec_list_get(shape, 2), (Vector) {0, 5.0 / 3.0}));
+    vec_list_free(shape);
     body_set_rotation(body, M_PI / 2);
     assert(vec_isclose(body_get_centroid(body), (Vector) {1, 2}));
     shape = body_get_shape(body);
-    assert(list_size(shape) == 3);
-    assert(vec_isclose(*(Vector *) list_get(shape, 0), (Vector) {4.0 / 3.0, 3}));
-    assert(vec_isclose(*(Vector *) list_get(shape, 1), (Vector) {1.0 / 3.0, 2}));
-    assert(vec_isclose(*(Vector *) list_get(shape, 2), (Vector) {4.0 / 3.0, 1}));
-    list_free(shape);
+    assert(vec_list_size(shape) == 3);
+    assert(vec_isclose(vec_list_get(shape, 0), (Vector) {4.0 / 3.0, 3}));
+    assert(vec_isclose(vec_list_get(shape, 1), (Vector) {1.0 / 3.0, 2}));
+    assert(vec_isclose(vec_list_get(shape, 2), (Vector) {4.0 / 3.0, 1}));
+    vec_list_free(shape);
     body_set_centroid(body, (Vector) {3, 4});
     assert(vec_isclose(body_get_centroid(body), (Vector) {3, 4}));
     shape = body_get_shape(body);
-    assert(list_size(shape) == 3);
-    assert(vec_isclose(*(Vector *) list_get(shape, 0), (Vector) {10.0 / 3.0, 5}));
-    assert(vec_isclose(*(Vector *) list_get(shape, 1), (Vector) {7.0 / 3.0, 4}));
-    assert(vec_isclose(*(Vector *) list_get(shape, 2), (Vector) {10.0 / 3.0, 3}));
-    list_free(shape);
+    assert(vec_list_size(shape) == 3);
+    assert(vec_isclose(vec_list_get(shape, 0), (Vector) {10.0 / 3.0, 5}));
+    assert(vec_isclose(vec_list_get(shape, 1), (Vector) {7.0 / 3.0, 4}));
+    assert(vec_isclose(vec_list_get(shape, 2), (Vector) {10.0 / 3.0, 3}));
+    vec_list_free(shape);
+    body_free(body);
+}
+
+// Tests that the shape view follows the body without being reallocated
+void test_body_shape_view() {
+    VectorList *shape = vec_list_init(3);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
+    Body *body = body_init(shape, 1, (RGBColor) {0, 0, 0});
+    const VectorList *view = body_get_shape_view(body);
+    assert(vec_list_size(view) == 3);
+    assert(vec_isclose(vec_list_get(view, 1), (Vector) {0, 1}));
+    body_set_centroid(body, (Vector) {10, 1.0 / 3.0});
+    body_set_velocity(body, (Vector) {0, 2});
+    body_tick(body, 1);
+    // Getting the view again updates the same vertices in place
+    assert(body_get_shape_view(body) == view);
+    assert(vec_isclose(vec_list_get(view, 0), (Vector) {11, 2}));
+    assert(vec_isclose(vec_list_get(view, 1), (Vector) {10, 3}));
+    assert(vec_isclose(vec_list_get(view, 2), (Vector) {9, 2}));
+    body_free(body);
+}
+
+// Tests blending a body's shape between its saved and current transforms
+void test_body_interpolated_shape() {
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
+    vec_list_add(shape, (Vector) {0, -1});
+    Body *body = body_init(shape, 1, (RGBColor) {0, 0, 0});
+    VectorList *scratch = vec_list_init(0);
+    const VectorList *view = body_get_shape_view(body);
+    // Nothing is blended before the transform is saved
+    body_set_centroid(body, (Vector) {5, 0});
+    assert(body_get_interpolated_shape(body, 0.5, scratch) == view);
+
+    body_save_transform(body);
+    assert(body_get_interpolated_shape(body, 0.5, scratch) == view);
+    body_set_centroid(body, (Vector) {15, 10});
+    const VectorList *blended = body_get_interpolated_shape(body, 0.5, scratch);
+    assert(blended == scratch);
+    assert(vec_list_size(blended) == 4);
+    assert(vec_isclose(vec_list_get(blended, 0), (Vector) {11, 5}));
+    assert(vec_isclose(vec_list_get(blended, 1), (Vector) {10, 6}));
+    blended = body_get_interpolated_shape(body, 0, scratch);
+    assert(vec_isclose(vec_list_get(blended, 2), (Vector) {4, 0}));
+    assert(body_get_interpolated_shape(body, 1, scratch) == view);
+    assert(vec_isclose(vec_list_get(view, 0), (Vector) {16, 10}));
+
+    // Rotations blend the short way across the wrap from pi to -pi
+    body_set_rotation(body, 3.0);
+    body_save_transform(body);
+    body_set_rotation(body, -3.0);
+    blended = body_get_interpolated_shape(body, 0.5, scratch);
+    double angle = 3.0 + 0.5 * (2 * M_PI - 6.0);
+    assert(vec_isclose(vec_list_get(blended, 0),
+        (Vector) {15 + cos(angle), 10 + sin(angle)}));
+    vec_list_free(scratch);
+    body_free(body);
+}
+
+// Tests that convexity is worked out from the shape and survives rotation
+void test_body_is_convex() {
+    Body *circle = body_init(shape_circle(1, 12), 1, (RGBColor) {0, 0, 0});
+    assert(body_is_convex(circle));
+    body_free(circle);
+
+    Vector v[] = {{0, 0}, {4, 0}, {4, 4}, {2, 1}, {0, 4}};
+    VectorList *shape = vec_list_init(0);
+    for (size_t i = 0; i < sizeof(v) / sizeof(*v); i++) {
+        vec_list_add(shape, v[i]);
+    }
+    Body *body = body_init(shape, 1, (RGBColor) {0, 0, 0});
+    assert(!body_is_convex(body));
+    body_set_rotation(body, M_PI / 3);
+    assert(!body_is_convex(body));
     body_free(body);
 }
 
@@ -76,19 +147,11 @@ void test_body_tick() {
     const Vector A = {1, 2};
     const double DT = 1e-6;
     const int STEPS = 1000000;
-    List *shape = list_init(4, free);
-    Vector *v = malloc(sizeof(*v));
-    v->x = v->y = -1;
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {+1, -1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    v->x = v->y = +1;
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, +1};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {-1, -1});
+    vec_list_add(shape, (Vector) {+1, -1});
+    vec_list_add(shape, (Vector) {+1, +1});
+    vec_list_add(shape, (Vector) {-1, +1});
     Body *body = body_init(shape, 1, (RGBColor) {0, 0, 0});
 
     // Apply constant acceleration and ensure position is (a / 2) * t ** 2
@@ -101,28 +164,207 @@ void test_body_tick() {
     double t = STEPS * DT;
     Vector new_x = vec_multiply(t * t / 2, A);
     shape = body_get_shape(body);
-    assert(vec_isclose(*(Vector *) list_get(shape, 0), vec_add((Vector) {-1, -1}, new_x)));
-    assert(vec_isclose(*(Vector *) list_get(shape, 1), vec_add((Vector) {+1, -1}, new_x)));
-    assert(vec_isclose(*(Vector *) list_get(shape, 2), vec_add((Vector) {+1, +1}, new_x)));
-    assert(vec_isclose(*(Vector *) list_get(shape, 3), vec_add((Vector) {-1, +1}, new_x)));
-    list_free(shape);
+    assert(vec_isclose(vec_list_get(shape, 0), vec_add((Vector) {-1, -1}, new_x)));
+    assert(vec_isclose(vec_list_get(shape, 1), vec_add((Vector) {+1, -1}, new_x)));
+    assert(vec_isclose(vec_list_get(shape, 2), vec_add((Vector) {+1, +1}, new_x)));
+    assert(vec_isclose(vec_list_get(shape, 3), vec_add((Vector) {-1, +1}, new_x)));
+    vec_list_free(shape);
+    body_free(body);
+}
+
+Body *make_integrated_body(Vector velocity) {
+    Body *body = body_init(shape_rectangle(2, 2), 2, (RGBColor) {0, 0, 0});
+    body_set_centroid(body, VEC_ZERO);
+    body_set_velocity(body, velocity);
+    return body;
+}
+
+// Tests each integrator under a constant force, and that velocity Verlet
+// handles impulses like body_tick()
+void test_body_integrators() {
+    const Vector V = {1, -2};
+    const Vector A = {3, 4};
+    const double DT = 0.1;
+    const int STEPS = 10;
+    const Integrator EXACT[] = {
+        INTEGRATOR_MIDPOINT, INTEGRATOR_VELOCITY_VERLET, INTEGRATOR_MULTISTEP
+    };
+    for (size_t i = 0; i < sizeof(EXACT) / sizeof(*EXACT); i++) {
+        Body *body = make_integrated_body(V);
+        for (int step = 1; step <= STEPS; step++) {
+            body_add_force(body, vec_multiply(2, A));
+            body_integrate(body, DT, EXACT[i]);
+            double t = step * DT;
+            assert(vec_isclose(body_get_centroid(body),
+                vec_add(vec_multiply(t, V), vec_multiply(t * t / 2, A))));
+            assert(vec_isclose(body_get_velocity(body), vec_add(V, vec_multiply(t, A))));
+        }
+        body_free(body);
+    }
+
+    // Semi-implicit Euler moves at the velocity after each tick
+    Body *body = make_integrated_body(V);
+    for (int step = 1; step <= STEPS; step++) {
+        body_add_force(body, vec_multiply(2, A));
+        body_integrate(body, DT, INTEGRATOR_SEMI_IMPLICIT_EULER);
+    }
+    assert(vec_isclose(body_get_centroid(body), vec_add(vec_multiply(STEPS * DT, V),
+        vec_multiply(DT * DT * STEPS * (STEPS + 1) / 2, A))));
+    assert(vec_isclose(body_get_velocity(body), vec_add(V, vec_multiply(STEPS * DT, A))));
     body_free(body);
+
+    // With a changing force, velocity Verlet corrects each tick's velocity by
+    // half the change in acceleration since the first tick (which is 0 here)
+    Body *verlet = make_integrated_body(V);
+    Body *midpoint = make_integrated_body(V);
+    Vector offset = VEC_ZERO;
+    for (int step = 0; step < STEPS; step++) {
+        Vector force = {step, -step * step};
+        body_add_force(verlet, force);
+        body_add_force(midpoint, force);
+        if (step % 3 == 0) {
+            body_add_impulse(verlet, (Vector) {5, step});
+            body_add_impulse(midpoint, (Vector) {5, step});
+        }
+        body_integrate(verlet, DT, INTEGRATOR_VELOCITY_VERLET);
+        body_tick(midpoint, DT);
+        offset = vec_add(offset, vec_multiply(DT * DT / 2 / 2, force));
+    }
+    assert(vec_isclose(body_get_centroid(verlet),
+        vec_add(body_get_centroid(midpoint), offset)));
+
+    // Switching integrators replaces the body's history
+    body_integrate(verlet, DT, INTEGRATOR_MULTISTEP);
+    body_integrate(verlet, DT, INTEGRATOR_MULTISTEP);
+    body_integrate(verlet, DT, INTEGRATOR_VELOCITY_VERLET);
+    body_free(verlet);
+    body_free(midpoint);
+}
+
+// Tests that bodies moved into a store keep their state,
+// and that one sweep over the store ticks them like body_tick()
+void test_body_store() {
+    const double DT = 0.1;
+    BodyStore *store = body_store_init();
+    body_store_reserve(store, 4);
+    Body *stored[3];
+    Body *alone[3];
+    for (size_t i = 0; i < 3; i++) {
+        for (int copy = 0; copy < 2; copy++) {
+            Body *body = body_init(shape_rectangle(1, 1), i + 1, (RGBColor) {0, 0, 0});
+            body_set_centroid(body, (Vector) {i, -1});
+            body_set_velocity(body, (Vector) {1, i});
+            body_add_force(body, (Vector) {i, 2});
+            if (copy == 0) {
+                // Entry 1 is left empty
+                body_move_to_store(body, store, i == 0 ? 0 : i + 1);
+                stored[i] = body;
+            } else {
+                alone[i] = body;
+            }
+        }
+        assert(vec_equal(body_get_centroid(stored[i]), (Vector) {i, -1}));
+        assert(body_get_mass(stored[i]) == i + 1);
+    }
+    body_store_reserve(store, 100);
+    for (int step = 0; step < 5; step++) {
+        for (size_t i = 0; i < 3; i++) {
+            body_add_impulse(stored[i], (Vector) {step, 1});
+            body_add_impulse(alone[i], (Vector) {step, 1});
+            body_tick(alone[i], DT);
+        }
+        body_store_integrate(store, 4, DT, INTEGRATOR_MIDPOINT);
+        for (size_t i = 0; i < 3; i++) {
+            assert(vec_equal(body_get_centroid(stored[i]), body_get_centroid(alone[i])));
+            assert(vec_equal(body_get_velocity(stored[i]), body_get_velocity(alone[i])));
+        }
+    }
+    // The shape follows the stored centroid
+    const VectorList *shape = body_get_shape_view(stored[2]);
+    assert(vec_isclose(polygon_centroid((VectorList *) shape), body_get_centroid(stored[2])));
+
+    // Sweeping over a freed body's entry is safe
+    body_free(stored[1]);
+    body_store_integrate(store, 4, DT, INTEGRATOR_SEMI_IMPLICIT_EULER);
+    body_free(stored[0]);
+    body_free(stored[2]);
+    for (size_t i = 0; i < 3; i++) {
+        body_free(alone[i]);
+    }
+    body_store_free(store);
+}
+
+// Tests that forces and impulses recorded in a log reach the bodies once it
+// is applied: in the same order as adding them directly, or summed per body
+void test_force_log() {
+    const double DT = 0.1;
+    BodyStore *store = body_store_init();
+    body_store_reserve(store, 3);
+    Body *logged[4];
+    Body *direct[4];
+    for (size_t i = 0; i < 4; i++) {
+        logged[i] = body_init(shape_rectangle(1, 1), 3, (RGBColor) {0, 0, 0});
+        direct[i] = body_init(shape_rectangle(1, 1), 3, (RGBColor) {0, 0, 0});
+        // The last body stays outside the store
+        if (i < 3) {
+            body_move_to_store(logged[i], store, i);
+        }
+    }
+    Vector forces[] = {{0.1, 0.7}, {1e8, -3}, {-1e8, 0.3}, {1.0 / 3, 2}};
+    for (int sum = 0; sum < 2; sum++) {
+        ForceLog *log = force_log_init();
+        for (int round = 0; round < 2; round++) {
+            force_log_start(log, sum ? store : NULL);
+            for (size_t i = 0; i < 4; i++) {
+                for (size_t j = 0; j < 4; j++) {
+                    body_add_force(logged[i], forces[j]);
+                    body_add_impulse(logged[i], forces[(i + j) % 4]);
+                }
+            }
+            force_log_stop();
+        }
+        // Nothing reaches the bodies before the log is applied
+        body_tick(logged[3], DT);
+        assert(vec_equal(body_get_velocity(logged[3]), body_get_velocity(direct[3])));
+        force_log_apply(log);
+        for (int round = 0; round < 2; round++) {
+            for (size_t i = 0; i < 4; i++) {
+                for (size_t j = 0; j < 4; j++) {
+                    body_add_force(direct[i], forces[j]);
+                    body_add_impulse(direct[i], forces[(i + j) % 4]);
+                }
+            }
+        }
+        body_store_integrate(store, 3, DT, INTEGRATOR_MIDPOINT);
+        for (size_t i = 0; i < 4; i++) {
+            if (i == 3) {
+                body_tick(logged[i], DT);
+            }
+            body_tick(direct[i], DT);
+            Vector expected = body_get_velocity(direct[i]);
+            Vector velocity = body_get_velocity(logged[i]);
+            // The body outside the store is always replayed in order
+            if (sum == 0 || i == 3) {
+                assert(vec_equal(velocity, expected));
+            } else {
+                assert(vec_isclose(velocity, expected));
+            }
+        }
+        force_log_free(log);
+    }
+    for (size_t i = 0; i < 4; i++) {
+        body_free(logged[i]);
+        body_free(direct[i]);
+    }
+    body_store_free(store);
 }
 
 void test_infinite_mass() {
-    List *shape = list_init(10, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = VEC_ZERO;
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {+1, 0};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {+1, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {0, +1};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(10);
+    vec_list_add(shape, VEC_ZERO);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {+1, +1});
+    vec_list_add(shape, (Vector) {0, +1});
     Body *body = body_init(shape, INFINITY, (RGBColor) {0, 0, 0});
     body_set_velocity(body, (Vector) {2, 3});
     assert(body_get_mass(body) == INFINITY);
@@ -136,16 +378,10 @@ void test_infinite_mass() {
 void test_forces() {
     const double MASS = 10;
     const double DT = 0.1;
-    List *shape = list_init(3, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = (Vector) {+1, 0};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {0, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, 0};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(3);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
     Body *body = body_init(shape, MASS, (RGBColor) {0, 0, 0});
     body_set_centroid(body, VEC_ZERO);
     Vector old_velocity = {1, -2};
@@ -169,16 +405,10 @@ void test_forces() {
 }
 
 void test_body_remove() {
-    List *shape = list_init(3, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = (Vector) {+1, 0};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {0, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, 0};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(3);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
     Body *body = body_init(shape, 1, (RGBColor) {0, 0, 0});
     assert(!body_is_removed(body));
     body_remove(body);
@@ -189,16 +419,10 @@ void test_body_remove() {
 }
 
 void test_body_info() {
-    List *shape = list_init(3, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = (Vector) {+1, 0};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {0, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, 0};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(3);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
     int *info = malloc(sizeof(*info));
     *info = 123;
     Body *body = body_init_with_info(shape, 1, (RGBColor) {0, 0, 0}, info, NULL);
@@ -208,16 +432,10 @@ void test_body_info() {
 }
 
 void test_body_info_freer() {
-    List *shape = list_init(3, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = (Vector) {+1, 0};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {0, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, 0};
-    list_add(shape, v);
+    VectorList *shape = vec_list_init(3);
+    vec_list_add(shape, (Vector) {+1, 0});
+    vec_list_add(shape, (Vector) {0, +1});
+    vec_list_add(shape, (Vector) {-1, 0});
     List *info = list_init(3, free);
     int *info_elem = malloc(sizeof(*info_elem));
     *info_elem = 10;
@@ -248,7 +466,13 @@ int main(int argc, char *argv[]) {
 
     DO_TEST(test_body_init)
     DO_TEST(test_body_setters)
+    DO_TEST(test_body_shape_view)
+    DO_TEST(test_body_interpolated_shape)
+    DO_TEST(test_body_is_convex)
     DO_TEST(test_body_tick)
+    DO_TEST(test_body_integrators)
+    DO_TEST(test_body_store)
+    DO_TEST(test_force_log)
     DO_TEST(test_infinite_mass)
     DO_TEST(test_forces)
     DO_TEST(test_body_remove)
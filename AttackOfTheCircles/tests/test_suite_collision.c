@@ -1,5 +1,162 @@
+#include "collision.h"
+#include "polygon.h"
+#include "shape.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
 #include <stdlib.h>
 
-int main(int argc, char* argv[]){
-	return 0;
+VectorList *make_rectangle(Vector center, double width, double height) {
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {center.x + width / 2, center.y + height / 2});
+    vec_list_add(shape, (Vector) {center.x - width / 2, center.y + height / 2});
+    vec_list_add(shape, (Vector) {center.x - width / 2, center.y - height / 2});
+    vec_list_add(shape, (Vector) {center.x + width / 2, center.y - height / 2});
+    return shape;
+}
+
+// Tests that overlapping squares collide along the shallowest axis
+void test_square_depth() {
+    VectorList *square1 = make_rectangle(VEC_ZERO, 2, 2);
+    VectorList *square2 = make_rectangle((Vector) {1.5, 0.25}, 2, 2);
+    CollisionInfo info = find_collision(square1, square2);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (Vector) {1, 0}));
+    assert(isclose(info.depth, 0.5));
+
+    // The axis points from the first shape to the second
+    info = find_collision(square2, square1);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (Vector) {-1, 0}));
+    assert(isclose(info.depth, 0.5));
+    vec_list_free(square1);
+    vec_list_free(square2);
+}
+
+// Tests shapes that are separated only by an axis from the second shape
+void test_separated() {
+    VectorList *square = make_rectangle(VEC_ZERO, 2, 2);
+    VectorList *far = make_rectangle((Vector) {5, 0}, 2, 2);
+    assert(!find_collision(square, far).collided);
+
+    // The square's normals all overlap the triangle; the hypotenuse separates them
+    VectorList *triangle = vec_list_init(3);
+    vec_list_add(triangle, (Vector) {2.5, 0.5});
+    vec_list_add(triangle, (Vector) {2.5, 2.5});
+    vec_list_add(triangle, (Vector) {0.5, 2.5});
+    assert(!find_collision(square, triangle).collided);
+    assert(!find_collision(triangle, square).collided);
+    polygon_translate(triangle, (Vector) {-0.8, -0.8});
+    CollisionInfo info = find_collision(square, triangle);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (Vector) {M_SQRT1_2, M_SQRT1_2}));
+    assert(isclose(info.depth, 0.6 * M_SQRT1_2));
+    vec_list_free(square);
+    vec_list_free(far);
+    vec_list_free(triangle);
+}
+
+// Tests a circle resting on a rectangle
+void test_circle_rectangle() {
+    VectorList *floor = make_rectangle((Vector) {0, -10}, 100, 20);
+    VectorList *circle = shape_circle(10, 40);
+    polygon_translate(circle, (Vector) {0, 9});
+    CollisionInfo info = find_collision(floor, circle);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (Vector) {0, 1}));
+    assert(isclose(info.depth, 1));
+    vec_list_free(floor);
+    vec_list_free(circle);
+}
+
+// Copies a shape without its kind, so find_collision() uses the general SAT path
+VectorList *as_polygon(VectorList *shape) {
+    VectorList *polygon = vec_list_copy(shape);
+    polygon->kind = SHAPE_POLYGON;
+    return polygon;
+}
+
+VectorList *random_shape(ShapeKind kind) {
+    VectorList *shape = kind == SHAPE_CIRCLE
+        ? shape_circle(5 + rand() % 20, 200)
+        : shape_rectangle(5 + rand() % 40, 5 + rand() % 40);
+    polygon_translate(shape, (Vector) {rand() % 60 - 30, rand() % 60 - 30});
+    assert(shape->kind == kind);
+    return shape;
+}
+
+// Tests that each fast path agrees with SAT on the shapes' polygons
+void test_fast_paths_match_sat() {
+    ShapeKind kinds[][2] = {
+        {SHAPE_CIRCLE, SHAPE_CIRCLE},
+        {SHAPE_AABB, SHAPE_AABB},
+        {SHAPE_AABB, SHAPE_CIRCLE},
+        {SHAPE_CIRCLE, SHAPE_AABB}
+    };
+    srand(3);
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(*kinds); k++) {
+        size_t collisions = 0;
+        for (int i = 0; i < 500; i++) {
+            VectorList *shape1 = random_shape(kinds[k][0]);
+            VectorList *shape2 = random_shape(kinds[k][1]);
+            VectorList *polygon1 = as_polygon(shape1);
+            VectorList *polygon2 = as_polygon(shape2);
+            CollisionInfo fast = find_collision(shape1, shape2);
+            CollisionInfo sat = find_collision(polygon1, polygon2);
+            // A 200-gon is within 0.05% of its circle, so only grazing contacts may differ
+            if (fast.collided != sat.collided) {
+                assert(fast.collided ? fast.depth < 0.05 : sat.depth < 0.05);
+            }
+            // When one shape's projection contains the other's, SAT's depth is not the
+            // distance to separate them, so only compare shallower contacts
+            else if (fast.collided && fast.depth > 1 && fast.depth < 5) {
+                collisions++;
+                assert(vec_magnitude(vec_subtract(fast.axis, sat.axis)) < 0.05);
+                assert(fabs(fast.depth - sat.depth) < 0.05);
+            }
+            vec_list_free(shape1);
+            vec_list_free(shape2);
+            vec_list_free(polygon1);
+            vec_list_free(polygon2);
+        }
+        assert(collisions > 20);
+    }
+}
+
+// Tests that rotating a box or editing its vertices drops the fast path
+void test_kind_changes() {
+    VectorList *box = shape_rectangle(2, 2);
+    assert(box->kind == SHAPE_AABB);
+    polygon_translate(box, (Vector) {5, 5});
+    assert(box->kind == SHAPE_AABB);
+    polygon_rotate(box, M_PI / 4, (Vector) {5, 5});
+    assert(box->kind == SHAPE_POLYGON);
+    vec_list_free(box);
+
+    VectorList *circle = shape_circle(1, 10);
+    assert(circle->kind == SHAPE_CIRCLE);
+    polygon_rotate(circle, 1, VEC_ZERO);
+    assert(circle->kind == SHAPE_CIRCLE);
+    vec_list_set(circle, 0, (Vector) {2, 2});
+    assert(circle->kind == SHAPE_POLYGON);
+    vec_list_free(circle);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_square_depth)
+    DO_TEST(test_separated)
+    DO_TEST(test_circle_rectangle)
+    DO_TEST(test_fast_paths_match_sat)
+    DO_TEST(test_kind_changes)
+
+    puts("collision_test PASS");
+    return 0;
 }
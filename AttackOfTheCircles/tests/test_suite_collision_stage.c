@@ -0,0 +1,221 @@
+#include "collision_stage.h"
+#include "collision.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+VectorList *make_square(double half_width) {
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {-half_width, -half_width});
+    vec_list_add(shape, (Vector) {+half_width, -half_width});
+    vec_list_add(shape, (Vector) {+half_width, +half_width});
+    vec_list_add(shape, (Vector) {-half_width, +half_width});
+    return shape;
+}
+
+Body *make_typed_body(Scene *scene, int type, Vector centroid) {
+    int *info = malloc(sizeof(*info));
+    *info = type;
+    Body *body = body_init_with_info(make_square(1), 1, (RGBColor) {0, 0, 0}, info, free);
+    body_set_centroid(body, centroid);
+    scene_add_body(scene, body);
+    return body;
+}
+
+int info_type(Body *body) {
+    return *(int *) body_get_info(body);
+}
+
+typedef struct {
+    int calls;
+    Body *last_body1;
+    Body *last_body2;
+    Vector last_axis;
+    CollisionEventType last_type;
+} Record;
+
+void record_collision(Body *body1, Body *body2, Vector axis, void *aux,
+                      CollisionEventType type) {
+    Record *record = aux;
+    record->calls++;
+    record->last_body1 = body1;
+    record->last_body2 = body2;
+    record->last_axis = axis;
+    record->last_type = type;
+}
+
+// Tests that a handler sees START, TOUCHING and END in order,
+// with its bodies in the order of the types it was registered with
+void test_stage_events() {
+    Scene *scene = scene_init();
+    Record *record = calloc(1, sizeof(*record));
+    CollisionStage *stage = collision_stage_init(2, info_type);
+    collision_stage_add_handler(stage, 1, 0, record_collision, record, free);
+    scene_set_collision_stage(scene, stage);
+
+    Body *body0 = make_typed_body(scene, 0, (Vector) {0, 0});
+    Body *body1 = make_typed_body(scene, 1, (Vector) {5, 0});
+    scene_tick(scene, 1);
+    assert(record->calls == 0);
+
+    body_set_centroid(body1, (Vector) {1.5, 0});
+    scene_tick(scene, 1);
+    assert(record->calls == 1);
+    assert(record->last_type == COLLISION_START);
+    assert(record->last_body1 == body1);
+    assert(record->last_body2 == body0);
+    assert(vec_isclose(record->last_axis, (Vector) {-1, 0}));
+
+    scene_tick(scene, 1);
+    assert(record->calls == 2);
+    assert(record->last_type == COLLISION_TOUCHING);
+
+    body_set_centroid(body1, (Vector) {50, 0});
+    scene_tick(scene, 1);
+    assert(record->calls == 3);
+    assert(record->last_type == COLLISION_END);
+
+    scene_tick(scene, 1);
+    assert(record->calls == 3);
+    scene_free(scene);
+}
+
+void count_collision(Body *body1, Body *body2, Vector axis, void *aux,
+                     CollisionEventType type) {
+    (*(int *) aux)++;
+}
+
+// Tests that the broad phase finds the same colliding pairs as checking every pair
+void test_stage_matches_all_pairs() {
+    const int BODIES = 200;
+    Scene *scene = scene_init();
+    int *count = calloc(1, sizeof(*count));
+    CollisionStage *stage = collision_stage_init(1, info_type);
+    collision_stage_add_handler(stage, 0, 0, count_collision, count, free);
+    scene_set_collision_stage(scene, stage);
+
+    srand(3);
+    for (int i = 0; i < BODIES; i++) {
+        Vector centroid = {rand() % 100 / 2.0, rand() % 100 / 2.0};
+        make_typed_body(scene, 0, centroid);
+    }
+    int expected = 0;
+    for (int i = 0; i < BODIES; i++) {
+        for (int j = i + 1; j < BODIES; j++) {
+            const VectorList *shape1 = body_get_shape_view(scene_get_body(scene, i));
+            const VectorList *shape2 = body_get_shape_view(scene_get_body(scene, j));
+            if (find_collision(shape1, shape2).collided) {
+                expected++;
+            }
+        }
+    }
+    assert(expected > 0);
+    scene_tick(scene, 0);
+    assert(*count == expected);
+    scene_free(scene);
+}
+
+// Tests that removed bodies stop colliding
+void test_stage_skips_removed() {
+    Scene *scene = scene_init();
+    Record *record = calloc(1, sizeof(*record));
+    CollisionStage *stage = collision_stage_init(2, info_type);
+    collision_stage_add_handler(stage, 0, 1, record_collision, record, free);
+    scene_set_collision_stage(scene, stage);
+
+    make_typed_body(scene, 0, (Vector) {0, 0});
+    Body *body1 = make_typed_body(scene, 1, (Vector) {1, 1});
+    scene_tick(scene, 1);
+    assert(record->calls == 1);
+    body_remove(body1);
+    scene_tick(scene, 1);
+    scene_tick(scene, 1);
+    assert(record->calls == 1);
+    assert(scene_bodies(scene) == 1);
+    scene_free(scene);
+}
+
+void count_touching(Body *body1, Body *body2, Vector axis, void *aux,
+                    CollisionEventType type) {
+    if (type == COLLISION_TOUCHING) {
+        (*(int *) aux)++;
+    }
+}
+
+// Tests that removing many touching bodies at once keeps the other contacts
+void test_stage_removes_many_contacts() {
+    const int BODIES = 40;
+    Scene *scene = scene_init();
+    int *count = calloc(1, sizeof(*count));
+    CollisionStage *stage = collision_stage_init(1, info_type);
+    collision_stage_add_handler(stage, 0, 0, count_touching, count, free);
+    scene_set_collision_stage(scene, stage);
+
+    // Every body overlaps every other one
+    for (int i = 0; i < BODIES; i++) {
+        make_typed_body(scene, 0, (Vector) {i * 0.01, 0});
+    }
+    scene_tick(scene, 0);
+    scene_tick(scene, 0);
+    assert(*count == BODIES * (BODIES - 1) / 2);
+
+    for (int i = 0; i < BODIES; i += 3) {
+        body_remove(scene_get_body(scene, i));
+    }
+    scene_tick(scene, 0);
+    *count = 0;
+    scene_tick(scene, 0);
+    int left = BODIES - (BODIES + 2) / 3;
+    assert(scene_bodies(scene) == (size_t) left);
+    assert(*count == left * (left - 1) / 2);
+    scene_free(scene);
+}
+
+// Tests that bodies with types the stage doesn't know never collide, and that
+// a pair's END goes to the handler it touched under after a type changes
+void test_stage_type_range() {
+    Scene *scene = scene_init();
+    Record *record = calloc(1, sizeof(*record));
+    CollisionStage *stage = collision_stage_init(2, info_type);
+    collision_stage_add_handler(stage, 0, 1, record_collision, record, free);
+    scene_set_collision_stage(scene, stage);
+
+    Body *body0 = make_typed_body(scene, 0, (Vector) {0, 0});
+    make_typed_body(scene, 2, (Vector) {0.5, 0});
+    make_typed_body(scene, 100, (Vector) {-0.5, 0});
+    scene_tick(scene, 1);
+    assert(record->calls == 0);
+
+    Body *body1 = make_typed_body(scene, 1, (Vector) {1, 1});
+    scene_tick(scene, 1);
+    assert(record->calls == 1);
+    assert(record->last_type == COLLISION_START);
+    *(int *) body_get_info(body1) = 7;
+    body_set_centroid(body1, (Vector) {50, 0});
+    scene_tick(scene, 1);
+    assert(record->calls == 2);
+    assert(record->last_type == COLLISION_END);
+    assert(record->last_body1 == body0);
+    assert(record->last_body2 == body1);
+    scene_free(scene);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_stage_events)
+    DO_TEST(test_stage_matches_all_pairs)
+    DO_TEST(test_stage_skips_removed)
+    DO_TEST(test_stage_removes_many_contacts)
+    DO_TEST(test_stage_type_range)
+
+    puts("collision_stage_test PASS");
+    return 0;
+}
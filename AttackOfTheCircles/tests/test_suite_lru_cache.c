@@ -0,0 +1,163 @@
+#include "lru_cache.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Counts the values freed by the cache
+int freed = 0;
+
+void count_free(void *value) {
+    freed++;
+    free(value);
+}
+
+int *make_int(int value) {
+    int *p = malloc(sizeof(int));
+    assert(p);
+    *p = value;
+    return p;
+}
+
+void test_empty() {
+    LruCache *cache = lru_cache_init(3, free);
+    assert(lru_cache_size(cache) == 0);
+    assert(lru_cache_get(cache, "a") == NULL);
+    assert(!lru_cache_contains(cache, ""));
+    lru_cache_free(cache);
+}
+
+void test_put_get() {
+    LruCache *cache = lru_cache_init(4, free);
+    lru_cache_put(cache, "one", make_int(1));
+    lru_cache_put(cache, "two", make_int(2));
+    lru_cache_put(cache, "", make_int(0));
+    assert(lru_cache_size(cache) == 3);
+    assert(*(int *) lru_cache_get(cache, "one") == 1);
+    assert(*(int *) lru_cache_get(cache, "two") == 2);
+    assert(*(int *) lru_cache_get(cache, "") == 0);
+    assert(lru_cache_get(cache, "three") == NULL);
+    assert(lru_cache_get(cache, "on") == NULL);
+    lru_cache_free(cache);
+}
+
+// Tests that the cache copies keys rather than keeping the caller's buffer
+void test_key_copied() {
+    LruCache *cache = lru_cache_init(2, free);
+    char key[] = "abc";
+    lru_cache_put(cache, key, make_int(1));
+    key[0] = 'x';
+    assert(lru_cache_get(cache, "xbc") == NULL);
+    assert(*(int *) lru_cache_get(cache, "abc") == 1);
+    lru_cache_free(cache);
+}
+
+// Tests that the least recently used value is evicted and freed
+void test_eviction() {
+    freed = 0;
+    LruCache *cache = lru_cache_init(3, count_free);
+    lru_cache_put(cache, "a", make_int(1));
+    lru_cache_put(cache, "b", make_int(2));
+    lru_cache_put(cache, "c", make_int(3));
+    // Using "a" makes "b" the least recently used
+    assert(lru_cache_get(cache, "a") != NULL);
+    lru_cache_put(cache, "d", make_int(4));
+    assert(freed == 1);
+    assert(lru_cache_size(cache) == 3);
+    assert(!lru_cache_contains(cache, "b"));
+    assert(lru_cache_contains(cache, "a"));
+    assert(lru_cache_contains(cache, "c"));
+    assert(lru_cache_contains(cache, "d"));
+    // Checking for a key doesn't count as using it, so "c" goes next
+    lru_cache_put(cache, "e", make_int(5));
+    assert(freed == 2);
+    assert(!lru_cache_contains(cache, "c"));
+    assert(*(int *) lru_cache_get(cache, "a") == 1);
+    assert(*(int *) lru_cache_get(cache, "d") == 4);
+    assert(*(int *) lru_cache_get(cache, "e") == 5);
+    lru_cache_free(cache);
+    assert(freed == 5);
+}
+
+// Tests that putting an existing key replaces its value without evicting
+void test_replace() {
+    freed = 0;
+    LruCache *cache = lru_cache_init(2, count_free);
+    lru_cache_put(cache, "a", make_int(1));
+    lru_cache_put(cache, "b", make_int(2));
+    lru_cache_put(cache, "a", make_int(10));
+    assert(freed == 1);
+    assert(lru_cache_size(cache) == 2);
+    assert(*(int *) lru_cache_get(cache, "a") == 10);
+    // Replacing made "a" the most recently used, so "b" is evicted
+    lru_cache_put(cache, "c", make_int(3));
+    assert(!lru_cache_contains(cache, "b"));
+    assert(lru_cache_contains(cache, "a"));
+    // Putting the same value again doesn't free it
+    int *same = lru_cache_get(cache, "c");
+    lru_cache_put(cache, "c", same);
+    assert(freed == 2);
+    assert(lru_cache_get(cache, "c") == same);
+    lru_cache_free(cache);
+    assert(freed == 4);
+}
+
+void test_clear() {
+    freed = 0;
+    LruCache *cache = lru_cache_init(4, count_free);
+    lru_cache_put(cache, "a", make_int(1));
+    lru_cache_put(cache, "b", make_int(2));
+    lru_cache_clear(cache);
+    assert(freed == 2);
+    assert(lru_cache_size(cache) == 0);
+    assert(lru_cache_get(cache, "a") == NULL);
+    lru_cache_put(cache, "b", make_int(3));
+    assert(*(int *) lru_cache_get(cache, "b") == 3);
+    lru_cache_free(cache);
+    assert(freed == 3);
+}
+
+// Tests many keys through a small cache against the order they were used in
+void test_many_keys() {
+    const int KEYS = 1000;
+    const int CAPACITY = 37;
+    LruCache *cache = lru_cache_init(CAPACITY, free);
+    char key[16];
+    for (int i = 0; i < KEYS; i++) {
+        sprintf(key, "key%d", i);
+        lru_cache_put(cache, key, make_int(i));
+        // Keep using key0, so it is never the least recently used
+        assert(*(int *) lru_cache_get(cache, "key0") == 0);
+    }
+    assert(lru_cache_size(cache) == (size_t) CAPACITY);
+    for (int i = 1; i < KEYS; i++) {
+        sprintf(key, "key%d", i);
+        bool kept = i >= KEYS - (CAPACITY - 1);
+        assert(lru_cache_contains(cache, key) == kept);
+        if (kept) {
+            assert(*(int *) lru_cache_get(cache, key) == i);
+        }
+    }
+    lru_cache_free(cache);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_empty)
+    DO_TEST(test_put_get)
+    DO_TEST(test_key_copied)
+    DO_TEST(test_eviction)
+    DO_TEST(test_replace)
+    DO_TEST(test_clear)
+    DO_TEST(test_many_keys)
+
+    puts("lru_cache_test PASS");
+    return 0;
+}
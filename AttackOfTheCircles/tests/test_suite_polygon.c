@@ -193,6 +193,35 @@ void test_weird_rotate() {
     vec_list_free(w);
 }
 
+void test_is_convex() {
+    VectorList *sq = make_square();
+    assert(polygon_is_convex(sq));
+    // Clockwise polygons are convex too
+    VectorList *reversed = vec_list_init(4);
+    for (size_t i = 4; i > 0; i--) {
+        vec_list_add(reversed, vec_list_get(sq, i - 1));
+    }
+    assert(polygon_is_convex(reversed));
+    // A vertex in the middle of an edge doesn't turn
+    vec_list_add(sq, (Vector){1, 0});
+    assert(polygon_is_convex(sq));
+    // Pushing it inwards makes a dent
+    vec_list_set(sq, 4, (Vector){0.5, 0});
+    assert(!polygon_is_convex(sq));
+    vec_list_free(sq);
+    vec_list_free(reversed);
+
+    VectorList *t = make_triangle();
+    assert(polygon_is_convex(t));
+    vec_list_free(t);
+    VectorList *c = make_big_circ();
+    assert(polygon_is_convex(c));
+    vec_list_free(c);
+    VectorList *w = make_weird();
+    assert(!polygon_is_convex(w));
+    vec_list_free(w);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests? True if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -214,6 +243,7 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_weird_area_centroid)
     DO_TEST(test_weird_translate)
     DO_TEST(test_weird_rotate)
+    DO_TEST(test_is_convex)
 
     puts("polygon_test PASS");
 
@@ -0,0 +1,182 @@
+#include "pool.h"
+#include "body.h"
+#include "shape.h"
+#include "test_util.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    double x;
+    char tag;
+} Small;
+
+// Tests that released objects are handed out again
+void test_pool_reuse() {
+    Pool *pool = pool_init(sizeof(Small));
+    Small *first = pool_alloc(pool);
+    Small *second = pool_alloc(pool);
+    assert(first != second);
+    assert(pool_live(pool) == 2);
+    pool_release(pool, first);
+    assert(pool_live(pool) == 1);
+    assert(pool_alloc(pool) == first);
+    pool_release(pool, first);
+    pool_release(pool, second);
+    pool_release(pool, NULL);
+    assert(pool_live(pool) == 0);
+    pool_free(pool);
+}
+
+// Tests many live objects at once, spanning several chunks
+void test_pool_many() {
+    const size_t COUNT = 10000;
+    Pool *pool = pool_init(sizeof(Small));
+    Small **objects = malloc(sizeof(Small *) * COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        objects[i] = pool_alloc(pool);
+        assert((uintptr_t) objects[i] % alignof(max_align_t) == 0);
+        objects[i]->x = i;
+        objects[i]->tag = (char) i;
+    }
+    assert(pool_live(pool) == COUNT);
+    // No two objects overlap
+    for (size_t i = 0; i < COUNT; i++) {
+        assert(objects[i]->x == i);
+        assert(objects[i]->tag == (char) i);
+    }
+    for (size_t i = 0; i < COUNT; i += 2) {
+        pool_release(pool, objects[i]);
+    }
+    assert(pool_live(pool) == COUNT / 2);
+    // Freeing the pool frees the objects that are still live
+    free(objects);
+    pool_free(pool);
+}
+
+// Tests objects smaller than the free list's pointer
+void test_pool_tiny() {
+    Pool *pool = pool_init(1);
+    char *a = pool_alloc(pool);
+    char *b = pool_alloc(pool);
+    *a = 'a';
+    *b = 'b';
+    assert(*a == 'a' && *b == 'b');
+    pool_release(pool, a);
+    pool_release(pool, b);
+    pool_free(pool);
+}
+
+// Tests a global pool
+Pool GLOBAL_POOL = POOL_INIT(3 * sizeof(double));
+
+void test_global_pool() {
+    double *values = pool_alloc(&GLOBAL_POOL);
+    memset(values, 0, 3 * sizeof(double));
+    assert(pool_live(&GLOBAL_POOL) == 1);
+    pool_release(&GLOBAL_POOL, values);
+    assert(pool_live(&GLOBAL_POOL) == 0);
+}
+
+// Tests that freeing a body and creating another reuses its memory
+void test_body_reuse() {
+    Body *body = body_init(shape_rectangle(1, 1), 1, (RGBColor) {0, 0, 0});
+    body_free(body);
+    Body *next = body_init(shape_rectangle(2, 2), 1, (RGBColor) {0, 0, 0});
+    assert(next == body);
+    body_free(next);
+}
+
+typedef struct {
+    Pool *pool;
+    // Objects this thread allocates and the next thread releases
+    Small **handoff;
+    // The objects of thread from, which this thread releases
+    Small **taken;
+    size_t count;
+    int id;
+    int from;
+} PoolThread;
+
+void *pool_thread(void *aux) {
+    PoolThread *thread = aux;
+    for (size_t i = 0; i < thread->count; i++) {
+        Small *object = pool_alloc(thread->pool);
+        object->x = i;
+        object->tag = (char) thread->id;
+        thread->handoff[i] = object;
+        // Churn some objects of its own too
+        pool_release(thread->pool, pool_alloc(thread->pool));
+    }
+    return NULL;
+}
+
+void *release_thread(void *aux) {
+    PoolThread *thread = aux;
+    for (size_t i = 0; i < thread->count; i++) {
+        Small *object = thread->taken[i];
+        assert(object->x == i);
+        assert(object->tag == (char) thread->from);
+        pool_release(thread->pool, object);
+    }
+    return NULL;
+}
+
+// Tests threads that release the objects other threads allocated,
+// which leaves their shards' free objects to be taken by the allocators
+void test_pool_threads() {
+    const int THREADS = 4;
+    const size_t COUNT = 5000;
+    const int ROUNDS = 3;
+    Pool *pool = pool_init(sizeof(Small));
+    PoolThread threads[THREADS];
+    Small **objects = malloc(sizeof(Small *) * COUNT * THREADS);
+    for (int i = 0; i < THREADS; i++) {
+        int from = (i + THREADS - 1) % THREADS;
+        threads[i] = (PoolThread) {pool, objects + i * COUNT, objects + from * COUNT,
+            COUNT, i, from};
+    }
+    for (int round = 0; round < ROUNDS; round++) {
+        pthread_t ids[THREADS];
+        for (int i = 0; i < THREADS; i++) {
+            pthread_create(&ids[i], NULL, pool_thread, &threads[i]);
+        }
+        for (int i = 0; i < THREADS; i++) {
+            pthread_join(ids[i], NULL);
+        }
+        assert(pool_live(pool) == COUNT * THREADS);
+        // Each thread releases the objects of the one before it
+        for (int i = 0; i < THREADS; i++) {
+            pthread_create(&ids[i], NULL, release_thread, &threads[i]);
+        }
+        for (int i = 0; i < THREADS; i++) {
+            pthread_join(ids[i], NULL);
+        }
+        assert(pool_live(pool) == 0);
+    }
+    free(objects);
+    pool_free(pool);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_pool_reuse)
+    DO_TEST(test_pool_many)
+    DO_TEST(test_pool_tiny)
+    DO_TEST(test_global_pool)
+    DO_TEST(test_body_reuse)
+    DO_TEST(test_pool_threads)
+
+    puts("pool_test PASS");
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "forces.h"
+#include "quadtree.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+VectorList *make_square(double half_width) {
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {-half_width, -half_width});
+    vec_list_add(shape, (Vector) {+half_width, -half_width});
+    vec_list_add(shape, (Vector) {+half_width, +half_width});
+    vec_list_add(shape, (Vector) {-half_width, +half_width});
+    return shape;
+}
+
+// Fills a scene with the same random bodies for a given seed
+void add_random_bodies(Scene *scene, int count, unsigned seed) {
+    srand(seed);
+    for (int i = 0; i < count; i++) {
+        double mass = 1 + rand() % 100;
+        Body *body = body_init(make_square(1 + rand() % 5), mass, (RGBColor) {0, 0, 0});
+        body_set_centroid(body, (Vector) {rand() % 4000, rand() % 2000});
+        scene_add_body(scene, body);
+    }
+}
+
+// Tests that the exact path matches one create_newtonian_gravity() per pair,
+// including pairs whose bounding circles overlap
+void test_exact_matches_pairwise() {
+    const int BODIES = 80;
+    const double G = 50;
+    Scene *pairwise = scene_init();
+    Scene *tree = scene_init();
+    add_random_bodies(pairwise, BODIES, 11);
+    add_random_bodies(tree, BODIES, 11);
+    body_set_centroid(scene_get_body(pairwise, 1), body_get_centroid(scene_get_body(pairwise, 0)));
+    body_set_centroid(scene_get_body(tree, 1), body_get_centroid(scene_get_body(tree, 0)));
+    for (int i = 0; i < BODIES; i++) {
+        for (int j = i + 1; j < BODIES; j++) {
+            create_newtonian_gravity(pairwise, G,
+                scene_get_body(pairwise, i), scene_get_body(pairwise, j));
+        }
+    }
+    create_scene_gravity(tree, G, 0);
+    // The bodies start at rest, so after a tick of 1s each velocity is force / mass
+    scene_tick(pairwise, 1);
+    scene_tick(tree, 1);
+    for (int i = 0; i < BODIES; i++) {
+        Vector expected = body_get_velocity(scene_get_body(pairwise, i));
+        Vector actual = body_get_velocity(scene_get_body(tree, i));
+        assert(vec_magnitude(vec_subtract(expected, actual))
+            <= 1e-9 * (1 + vec_magnitude(expected)));
+    }
+    scene_free(pairwise);
+    scene_free(tree);
+}
+
+// Tests the documented accuracy of theta = 0.5: RMS error within 1% of the RMS force
+void test_barnes_hut_tolerance() {
+    const int BODIES = 2000;
+    const double G = 50;
+    Scene *exact = scene_init();
+    Scene *approx = scene_init();
+    add_random_bodies(exact, BODIES, 5);
+    add_random_bodies(approx, BODIES, 5);
+    create_scene_gravity(exact, G, 0);
+    create_scene_gravity(approx, G, 0.5);
+    scene_tick(exact, 1);
+    scene_tick(approx, 1);
+
+    double error_squared = 0, force_squared = 0;
+    for (int i = 0; i < BODIES; i++) {
+        Body *exact_body = scene_get_body(exact, i);
+        double mass = body_get_mass(exact_body);
+        Vector expected = vec_multiply(mass, body_get_velocity(exact_body));
+        Vector actual = vec_multiply(mass, body_get_velocity(scene_get_body(approx, i)));
+        error_squared += vec_distance_squared(expected, actual);
+        force_squared += vec_magnitude_squared(expected);
+    }
+    assert(force_squared > 0);
+    assert(sqrt(error_squared / force_squared) < 0.01);
+    scene_free(exact);
+    scene_free(approx);
+}
+
+// Tests that splitting the tree walks between threads gives exactly the
+// forces one thread does
+void test_parallel_matches_serial() {
+    const int BODIES = 1500;
+    const double G = 50;
+    Scene *serial = scene_init();
+    Scene *parallel = scene_init();
+    scene_set_threads(parallel, 4);
+    add_random_bodies(serial, BODIES, 9);
+    add_random_bodies(parallel, BODIES, 9);
+    create_scene_gravity(serial, G, 0.5);
+    create_scene_gravity(parallel, G, 0.5);
+    for (int tick = 0; tick < 5; tick++) {
+        scene_tick(serial, 0.1);
+        scene_tick(parallel, 0.1);
+    }
+    for (int i = 0; i < BODIES; i++) {
+        Body *expected = scene_get_body(serial, i);
+        Body *actual = scene_get_body(parallel, i);
+        assert(vec_equal(body_get_centroid(actual), body_get_centroid(expected)));
+        assert(vec_equal(body_get_velocity(actual), body_get_velocity(expected)));
+    }
+    scene_free(serial);
+    scene_free(parallel);
+}
+
+// Tests that bodies stacked on the same point do not break the tree,
+// and that removed bodies stop attracting
+void test_degenerate_bodies() {
+    Quadtree *tree = quadtree_init();
+    List *bodies = list_init(0, (FreeFunc) body_free);
+    for (int i = 0; i < 100; i++) {
+        Body *body = body_init(make_square(1), 1, (RGBColor) {0, 0, 0});
+        body_set_centroid(body, (Vector) {5, 5});
+        list_add(bodies, body);
+    }
+    Body *far = body_init(make_square(1), 1, (RGBColor) {0, 0, 0});
+    body_set_centroid(far, (Vector) {1005, 5});
+    list_add(bodies, far);
+    quadtree_build(tree, bodies);
+    quadtree_add_gravity(tree, 1, 0.5);
+    body_tick(far, 1);
+    // 100 unit masses at distance 1000 pull with 100 / 1000^2
+    assert(isclose(body_get_velocity(far).x, -1e-4));
+
+    for (int i = 0; i < 100; i++) {
+        body_remove(list_get(bodies, i));
+    }
+    body_set_velocity(far, VEC_ZERO);
+    quadtree_build(tree, bodies);
+    quadtree_add_gravity(tree, 1, 0.5);
+    body_tick(far, 1);
+    assert(vec_equal(body_get_velocity(far), VEC_ZERO));
+    quadtree_free(tree);
+    list_free(bodies);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_exact_matches_pairwise)
+    DO_TEST(test_barnes_hut_tolerance)
+    DO_TEST(test_parallel_matches_serial)
+    DO_TEST(test_degenerate_bodies)
+
+    puts("quadtree_test PASS");
+    return 0;
+}
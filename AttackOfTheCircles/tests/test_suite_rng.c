@@ -0,0 +1,81 @@
+#include "rng.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+
+// Tests against the first outputs of the reference SplitMix64 seeded with 0
+void test_known_values() {
+    Rng rng;
+    rng_seed(&rng, 0);
+    assert(rng_next(&rng) == 0xE220A8397B1DCDAF);
+    assert(rng_next(&rng) == 0x6E789E6AA1B965F4);
+    assert(rng_next(&rng) == 0x06C45D188009454F);
+}
+
+// Tests that the same seed repeats the sequence, whatever else is drawn
+void test_repeatable() {
+    Rng rng1, rng2, other;
+    rng_seed(&rng1, 42);
+    rng_seed(&rng2, 42);
+    rng_seed(&other, 43);
+    for (int i = 0; i < 1000; i++) {
+        rng_next(&other);
+        assert(rng_next(&rng1) == rng_next(&rng2));
+    }
+    rng_seed(&rng1, 42);
+    rng_seed(&other, 42);
+    assert(rng_next(&rng1) == rng_next(&other));
+    rng_seed(&rng1, 1);
+    rng_seed(&rng2, 2);
+    assert(rng_next(&rng1) != rng_next(&rng2));
+}
+
+void test_double_range() {
+    Rng rng;
+    rng_seed(&rng, 7);
+    double sum = 0;
+    const int DRAWS = 100000;
+    for (int i = 0; i < DRAWS; i++) {
+        double value = rng_double(&rng);
+        assert(0 <= value && value < 1);
+        sum += value;
+    }
+    assert(within(0.01, sum / DRAWS, 0.5));
+}
+
+// Tests that rng_below() stays in range and hits every value about equally
+void test_below() {
+    const int BOUND = 6;
+    const int DRAWS = 60000;
+    int counts[6] = {0};
+    Rng rng;
+    rng_seed(&rng, 9);
+    for (int i = 0; i < DRAWS; i++) {
+        uint64_t value = rng_below(&rng, BOUND);
+        assert(value < BOUND);
+        counts[value]++;
+    }
+    for (int i = 0; i < BOUND; i++) {
+        assert(abs(counts[i] - DRAWS / BOUND) < DRAWS / BOUND / 10);
+    }
+    assert(rng_below(&rng, 1) == 0);
+    assert(rng_below(&rng, UINT64_MAX) < UINT64_MAX);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_known_values)
+    DO_TEST(test_repeatable)
+    DO_TEST(test_double_range)
+    DO_TEST(test_below)
+
+    puts("rng_test PASS");
+    return 0;
+}
@@ -21,20 +21,12 @@ void test_empty_scene() {
     scene_free(scene);
 }
 
-List *make_shape() {
-    List *shape = list_init(4, free);
-    Vector *v = malloc(sizeof(*v));
-    *v = (Vector) {-1, -1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {+1, -1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {+1, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(*v));
-    *v = (Vector) {-1, +1};
-    list_add(shape, v);
+VectorList *make_shape() {
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {-1, -1});
+    vec_list_add(shape, (Vector) {+1, -1});
+    vec_list_add(shape, (Vector) {+1, +1});
+    vec_list_add(shape, (Vector) {-1, +1});
     return shape;
 }
 
@@ -232,6 +224,398 @@ void test_reaping() {
     scene_free(scene);
 }
 
+void remove_aux_body(void *aux) {
+    body_remove((Body *) aux);
+}
+
+void count_call(void *aux) {
+    (*(int *) aux)++;
+}
+
+// Tests that a force creator still runs in the tick an earlier one removes its
+// body, and is dropped with the body once the tick ends
+void test_removed_mid_tick() {
+    Scene *scene = scene_init();
+    Body *body = body_init(make_shape(), 1, (RGBColor) {0, 0, 0});
+    scene_add_body(scene, body);
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    List *bodies = list_init(1, NULL);
+    list_add(bodies, body);
+    scene_add_bodies_force_creator(scene, count_call, count, bodies, NULL);
+    // Force creators run newest first
+    scene_add_force_creator(scene, remove_aux_body, body, NULL);
+    scene_tick(scene, 1);
+    assert(*count == 1);
+    assert(scene_bodies(scene) == 0);
+    assert(scene_force_handlers(scene) == 1);
+    free(count);
+    scene_free(scene);
+}
+
+// Tests that removing many bodies at once keeps the rest in order
+// and drops exactly the force creators that used the removed bodies
+void test_bulk_removal() {
+    const int BODIES = 1000;
+    Scene *scene = scene_init();
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    for (int i = 0; i < BODIES; i++) {
+        Body *body = body_init(make_shape(), i + 1, (RGBColor) {0, 0, 0});
+        scene_add_body(scene, body);
+        List *bodies = list_init(1, NULL);
+        list_add(bodies, body);
+        scene_add_bodies_force_creator(scene, count_call, count, bodies, NULL);
+    }
+    for (int i = 0; i < BODIES; i += 3) {
+        body_remove(scene_get_body(scene, i));
+    }
+    scene_tick(scene, 1);
+    assert(*count == BODIES - (BODIES + 2) / 3);
+    assert(scene_bodies(scene) == BODIES - (BODIES + 2) / 3);
+    assert(scene_force_handlers(scene) == scene_bodies(scene));
+    double last_mass = 0;
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        double mass = body_get_mass(scene_get_body(scene, i));
+        assert(mass > last_mass);
+        assert(((int) mass - 1) % 3 != 0);
+        last_mass = mass;
+    }
+    free(count);
+    scene_free(scene);
+}
+
+// Tests that handles stop finding a body once it is removed,
+// even after its slot is reused
+void test_handles() {
+    Scene *scene = scene_init();
+    Body *body1 = body_init(make_shape(), 1, (RGBColor) {0, 0, 0});
+    Body *body2 = body_init(make_shape(), 2, (RGBColor) {0, 0, 0});
+    scene_add_body(scene, body1);
+    scene_add_body(scene, body2);
+    BodyHandle handle1 = scene_get_handle(scene, body1);
+    BodyHandle handle2 = scene_get_handle(scene, body2);
+    assert(scene_get_handle_body(scene, handle1) == body1);
+    assert(scene_get_handle_body(scene, handle2) == body2);
+
+    body_remove(body1);
+    assert(scene_get_handle_body(scene, handle1) == NULL);
+    scene_tick(scene, 1);
+    Body *body3 = body_init(make_shape(), 3, (RGBColor) {0, 0, 0});
+    scene_add_body(scene, body3);
+    BodyHandle handle3 = scene_get_handle(scene, body3);
+    assert(handle3.slot == handle1.slot);
+    assert(scene_get_handle_body(scene, handle1) == NULL);
+    assert(scene_get_handle_body(scene, handle2) == body2);
+    assert(scene_get_handle_body(scene, handle3) == body3);
+    scene_free(scene);
+}
+
+List *body_pair(Body *body1, Body *body2) {
+    List *bodies = list_init(2, NULL);
+    list_add(bodies, body1);
+    list_add(bodies, body2);
+    return bodies;
+}
+
+// Tests the queries for the force creators that use each body
+void test_body_force_handlers() {
+    Scene *scene = scene_init();
+    Body *bodies[3];
+    for (int i = 0; i < 3; i++) {
+        bodies[i] = body_init(make_shape(), 1, (RGBColor) {0, 0, 0});
+        scene_add_body(scene, bodies[i]);
+    }
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    scene_add_bodies_force_creator(scene, count_call, count,
+        body_pair(bodies[0], bodies[1]), NULL);
+    scene_add_bodies_force_creator(scene, count_call, count,
+        body_pair(bodies[0], bodies[2]), NULL);
+    scene_add_bodies_force_creator(scene, count_call, count,
+        body_pair(bodies[1], bodies[2]), NULL);
+    for (int i = 0; i < 3; i++) {
+        assert(scene_body_force_handlers(scene, bodies[i]) == 2);
+    }
+    List *handlers = scene_get_body_force_handlers(scene, bodies[0]);
+    assert(list_size(handlers) == 2);
+    assert(list_get(get_fh_bodies(list_get(handlers, 0)), 1) == bodies[2]);
+    assert(list_get(get_fh_bodies(list_get(handlers, 1)), 1) == bodies[1]);
+    list_free(handlers);
+
+    // Removing a body drops its force creators from the other bodies too
+    body_remove(bodies[2]);
+    scene_tick(scene, 1);
+    assert(*count == 1);
+    assert(scene_force_handlers(scene) == 1);
+    assert(scene_body_force_handlers(scene, bodies[0]) == 1);
+    assert(scene_body_force_handlers(scene, bodies[1]) == 1);
+
+    // Removing a body's force creators keeps the body
+    scene_remove_body_force_handlers(scene, bodies[1]);
+    assert(scene_body_force_handlers(scene, bodies[0]) == 0);
+    scene_tick(scene, 1);
+    assert(*count == 1);
+    assert(scene_bodies(scene) == 2);
+    assert(scene_force_handlers(scene) == 0);
+    free(count);
+    scene_free(scene);
+}
+
+// Tests that scene_step() runs whole fixed ticks and carries the remainder
+void test_fixed_step() {
+    Scene *scene = scene_init();
+    scene_set_fixed_step(scene, 0.1, 4);
+    Body *body = body_init(make_shape(), 1, (RGBColor) {0, 0, 0});
+    body_set_velocity(body, (Vector) {1, 0});
+    scene_add_body(scene, body);
+    scene_set_camera_velocity(scene, (Vector) {10, 0});
+    VectorList *scratch = vec_list_init(0);
+
+    assert(scene_step(scene, 0.05) == 0);
+    assert(isclose(scene_get_interpolation_alpha(scene), 0.5));
+    assert(vec_isclose(body_get_centroid(body), VEC_ZERO));
+
+    assert(scene_step(scene, 0.1) == 1);
+    assert(isclose(scene_get_time(scene), 0.1));
+    assert(isclose(scene_get_interpolation_alpha(scene), 0.5));
+    assert(vec_isclose(body_get_centroid(body), (Vector) {0.1, 0}));
+    // Frames blend halfway from the previous tick
+    const VectorList *blended = body_get_interpolated_shape(body,
+        scene_get_interpolation_alpha(scene), scratch);
+    assert(vec_isclose(vec_list_get(blended, 0), (Vector) {-0.95, -1}));
+    assert(vec_isclose(scene_get_interpolated_camera(scene), (Vector) {0.5, 0}));
+    assert(vec_isclose(scene_get_camera(scene), (Vector) {1, 0}));
+
+    assert(scene_step(scene, 0.25) == 3);
+    assert(isclose(scene_get_time(scene), 0.4));
+
+    // A long stall runs at most 4 ticks, and the rest of the time is dropped
+    assert(scene_step(scene, 10) == 4);
+    assert(isclose(scene_get_time(scene), 0.8));
+    assert(scene_get_interpolation_alpha(scene) < 1);
+    assert(scene_step(scene, 0) == 0);
+
+    // Ticking directly shows the current state
+    scene_tick(scene, 0.1);
+    assert(scene_get_interpolation_alpha(scene) == 1);
+    assert(vec_isclose(scene_get_interpolated_camera(scene), scene_get_camera(scene)));
+    vec_list_free(scratch);
+    scene_free(scene);
+}
+
+typedef struct {
+    Body *body1;
+    Body *body2;
+    double k;
+} PairSpring;
+
+void add_pair_spring(PairSpring *spring) {
+    Vector stretch = vec_subtract(body_get_centroid(spring->body2), body_get_centroid(spring->body1));
+    Vector force = vec_multiply(spring->k, stretch);
+    body_add_force(spring->body1, force);
+    body_add_force(spring->body2, vec_negate(force));
+    body_add_impulse(spring->body1, vec_multiply(1e-3, body_get_velocity(spring->body2)));
+}
+
+void add_parallel_spring(Scene *scene, Body *body1, Body *body2, double k) {
+    PairSpring *spring = malloc(sizeof(*spring));
+    *spring = (PairSpring) {body1, body2, k};
+    List *bodies = list_init(2, NULL);
+    list_add(bodies, body1);
+    list_add(bodies, body2);
+    scene_add_parallel_force_creator(scene, (ForceCreator) add_pair_spring, spring, bodies, free);
+}
+
+typedef struct {
+    Body *body;
+    int ticks;
+} Remover;
+
+// A serial force creator that kicks a body and then removes it
+void kick_and_remove(Remover *remover) {
+    remover->ticks++;
+    body_add_impulse(remover->body, (Vector) {remover->ticks, 1});
+    if (remover->ticks == 3) {
+        body_remove(remover->body);
+    }
+}
+
+const size_t PARALLEL_BODIES = 1500;
+const size_t PARALLEL_ANCHORS = 5;
+const int PARALLEL_TICKS = 20;
+
+// A scene whose parallel springs share bodies, with two serial creators
+// splitting them into runs, and anchors outside the scene
+Scene *build_parallel_scene(size_t threads, bool deterministic, Integrator integrator,
+    List *anchors) {
+    srand(7);
+    Scene *scene = scene_init();
+    scene_set_threads(scene, threads);
+    scene_set_deterministic(scene, deterministic);
+    scene_set_integrator(scene, integrator);
+    for (size_t i = 0; i < PARALLEL_BODIES; i++) {
+        Body *body = body_init(make_shape(), 1 + rand() % 10, (RGBColor) {1, 1, 1});
+        body_set_centroid(body, (Vector) {rand() % 1000, rand() % 1000});
+        body_set_velocity(body, (Vector) {rand() % 10 - 5, rand() % 10 - 5});
+        scene_add_body(scene, body);
+    }
+    for (size_t i = 0; i < PARALLEL_ANCHORS; i++) {
+        Body *anchor = body_init(make_shape(), INFINITY, (RGBColor) {1, 1, 1});
+        body_set_centroid(anchor, (Vector) {200 * i, 500});
+        list_add(anchors, anchor);
+    }
+    for (size_t i = 0; i < PARALLEL_BODIES; i++) {
+        Body *body = scene_get_body(scene, i);
+        add_parallel_spring(scene, body, scene_get_body(scene, (i * 7 + 1) % PARALLEL_BODIES), 0.1);
+        if (i % 10 == 0) {
+            add_parallel_spring(scene, body, list_get(anchors, i % PARALLEL_ANCHORS), 0.01);
+        }
+        if (i == PARALLEL_BODIES / 3 || i == PARALLEL_BODIES / 2) {
+            Remover *remover = malloc(sizeof(*remover));
+            *remover = (Remover) {scene_get_body(scene, i), 0};
+            List *bodies = list_init(1, NULL);
+            list_add(bodies, remover->body);
+            scene_add_bodies_force_creator(scene, (ForceCreator) kick_and_remove, remover,
+                bodies, free);
+        }
+    }
+    return scene;
+}
+
+// Ticks a parallel scene and returns its bodies' centroids and velocities
+Vector *run_parallel_scene(size_t threads, bool deterministic, Integrator integrator) {
+    List *anchors = list_init(PARALLEL_ANCHORS, (FreeFunc) body_free);
+    Scene *scene = build_parallel_scene(threads, deterministic, integrator, anchors);
+    assert(scene_get_threads(scene) == threads);
+    for (int i = 0; i < PARALLEL_TICKS; i++) {
+        scene_tick(scene, 0.01);
+    }
+    assert(scene_bodies(scene) == PARALLEL_BODIES - 2);
+    Vector *state = malloc(sizeof(Vector) * 2 * scene_bodies(scene));
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        state[2 * i] = body_get_centroid(scene_get_body(scene, i));
+        state[2 * i + 1] = body_get_velocity(scene_get_body(scene, i));
+    }
+    scene_free(scene);
+    list_free(anchors);
+    return state;
+}
+
+// Tests that ticking on several threads matches one thread exactly when the
+// scene is deterministic, and closely otherwise
+void test_parallel_tick() {
+    size_t values = 2 * (PARALLEL_BODIES - 2);
+    Integrator integrators[] = {INTEGRATOR_MIDPOINT, INTEGRATOR_VELOCITY_VERLET};
+    for (size_t i = 0; i < sizeof(integrators) / sizeof(*integrators); i++) {
+        Vector *serial = run_parallel_scene(1, true, integrators[i]);
+        size_t thread_counts[] = {2, 5};
+        for (size_t j = 0; j < sizeof(thread_counts) / sizeof(*thread_counts); j++) {
+            Vector *parallel = run_parallel_scene(thread_counts[j], true, integrators[i]);
+            for (size_t k = 0; k < values; k++) {
+                assert(vec_equal(parallel[k], serial[k]));
+            }
+            free(parallel);
+            parallel = run_parallel_scene(thread_counts[j], false, integrators[i]);
+            for (size_t k = 0; k < values; k++) {
+                assert(vec_within(1e-6 * (1 + vec_magnitude(serial[k])), parallel[k], serial[k]));
+            }
+            free(parallel);
+        }
+        free(serial);
+    }
+}
+
+typedef struct {
+    int *visits;
+    size_t count;
+} Visits;
+
+void visit_range(Visits *visits, size_t start, size_t end) {
+    assert(start < end && end <= visits->count);
+    for (size_t i = start; i < end; i++) {
+        visits->visits[i]++;
+    }
+}
+
+// Tests that scene_parallel_for() visits every item exactly once
+void test_parallel_for() {
+    for (size_t threads = 1; threads <= 3; threads++) {
+        Scene *scene = scene_init();
+        scene_set_threads(scene, threads);
+        for (size_t count = 1; count <= 100; count++) {
+            Visits visits = {calloc(count, sizeof(int)), count};
+            scene_parallel_for(scene, count, (RangeTask) visit_range, &visits);
+            for (size_t i = 0; i < count; i++) {
+                assert(visits.visits[i] == 1);
+            }
+            free(visits.visits);
+        }
+        // Going back to one thread stops the workers
+        scene_set_threads(scene, 1);
+        assert(scene_get_threads(scene) == 1);
+        scene_free(scene);
+    }
+}
+
+typedef struct {
+    char key;
+    KeyEventType type;
+    int calls;
+} KeyLog;
+
+void log_key(char key, KeyEventType type, double held_time, KeyLog *log) {
+    log->key = key;
+    log->type = type;
+    log->calls++;
+}
+
+// Tests that key events reach only the scene's own handler
+void test_key_handler() {
+    Scene *scene1 = scene_init();
+    Scene *scene2 = scene_init();
+    for (int i = 0; i < SCENE_KEYS; i++) {
+        assert(scene_key_data(scene1)[i] == KEY_RELEASED);
+    }
+    // Scenes without handlers drop key events
+    scene_handle_key(scene1, 'a', KEY_PRESSED, 0);
+
+    KeyLog log1 = {0}, log2 = {0};
+    scene_set_key_handler(scene1, (KeyHandler) log_key, &log1);
+    scene_set_key_handler(scene2, (KeyHandler) log_key, &log2);
+    scene_handle_key(scene1, UP_ARROW, KEY_PRESSED, 0.5);
+    assert(log1.calls == 1 && log1.key == UP_ARROW && log1.type == KEY_PRESSED);
+    assert(log2.calls == 0);
+    scene_handle_key(scene2, ' ', KEY_RELEASED, 0);
+    assert(log2.calls == 1 && log2.key == ' ' && log2.type == KEY_RELEASED);
+    assert(log1.calls == 1);
+
+    scene_set_key_handler(scene1, NULL, NULL);
+    scene_handle_key(scene1, UP_ARROW, KEY_RELEASED, 0);
+    assert(log1.calls == 1);
+    scene_free(scene1);
+    scene_free(scene2);
+}
+
+// Tests that new scenes draw the same numbers, and seeding restarts them
+void test_scene_rng() {
+    Scene *scene1 = scene_init();
+    Scene *scene2 = scene_init();
+    uint64_t first = rng_next(scene_rng(scene1));
+    assert(rng_next(scene_rng(scene2)) == first);
+    assert(rng_next(scene_rng(scene1)) != first);
+
+    scene_seed(scene1, 5);
+    scene_seed(scene2, 5);
+    Rng rng;
+    rng_seed(&rng, 5);
+    uint64_t seeded = rng_next(&rng);
+    assert(rng_next(scene_rng(scene1)) == seeded);
+    assert(rng_next(scene_rng(scene2)) == seeded);
+    scene_free(scene1);
+    scene_free(scene2);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -246,6 +630,15 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_force_creator)
     DO_TEST(test_force_creator_aux)
     DO_TEST(test_reaping)
+    DO_TEST(test_removed_mid_tick)
+    DO_TEST(test_bulk_removal)
+    DO_TEST(test_handles)
+    DO_TEST(test_body_force_handlers)
+    DO_TEST(test_fixed_step)
+    DO_TEST(test_parallel_tick)
+    DO_TEST(test_parallel_for)
+    DO_TEST(test_key_handler)
+    DO_TEST(test_scene_rng)
 
     puts("scene_test PASS");
     return 0;
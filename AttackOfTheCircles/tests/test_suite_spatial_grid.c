@@ -0,0 +1,140 @@
+#include "scene.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+VectorList *make_square(double half_width) {
+    VectorList *shape = vec_list_init(4);
+    vec_list_add(shape, (Vector) {-half_width, -half_width});
+    vec_list_add(shape, (Vector) {+half_width, -half_width});
+    vec_list_add(shape, (Vector) {+half_width, +half_width});
+    vec_list_add(shape, (Vector) {-half_width, +half_width});
+    return shape;
+}
+
+Body *add_square(Scene *scene, double half_width, Vector centroid) {
+    Body *body = body_init(make_square(half_width), 1, (RGBColor) {0, 0, 0});
+    body_set_centroid(body, centroid);
+    scene_add_body(scene, body);
+    return body;
+}
+
+bool overlaps_box(Body *body, Vector min, Vector max) {
+    Vector center = body_get_centroid(body);
+    double radius = body_radius(body);
+    return center.x + radius >= min.x && center.x - radius <= max.x
+        && center.y + radius >= min.y && center.y - radius <= max.y;
+}
+
+// Checks that a query returned exactly the bodies matching a predicate, in scene order
+void assert_matches(Scene *scene, List *results, Vector min, Vector max) {
+    size_t found = 0;
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        Body *body = scene_get_body(scene, i);
+        if (!body_is_removed(body) && overlaps_box(body, min, max)) {
+            assert(found < list_size(results));
+            assert(list_get(results, found) == body);
+            found++;
+        }
+    }
+    assert(found == list_size(results));
+}
+
+// Tests that box queries find the same bodies as checking every body,
+// including bodies too big for the grid cells
+void test_query_aabb() {
+    Scene *scene = scene_init();
+    srand(7);
+    for (int i = 0; i < 300; i++) {
+        Vector centroid = {rand() % 4000 - 2000, rand() % 1000 - 500};
+        add_square(scene, 1 + rand() % 40, centroid);
+    }
+    add_square(scene, 5000, (Vector) {0, -5000});
+    for (int i = 0; i < 50; i++) {
+        Vector min = {rand() % 4000 - 2000, rand() % 1000 - 500};
+        Vector max = vec_add(min, (Vector) {rand() % 800, rand() % 800});
+        List *results = scene_query_aabb(scene, min, max);
+        assert_matches(scene, results, min, max);
+        list_free(results);
+    }
+    scene_free(scene);
+}
+
+// Tests that the index follows bodies as they move and are removed
+void test_query_after_tick() {
+    Scene *scene = scene_init();
+    Body *mover = add_square(scene, 1, (Vector) {0, 0});
+    Body *doomed = add_square(scene, 1, (Vector) {1000, 0});
+    body_set_velocity(mover, (Vector) {500, 0});
+    for (int i = 0; i < 20; i++) {
+        scene_tick(scene, 0.1);
+    }
+    assert(vec_isclose(body_get_centroid(mover), (Vector) {1000, 0}));
+
+    List *results = scene_query_radius(scene, (Vector) {0, 0}, 10);
+    assert(list_size(results) == 0);
+    list_free(results);
+    results = scene_query_radius(scene, (Vector) {1000, 5}, 10);
+    assert(list_size(results) == 2);
+    assert(list_get(results, 0) == mover);
+    assert(list_get(results, 1) == doomed);
+    list_free(results);
+
+    body_remove(doomed);
+    results = scene_query_radius(scene, (Vector) {1000, 5}, 10);
+    assert(list_size(results) == 1);
+    list_free(results);
+    scene_tick(scene, 0);
+    assert(scene_bodies(scene) == 1);
+    results = scene_query_aabb(scene, (Vector) {-5000, -5000}, (Vector) {5000, 5000});
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == mover);
+    list_free(results);
+    scene_free(scene);
+}
+
+// Tests that rays find the bodies they pass through, nearest first
+void test_query_ray() {
+    Scene *scene = scene_init();
+    Body *far = add_square(scene, 10, (Vector) {900, 0});
+    Body *near = add_square(scene, 10, (Vector) {300, 5});
+    add_square(scene, 10, (Vector) {600, 100});
+    add_square(scene, 10, (Vector) {-300, 0});
+    Body *floor = add_square(scene, 2000, (Vector) {0, -3500});
+
+    List *results = scene_query_ray(scene, VEC_ZERO, (Vector) {2, 0}, 1000);
+    assert(list_size(results) == 2);
+    assert(list_get(results, 0) == near);
+    assert(list_get(results, 1) == far);
+    list_free(results);
+
+    results = scene_query_ray(scene, VEC_ZERO, (Vector) {1, 0}, 500);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == near);
+    list_free(results);
+
+    results = scene_query_ray(scene, (Vector) {300, 500}, (Vector) {0, -1}, 10000);
+    assert(list_size(results) == 2);
+    assert(list_get(results, 0) == near);
+    assert(list_get(results, 1) == floor);
+    list_free(results);
+    scene_free(scene);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_query_aabb)
+    DO_TEST(test_query_after_tick)
+    DO_TEST(test_query_ray)
+
+    puts("spatial_grid_test PASS");
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include "vec_batch.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Sizes up to this cover empty arrays and every leftover after the SIMD loops
+const size_t MAX_BATCH = 17;
+
+double random_coordinate() {
+    return 200.0 * rand() / RAND_MAX - 100;
+}
+
+Vector *random_vectors(size_t n) {
+    Vector *vectors = malloc(sizeof(Vector) * (n + 1));
+    assert(vectors);
+    for (size_t i = 0; i < n; i++) {
+        vectors[i] = (Vector) {random_coordinate(), random_coordinate()};
+    }
+    return vectors;
+}
+
+Vector *copy_vectors(const Vector *vectors, size_t n) {
+    Vector *copy = malloc(sizeof(Vector) * (n + 1));
+    assert(copy);
+    memcpy(copy, vectors, sizeof(Vector) * n);
+    return copy;
+}
+
+bool vectors_equal(const Vector *vectors1, const Vector *vectors2, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (!vec_equal(vectors1[i], vectors2[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_instruction_set() {
+    const char *isa = vec_batch_instruction_set();
+    assert(strcmp(isa, "avx") == 0 || strcmp(isa, "sse2") == 0 || strcmp(isa, "scalar") == 0);
+    printf("vec_batch kernels use %s\n", isa);
+}
+
+// Tests that translating matches vec_add() exactly, in place or not
+void test_batch_translate() {
+    srand(1);
+    for (size_t n = 0; n <= MAX_BATCH; n++) {
+        Vector *in = random_vectors(n);
+        Vector translation = {random_coordinate(), random_coordinate()};
+        Vector *out = random_vectors(n);
+        Vector *scalar = random_vectors(n);
+        vec_batch_translate(out, in, n, translation);
+        vec_batch_translate_scalar(scalar, in, n, translation);
+        for (size_t i = 0; i < n; i++) {
+            assert(vec_equal(out[i], vec_add(in[i], translation)));
+        }
+        assert(vectors_equal(out, scalar, n));
+        vec_batch_translate(in, in, n, translation);
+        assert(vectors_equal(in, out, n));
+        free(in);
+        free(out);
+        free(scalar);
+    }
+}
+
+// Tests that rotating matches the scalar kernel exactly, and vec_rotate() closely
+void test_batch_rotate() {
+    srand(2);
+    for (size_t n = 0; n <= MAX_BATCH; n++) {
+        Vector *in = random_vectors(n);
+        double angle = 2 * M_PI * rand() / RAND_MAX;
+        Vector pivot = {random_coordinate(), random_coordinate()};
+        Vector offset = {random_coordinate(), random_coordinate()};
+        Vector *out = random_vectors(n);
+        Vector *scalar = random_vectors(n);
+        vec_batch_rotate(out, in, n, cos(angle), sin(angle), pivot, offset);
+        vec_batch_rotate_scalar(scalar, in, n, cos(angle), sin(angle), pivot, offset);
+        assert(vectors_equal(out, scalar, n));
+        for (size_t i = 0; i < n; i++) {
+            Vector expected = vec_add(vec_rotate(vec_subtract(in[i], pivot), angle), offset);
+            assert(vec_within(1e-9, out[i], expected));
+        }
+        vec_batch_rotate(in, in, n, cos(angle), sin(angle), pivot, offset);
+        assert(vectors_equal(in, out, n));
+        free(in);
+        free(out);
+        free(scalar);
+    }
+}
+
+// Tests that projecting finds the extremes of vec_dot() exactly
+void test_batch_project() {
+    srand(3);
+    for (size_t n = 0; n <= MAX_BATCH; n++) {
+        Vector *in = random_vectors(n);
+        Vector axis = {random_coordinate(), random_coordinate()};
+        double min, max, scalar_min, scalar_max;
+        vec_batch_project(in, n, axis, &min, &max);
+        vec_batch_project_scalar(in, n, axis, &scalar_min, &scalar_max);
+        assert(min == scalar_min && max == scalar_max);
+        double expected_min = INFINITY, expected_max = -INFINITY;
+        for (size_t i = 0; i < n; i++) {
+            expected_min = fmin(expected_min, vec_dot(in[i], axis));
+            expected_max = fmax(expected_max, vec_dot(in[i], axis));
+        }
+        assert(min == expected_min && max == expected_max);
+        free(in);
+    }
+}
+
+// Tests the shoelace sums against the scalar kernel, which may sum in another
+// order, and against a regular polygon's known area and centroid
+void test_batch_shoelace() {
+    srand(4);
+    for (size_t n = 0; n <= MAX_BATCH; n++) {
+        Vector *in = random_vectors(n);
+        Vector moment, scalar_moment;
+        double sum = vec_batch_shoelace(in, n, &moment);
+        double scalar_sum = vec_batch_shoelace_scalar(in, n, &scalar_moment);
+        double expected = 0;
+        for (size_t i = 0; i < n; i++) {
+            expected += vec_cross(in[i], in[(i + 1) % n]);
+        }
+        assert(within(1e-9, sum, scalar_sum));
+        assert(within(1e-9, sum, expected));
+        assert(vec_within(1e-6, moment, scalar_moment));
+        assert(vec_batch_shoelace(in, n, NULL) == sum);
+        free(in);
+    }
+
+    for (size_t n = 3; n <= MAX_BATCH; n++) {
+        Vector center = {random_coordinate(), random_coordinate()};
+        Vector *polygon = malloc(sizeof(Vector) * n);
+        for (size_t i = 0; i < n; i++) {
+            polygon[i] = vec_add(center, vec_rotate((Vector) {2, 0}, 2 * M_PI * i / n));
+        }
+        Vector moment;
+        double area = vec_batch_shoelace(polygon, n, &moment) / 2;
+        assert(isclose(area, n * 2 * sin(2 * M_PI / n)));
+        assert(vec_isclose(vec_multiply(1 / (6 * area), moment), center));
+        free(polygon);
+    }
+}
+
+typedef struct {
+    Vector *centroid;
+    Vector *velocity;
+    Vector *forces;
+    Vector *impulses;
+    double *mass;
+} Kinematics;
+
+Kinematics random_kinematics(size_t n) {
+    double *mass = malloc(sizeof(double) * (n + 1));
+    assert(mass);
+    for (size_t i = 0; i < n; i++) {
+        mass[i] = i % 5 == 4 ? INFINITY : 0.5 + rand() % 10;
+    }
+    return (Kinematics) {
+        random_vectors(n), random_vectors(n), random_vectors(n), random_vectors(n), mass
+    };
+}
+
+Kinematics copy_kinematics(Kinematics k, size_t n) {
+    double *mass = malloc(sizeof(double) * (n + 1));
+    assert(mass);
+    memcpy(mass, k.mass, sizeof(double) * n);
+    return (Kinematics) {
+        copy_vectors(k.centroid, n), copy_vectors(k.velocity, n),
+        copy_vectors(k.forces, n), copy_vectors(k.impulses, n), mass
+    };
+}
+
+bool kinematics_equal(Kinematics k1, Kinematics k2, size_t n) {
+    return vectors_equal(k1.centroid, k2.centroid, n)
+        && vectors_equal(k1.velocity, k2.velocity, n)
+        && vectors_equal(k1.forces, k2.forces, n)
+        && vectors_equal(k1.impulses, k2.impulses, n);
+}
+
+void free_kinematics(Kinematics k) {
+    free(k.centroid);
+    free(k.velocity);
+    free(k.forces);
+    free(k.impulses);
+    free(k.mass);
+}
+
+// Tests that both integrators match the scalar kernels and the vec_*()
+// formulas exactly, and clear the forces and impulses
+void test_batch_integrate() {
+    const double DT = 0.01;
+    srand(5);
+    for (size_t n = 0; n <= MAX_BATCH; n++) {
+        Kinematics batch = random_kinematics(n);
+        Kinematics scalar = copy_kinematics(batch, n);
+        Kinematics before = copy_kinematics(batch, n);
+        vec_batch_integrate_midpoint(batch.centroid, batch.velocity, batch.forces,
+            batch.impulses, batch.mass, n, DT);
+        vec_batch_integrate_midpoint_scalar(scalar.centroid, scalar.velocity, scalar.forces,
+            scalar.impulses, scalar.mass, n, DT);
+        assert(kinematics_equal(batch, scalar, n));
+        for (size_t i = 0; i < n; i++) {
+            Vector v = vec_add(vec_add(before.velocity[i],
+                vec_multiply(1 / before.mass[i], before.impulses[i])),
+                vec_multiply(DT / before.mass[i], before.forces[i]));
+            assert(vec_equal(batch.velocity[i], v));
+            assert(vec_equal(batch.centroid[i], vec_add(before.centroid[i],
+                vec_multiply(0.5 * DT, vec_add(before.velocity[i], v)))));
+            assert(vec_equal(batch.forces[i], VEC_ZERO));
+            assert(vec_equal(batch.impulses[i], VEC_ZERO));
+        }
+        free_kinematics(batch);
+        free_kinematics(scalar);
+        free_kinematics(before);
+
+        batch = random_kinematics(n);
+        scalar = copy_kinematics(batch, n);
+        before = copy_kinematics(batch, n);
+        vec_batch_integrate_euler(batch.centroid, batch.velocity, batch.forces,
+            batch.impulses, batch.mass, n, DT);
+        vec_batch_integrate_euler_scalar(scalar.centroid, scalar.velocity, scalar.forces,
+            scalar.impulses, scalar.mass, n, DT);
+        assert(kinematics_equal(batch, scalar, n));
+        for (size_t i = 0; i < n; i++) {
+            Vector v = vec_add(before.velocity[i], vec_multiply(1 / before.mass[i],
+                vec_add(before.impulses[i], vec_multiply(DT, before.forces[i]))));
+            assert(vec_equal(batch.velocity[i], v));
+            assert(vec_equal(batch.centroid[i],
+                vec_add(before.centroid[i], vec_multiply(DT, v))));
+        }
+        free_kinematics(batch);
+        free_kinematics(scalar);
+        free_kinematics(before);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_instruction_set)
+    DO_TEST(test_batch_translate)
+    DO_TEST(test_batch_rotate)
+    DO_TEST(test_batch_project)
+    DO_TEST(test_batch_shoelace)
+    DO_TEST(test_batch_integrate)
+
+    puts("vec_batch_test PASS");
+    return 0;
+}
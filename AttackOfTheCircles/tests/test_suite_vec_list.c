@@ -190,6 +190,23 @@ void test_empty_remove() {
     vec_list_free(l);
 }
 
+// Tests that a list grows past its initial size and that copies are independent
+void test_list_grow_copy() {
+    VectorList *l = vec_list_init(1);
+    for (size_t i = 0; i < 100; i++) {
+        vec_list_add(l, (Vector){i, -i});
+    }
+    assert(vec_list_size(l) == 100);
+    VectorList *copy = vec_list_copy(l);
+    vec_list_set(l, 0, (Vector){5, 5});
+    assert(vec_list_size(copy) == 100);
+    for (size_t i = 0; i < 100; i++) {
+        assert(vec_equal(copy->data[i], (Vector){i, -i}));
+    }
+    vec_list_free(l);
+    vec_list_free(copy);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -206,6 +223,7 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_list_large_add_remove)
     DO_TEST(test_out_of_bounds_access)
     DO_TEST(test_empty_remove)
+    DO_TEST(test_list_grow_copy)
 
     puts("list_test PASS");
     return 0;
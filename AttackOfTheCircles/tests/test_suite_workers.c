@@ -0,0 +1,103 @@
+#include "workers.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+typedef struct {
+    atomic_int *runs;
+    size_t threads;
+    // How many tasks each thread ran
+    atomic_int *per_worker;
+} Counter;
+
+void count_task(Counter *counter, size_t task, size_t worker) {
+    assert(worker < counter->threads);
+    atomic_fetch_add(&counter->runs[task], 1);
+    atomic_fetch_add(&counter->per_worker[worker], 1);
+}
+
+// Tests that each task runs exactly once, over many runs of the same pool
+void test_run_each_task_once() {
+    const size_t MAX_TASKS = 200;
+    for (size_t threads = 1; threads <= 6; threads++) {
+        WorkerPool *pool = worker_pool_init(threads);
+        assert(worker_pool_threads(pool) == threads);
+        Counter counter = {
+            calloc(MAX_TASKS, sizeof(atomic_int)), threads, calloc(threads, sizeof(atomic_int))
+        };
+        for (size_t tasks = 0; tasks <= MAX_TASKS; tasks += 7) {
+            for (size_t i = 0; i < MAX_TASKS; i++) {
+                atomic_store(&counter.runs[i], 0);
+            }
+            worker_pool_run(pool, (WorkerTask) count_task, &counter, tasks);
+            for (size_t i = 0; i < MAX_TASKS; i++) {
+                assert(atomic_load(&counter.runs[i]) == (i < tasks ? 1 : 0));
+            }
+        }
+        int total = 0;
+        for (size_t i = 0; i < threads; i++) {
+            total += atomic_load(&counter.per_worker[i]);
+        }
+        assert(total == (int) ((MAX_TASKS / 7 + 1) * (MAX_TASKS / 7) / 2 * 7));
+        free(counter.runs);
+        free(counter.per_worker);
+        worker_pool_free(pool);
+    }
+}
+
+void sum_task(double *sums, size_t task, size_t worker) {
+    double sum = 0;
+    for (size_t i = 0; i < 10000; i++) {
+        sum += (double) (task * i % 97);
+    }
+    sums[task] = sum;
+}
+
+// Tests that the tasks' writes are visible once worker_pool_run() returns
+void test_results_visible() {
+    const size_t TASKS = 64;
+    WorkerPool *pool = worker_pool_init(4);
+    double *sums = malloc(sizeof(double) * TASKS);
+    double *expected = malloc(sizeof(double) * TASKS);
+    for (size_t i = 0; i < TASKS; i++) {
+        sum_task(expected, i, 0);
+    }
+    for (int run = 0; run < 50; run++) {
+        for (size_t i = 0; i < TASKS; i++) {
+            sums[i] = -1;
+        }
+        worker_pool_run(pool, (WorkerTask) sum_task, sums, TASKS);
+        for (size_t i = 0; i < TASKS; i++) {
+            assert(sums[i] == expected[i]);
+        }
+    }
+    free(sums);
+    free(expected);
+    worker_pool_free(pool);
+}
+
+void init_zero_threads(void *aux) {
+    worker_pool_init(0);
+}
+
+void test_bad_threads() {
+    assert(test_assert_fail(init_zero_threads, NULL));
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_run_each_task_once)
+    DO_TEST(test_results_visible)
+    DO_TEST(test_bad_threads)
+
+    puts("workers_test PASS");
+    return 0;
+}